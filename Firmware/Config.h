@@ -60,7 +60,18 @@
 #define NVS_KEY_SSID              "wifi_ssid"
 #define NVS_KEY_PASSWORD          "wifi_pass"
 #define NVS_KEY_PROVISIONED       "provisioned"
-#define NVS_KEY_LED_EFFECT        "led_effect"
+#define NVS_KEY_LED_STATE         "led_state"    // Blob: effect, brightness, params (NVSManager::LedState)
+#define NVS_KEY_LED_EFFECT        "led_effect"   // Older firmware, migrated to led_state
+#define NVS_KEY_LED_BRIGHTNESS    "led_bright"   // Older firmware, migrated to led_state
+#define NVS_KEY_LED_PARAMS        "led_params"   // Older firmware (JSON object), migrated to led_state
+#define NVS_KEY_LED_COUNT         "led_count"
+#define NVS_KEY_LED_PIN           "led_pin"      // Single pin (older firmware)
+#define NVS_KEY_LED_PINS          "led_pins"     // Byte array, one entry per output
+#define NVS_KEY_LED_SEGMENTS      "led_segments" // JSON array, see LEDController::getSegmentsJson
+#define NVS_KEY_LED_LAYERS        "led_layers"   // JSON array, see LEDController::getLayersJson
+#define NVS_FLUSH_IDLE_MS         2000   // Write staged LED state once changes stop for this long
+#define NVS_FLUSH_MAX_MS          10000  // ...or at the latest this long after the first unwritten change
+#define NVS_PARAMS_MAX_BYTES      48     // Largest params struct led_state holds
 
 // ----------------------------------------------------------------------------
 // GPIO Pin Configuration
@@ -71,8 +82,34 @@
 
 // Future ARGB LED pins
 #define ARGB_DATA_PIN             44     // GPIO44 = D7 on XIAO ESP32S3
-#define ARGB_NUM_LEDS             75     // 75 ARGB LEDs on the chain
+#ifndef ARGB_NUM_LEDS
+#define ARGB_NUM_LEDS             75     // Default chain length until set via /api/led/config (override with -DARGB_NUM_LEDS)
+#endif
+#define LED_MAX_LEDS              4096   // Upper bound accepted for the stored chain length
+#define LED_DATA_PINS             {1, 2, 3, 4, 5, 6, 7, 8, 43, 44}  // XIAO D0-D9 (D10 = GPIO9 is the reset button)
+#define LED_MAX_OUTPUTS           4      // Parallel data lines (ESP32-S3 has 4 RMT TX channels)
+#define LED_MAX_SEGMENTS          8      // Independent effect slices of the strip
+#define LED_MAX_LAYERS            3      // Effects blended over the base (each costs a frame buffer)
+#define LED_TRANSITION_MS         500    // Default effect switch duration (0 = cut)
+#define LED_TRANSITION_MAX_MS     10000
+#define LED_STATIC_REFRESH_MS     1000   // Re-send an unchanged static frame this often
 #define LED_TARGET_FPS            60     // Target frame rate for animations
+#define LED_MIN_FPS               30     // Default lowest useful rate of an effect
+#define LED_MAX_FPS               120    // Governor ceiling
+#define LED_FPS_LOAD_PCT          75     // Share of the frame period render/show may use
+#define LED_FRAME_MICROS          (1000UL * (1000 / LED_TARGET_FPS))  // Nominal frame period (whole ms, as ledTask)
+
+// ----------------------------------------------------------------------------
+// Realtime Input (UDP pixel streams from sequencers)
+// ----------------------------------------------------------------------------
+#define REALTIME_DDP_PORT         4048
+#define REALTIME_E131_PORT        5568   // Unicast only (no multicast join)
+#define REALTIME_ARTNET_PORT      6454
+#define REALTIME_E131_UNIVERSE    1      // E1.31 universe holding pixel 0
+#define REALTIME_ARTNET_UNIVERSE  0      // Art-Net port-address holding pixel 0
+#define REALTIME_UNIVERSE_CHANNELS 510   // 170 RGB pixels per universe (xLights default)
+#define REALTIME_MAX_PACKET       1500
+#define LED_REALTIME_TIMEOUT_MS   2500   // Back to the effect after this long without a frame
 
 // ----------------------------------------------------------------------------
 // Development Mode
@@ -90,6 +127,10 @@
 #define TASK_PRIORITY_LOGGER      0
 #define TASK_STACK_SIZE_LED       8192
 #define TASK_PRIORITY_LED         3      // Higher than WiFi/BLE for smooth animations
+#define TASK_STACK_SIZE_LED_OUT   2048
+#define TASK_PRIORITY_LED_OUT     4      // Starts a handed-over frame ahead of the next render
+#define TASK_STACK_SIZE_REALTIME  4096
+#define TASK_PRIORITY_REALTIME    3      // Same as the render task it stands in for
 
 // ----------------------------------------------------------------------------
 // Logging Configuration
@@ -115,6 +156,10 @@
 // ----------------------------------------------------------------------------
 #define HTTP_SERVER_PORT          80     // HTTP server port for AP mode
 #define HTTP_CORS_ORIGIN          "*"    // CORS allow origin (all for now)
+#define WS_MAX_CLIENTS            4      // Open /api/led/ws control connections
+#define WS_MAX_MESSAGE            512    // Largest control message / state push (bytes)
+#define SSE_MIN_INTERVAL_MS       250    // /api/led/events: at most 4 state events per second
+#define SSE_MAX_EVENT             768    // Largest state event (bytes)
 
 // ----------------------------------------------------------------------------
 // Utility Macros
@@ -7,27 +7,221 @@
 #ifndef EFFECT_DEFS_H
 #define EFFECT_DEFS_H
 
+#include <new>
 #include <FastLED.h>
 #include "Config.h"
 #include "EffectParams.h"
 #include "Palettes.h"
 
-// Define NUM_LEDS for compatibility with Effects.h 
-// (Effects.h uses NUM_LEDS, Config.h uses ARGB_NUM_LEDS)
+// Length of the span the running effect draws into (see setRenderSpan)
 #ifndef NUM_LEDS
-#define NUM_LEDS ARGB_NUM_LEDS
+#define NUM_LEDS spanLength
 #endif
 
 // ============================================================================
 // Global LED Array
 // ============================================================================
+// frameLeds is the whole render buffer. Effects draw through leds/NUM_LEDS,
+// which cover the whole strip except while a segment renders into its slice
+// or a layer into its own buffer.
+
+uint16_t ledCount = ARGB_NUM_LEDS;  // Chain length, set once at boot from NVS
+CRGB* frameLeds = NULL;             // Allocated by LEDController::begin()
+CRGB* leds = NULL;
+uint16_t spanLength = ARGB_NUM_LEDS;
+
+inline void setRenderSpan(uint16_t start, uint16_t length) {
+    leds = frameLeds + start;
+    spanLength = length;
+}
+
+inline void setRenderSpan(CRGB* target, uint16_t length) {
+    leds = target;
+    spanLength = length;
+}
+
+inline void resetRenderSpan() {
+    leds = frameLeds;
+    spanLength = ledCount;
+}
+
+// ============================================================================
+// Per-Pixel Buffers
+// ============================================================================
+// Controller buffers are sized to ledCount when first needed and kept for the
+// rest of the run (the count only changes across a reboot); effect buffers
+// are sized to the span their instance runs on and freed with it. Large
+// effect state goes to PSRAM when the board has it; the render and output
+// buffers ask for internal RAM.
+
+#define PIXEL_BUFFER_PSRAM_MIN    4096   // Bytes; smaller buffers stay internal
+
+template <typename T>
+inline T* allocPixelBuffer(bool internal = false, uint16_t count = ledCount) {
+    void* p = NULL;
+    if (!internal && sizeof(T) * count >= PIXEL_BUFFER_PSRAM_MIN && psramFound()) {
+        p = heap_caps_calloc(count, sizeof(T), MALLOC_CAP_SPIRAM);
+    }
+    if (p == NULL) {
+        p = heap_caps_calloc(count, sizeof(T), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (p == NULL && internal) {
+        p = heap_caps_calloc(count, sizeof(T), MALLOC_CAP_8BIT);  // Any RAM beats none
+    }
+    return (T*)p;
+}
+
+// One T per pixel of the current render span, for effect state
+template <typename T>
+inline T* allocEffectBuffer() {
+    return allocPixelBuffer<T>(false, spanLength);
+}
 
-CRGB leds[ARGB_NUM_LEDS];
+inline void freePixelBuffer(void* p) {
+    if (p != NULL) heap_caps_free(p);
+}
+
+// ============================================================================
+// Animation Timebase
+// ============================================================================
+// Effect speeds are tuned per nominal frame (LED_FRAME_MICROS). LEDController
+// loads the rendering instance's clock into effectTime and stamps it before
+// each render; effects scale per-frame steps, fades and millis() intervals
+// against it so a speed value looks the same at any FPS.
+
+#define EFFECT_MAX_DELTA_MICROS   100000UL   // Longer stalls don't jump the animation
+#define EFFECT_MAX_CATCHUP_MICROS 1000000UL  // Interval effects restart after this
+
+struct EffectTime {
+    uint32_t nowMicros;     // Timestamp of the frame being rendered
+    uint32_t deltaMicros;   // Time since the previous frame (capped, 0 on an effect's first frame)
+    uint32_t frame;         // Frames rendered since the last effect change
+};
+
+EffectTime effectTime = { 0, LED_FRAME_MICROS, 0 };
+
+// Called once per frame, before the effect renders
+inline void tickEffectTime() {
+    uint32_t now = micros();
+    if (effectTime.frame == 0) {
+        effectTime.deltaMicros = 0;
+    } else {
+        effectTime.deltaMicros = min(now - effectTime.nowMicros, (uint32_t)EFFECT_MAX_DELTA_MICROS);
+    }
+    effectTime.nowMicros = now;
+    effectTime.frame++;
+}
+
+// This frame's length in nominal frames (1.0 at LED_TARGET_FPS)
+inline float frameScale() {
+    return (float)effectTime.deltaMicros / LED_FRAME_MICROS;
+}
+
+// A per-frame step scaled to this frame; `carry` keeps the remainder so slow
+// speeds still advance at high FPS
+inline uint32_t frameStep(uint32_t perFrame, uint32_t& carry) {
+    uint32_t acc = perFrame * effectTime.deltaMicros + carry;
+    carry = acc % LED_FRAME_MICROS;
+    return acc / LED_FRAME_MICROS;
+}
+
+// Simulation ticks due this frame for effects that step once per nominal frame;
+// the first frame after an effect change always runs one
+inline uint32_t frameTicks(uint32_t& carry) {
+    if (effectTime.frame == 1) {
+        carry = 0;
+        return 1;
+    }
+    return frameStep(1, carry);
+}
+
+// Fade amount (fadeAll / nscale8(255 - x) / blend towards x) giving the same
+// decay over this frame as `amount` per nominal frame
+inline uint8_t frameFade(uint8_t amount) {
+    if (effectTime.deltaMicros == LED_FRAME_MICROS || amount == 0 || amount == 255) return amount;
+    if (effectTime.frame == 1) return amount;   // First frame counts as one, as frameTicks()
+    float keep = powf((255 - amount) / 255.0f, frameScale());
+    return 255 - (uint8_t)(keep * 255.0f + 0.5f);
+}
+
+// Steps due for a fixed-interval animation since `lastMicros`. These effects used
+// to step on the first frame after intervalMs, so the period speeds were tuned
+// against is intervalMs rounded up to the next whole nominal frame; keep it.
+inline uint16_t intervalSteps(uint32_t& lastMicros, uint32_t intervalMs) {
+    uint32_t period = (intervalMs * 1000 / LED_FRAME_MICROS + 1) * LED_FRAME_MICROS;
+    uint32_t elapsed = effectTime.nowMicros - lastMicros;
+    if (elapsed < period) return 0;
+    if (elapsed > EFFECT_MAX_CATCHUP_MICROS) {
+        lastMicros = effectTime.nowMicros;
+        return 1;
+    }
+    uint16_t steps = elapsed / period;
+    lastMicros += steps * period;
+    return steps;
+}
+
+// ============================================================================
+// Effect Scheduling
+// ============================================================================
+// Effects never wait or call show(). Each returns how long its frame stays
+// valid and LEDController calls it again once that time has passed; frames
+// in between reuse the pixels it left in its buffer.
+
+#define EFFECT_NEXT_FRAME   0UL             // Animating: render every frame
+#define EFFECT_NO_CHANGE    0xFFFFFFFFUL    // Static: render again only when params change
+
+// Wake time for an effect that holds its frame for `ms`
+inline uint32_t effectWakeIn(uint32_t ms) {
+    return ms * 1000UL;
+}
+
+// ============================================================================
+// Effect Instances
+// ============================================================================
+// An effect keeps everything it remembers between frames in a state struct
+// of its own (default member initializers give its t=0 state). LEDController
+// allocates one per running instance, so the base, every segment and layer
+// and a transition's outgoing effect can run the same effect side by side,
+// and frees it when the instance stops. Effects without state take
+// NoEffectState and cost no allocation.
+
+struct NoEffectState {};
+
+// Type-erased init/render/teardown for an effect function and its state
+template <typename State, uint32_t (*Render)(State&)>
+struct EffectType {
+    static const uint16_t stateSize = sizeof(State);
+    static void init(void* state) { new (state) State(); }
+    static uint32_t render(void* state) { return Render(*(State*)state); }
+    static void teardown(void* state) { ((State*)state)->~State(); }
+};
+
+template <uint32_t (*Render)(NoEffectState&)>
+struct EffectType<NoEffectState, Render> {
+    static const uint16_t stateSize = 0;
+    static void init(void*) {}
+    static uint32_t render(void*) {
+        NoEffectState none;
+        return Render(none);
+    }
+    static void teardown(void*) {}
+};
+
+// Registry fields (stateSize, init, render, teardown) of an effect function
+#define EFFECT_TYPE(func, State) \
+    EffectType<State, func>::stateSize, EffectType<State, func>::init, \
+    EffectType<State, func>::render, EffectType<State, func>::teardown
 
 // ============================================================================
 // Helper Functions (used by Effects.h)
 // ============================================================================
 
+// Clear the render buffer. FastLED.clear() would wipe the output buffer
+// instead, which may be on the wire (see LEDController::presentFrame)
+inline void clearLeds() {
+    fill_solid(leds, NUM_LEDS, CRGB::Black);
+}
+
 // Fade all LEDs by a given amount
 inline void fadeAll(uint8_t amount) {
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
@@ -35,10 +229,9 @@ inline void fadeAll(uint8_t amount) {
     }
 }
 
-// Get color from palette
+// Get color from palette (cached lookup table, see Palettes.h)
 inline CRGB getColorFromPalette(PaletteType paletteType, uint8_t index, uint8_t brightness = 255) {
-    CRGBPalette16 palette = getPalette(paletteType);
-    return ColorFromPalette(palette, index, brightness, LINEARBLEND);
+    return paletteLookup(getPaletteLUT(paletteType), index, brightness);
 }
 
 // ============================================================================
@@ -85,7 +278,7 @@ ScannerParams scannerParams = {
     .colors = {CRGB::Red, CRGB::Blue, CRGB::Green, CRGB::Yellow, 
                CRGB::Cyan, CRGB::Magenta, CRGB::Orange, CRGB::Purple},
     .speed = 80, .numDots = 1, .trailLength = 15,
-    .dualMode = false, .overlay = false
+    .dualMode = false
 };
 
 CometParams cometParams = { 
@@ -105,9 +298,9 @@ TwinkleParams twinkleParams = { .twinkleColor = CRGB::White, .palette = PALETTE_
 
 TwinkleFoxParams twinkleFoxParams = { .palette = PALETTE_SNOW, .speed = 100, .twinkleRate = 100, .fadeOut = 200 };
 
-SparkleParams sparkleParams = { .colorSpark = CRGB::White, .colorBg = CRGB::Blue, .speed = 180, .intensity = 50, .overlay = true, .darkMode = false };
+SparkleParams sparkleParams = { .colorSpark = CRGB::White, .colorBg = CRGB::Blue, .speed = 180, .intensity = 50, .darkMode = false };
 
-GlitterParams glitterParams = { .intensity = 80, .rainbowBg = true, .bgColor = CRGB::Black, .overlay = true };
+GlitterParams glitterParams = { .intensity = 80, .rainbowBg = true, .bgColor = CRGB::Black };
 
 StarryNightParams starryNightParams = { .speed = 100, .density = 60, .colorStars = CRGB::White, .shootingStars = true };
 
@@ -131,22 +324,22 @@ FairyParams fairyParams = { .speed = 150, .numFlashers = 15, .colorMode = FAIRY_
 
 ChristmasChaseParams christmasChaseParams = { .speed = 100, .color1 = CRGB::Red, .color2 = CRGB::Green, .pattern = XMAS_CHASE };
 
-HalloweenEyesParams halloweenEyesParams = { .duration = 2000, .fadeTime = 500, .color = CRGB::Red, .overlay = false };
+HalloweenEyesParams halloweenEyesParams = { .duration = 2000, .fadeTime = 500, .color = CRGB::Red };
 
-FireworksParams fireworksParams = { .chance = 80, .fragments = 8, .gravity = 128, .overlay = false };
+FireworksParams fireworksParams = { .chance = 80, .fragments = 8, .gravity = 128 };
 
 SnowSparkleParams snowSparkleParams = { .speed = 150, .density = 40, .color = CRGB::White, .direction = DIR_FORWARD };
 
 // Category 7: Special
-BouncingBallsParams bouncingBallsParams = { .gravity = 200, .numBalls = 3, .overlay = false, .trail = 5, .palette = PALETTE_RAINBOW };
+BouncingBallsParams bouncingBallsParams = { .gravity = 200, .numBalls = 3, .trail = 5, .palette = PALETTE_RAINBOW };
 
 PopcornParams popcornParams = { .speed = 150, .intensity = 100, .palette = PALETTE_PARTY };
 
-DripParams dripParams = { .gravity = 180, .numDrips = 4, .overlay = false, .color = CRGB::Aqua };
+DripParams dripParams = { .gravity = 180, .numDrips = 4, .color = CRGB::Aqua };
 
 PlasmaParams plasmaParams = { .phase = 0, .intensity = 200, .speed = 80 };
 
-LightningParams lightningParams = { .frequency = 50, .intensity = 255, .color = CRGB::White, .overlay = false };
+LightningParams lightningParams = { .frequency = 50, .intensity = 255, .color = CRGB::White };
 
 MatrixParams matrixParams = { .speed = 150, .spawningRate = 80, .trailLength = 10, .color = CRGB::Green };
 
@@ -174,7 +367,7 @@ uint16_t mapLed(uint16_t pos, Direction dir) {
         case DIR_REVERSE: // Reverse/Left
         case DIR_DOWN:    // Down (same as reverse for 1D strip)
         case DIR_CCW:     // Counter-clockwise (same as reverse)
-            return ARGB_NUM_LEDS - 1 - pos;
+            return NUM_LEDS - 1 - pos;
         
         case DIR_FORWARD: // Forward/Right (default)
         case DIR_UP:      // Up (same as forward for 1D strip)
@@ -186,21 +379,21 @@ uint16_t mapLed(uint16_t pos, Direction dir) {
 
 // Safe LED set with bounds checking
 void setLedSafe(uint16_t pos, CRGB color) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] = color;
     }
 }
 
 // Add color (blend)
 void addLedSafe(uint16_t pos, CRGB color) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] += color;
     }
 }
 
 // Blend with fade
 void blendLedSafe(uint16_t pos, CRGB color, uint8_t amount) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] = blend(leds[pos], color, amount);
     }
 }
@@ -167,7 +167,6 @@ struct ScannerParams {
     uint8_t numDots;            // Number of dots (1-8)
     uint8_t trailLength;        // Trail length (1-50)
     bool dualMode;              // Scanning from both sides
-    bool overlay;               // Overlay on background
 };
 
 struct CometParams {
@@ -218,7 +217,6 @@ struct SparkleParams {
     CRGB colorBg;
     uint8_t speed;
     uint8_t intensity;          // Number of sparkles (0-255)
-    bool overlay;               // Overlay on base effect
     bool darkMode;              // Dark sparkles instead of bright
 };
 
@@ -226,7 +224,6 @@ struct GlitterParams {
     uint8_t intensity;          // Number of glitters (0-255)
     bool rainbowBg;             // Rainbow background
     CRGB bgColor;               // Or solid background color
-    bool overlay;
 };
 
 struct StarryNightParams {
@@ -301,14 +298,12 @@ struct HalloweenEyesParams {
     uint16_t duration;          // Glow duration (ms)
     uint16_t fadeTime;          // Fade time (ms)
     CRGB color;
-    bool overlay;
 };
 
 struct FireworksParams {
     uint8_t chance;             // Explosion frequency (0-255)
     uint8_t fragments;          // Number of fragments (4-16)
     uint8_t gravity;            // Gravity strength (0-255)
-    bool overlay;
 };
 
 struct SnowSparkleParams {
@@ -323,7 +318,6 @@ struct SnowSparkleParams {
 struct BouncingBallsParams {
     uint8_t gravity;            // Gravity strength (100-255)
     uint8_t numBalls;           // Number of balls (1-8)
-    bool overlay;
     uint8_t trail;              // Trail length (0-20)
     PaletteType palette;
 };
@@ -337,7 +331,6 @@ struct PopcornParams {
 struct DripParams {
     uint8_t gravity;            // Gravity strength (100-255)
     uint8_t numDrips;           // Number of drips (1-8)
-    bool overlay;
     CRGB color;
 };
 
@@ -351,7 +344,6 @@ struct LightningParams {
     uint8_t frequency;          // Flash frequency (0-255)
     uint8_t intensity;          // Flash brightness (0-255)
     CRGB color;
-    bool overlay;
 };
 
 struct MatrixParams {
@@ -459,7 +451,8 @@ extern PoliceLightsParams policeLightsParams;
 extern StrobeParams strobeParams;
 
 // Global variables accessible to effects
-extern CRGB leds[];
+extern CRGB* leds;
+extern uint16_t spanLength;
 extern uint32_t frameCounter;
 extern uint32_t lastFrameTime;
 
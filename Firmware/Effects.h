@@ -9,52 +9,10 @@
 #include "EffectParams.h"
 #include "Palettes.h"
 
-// Configuration constants
-#define NUM_LEDS 75
-
-// Forward declarations
-void effectSolid();
-void effectGradient();
-void effectSpots();
-void effectPattern();
-void effectRainbowWave();
-void effectColorWave();
-void effectOscillate();
-void effectWavy();
-void effectTheaterChase();
-void effectScanner();
-void effectComet();
-void effectRunningLights();
-void effectAndroid();
-void effectTwinkle();
-void effectTwinkleFox();
-void effectSparkle();
-void effectGlitter();
-void effectStarryNight();
-void effectFire();
-void effectCandle();
-void effectFireFlicker();
-void effectLava();
-void effectAurora();
-void effectPacifica();
-void effectLake();
-void effectFairy();
-void effectChristmasChase();
-void effectHalloweenEyes();
-void effectFireworks();
-void effectSnowSparkle();
-void effectBouncingBalls();
-void effectPopcorn();
-void effectDrip();
-void effectPlasma();
-void effectLightning();
-void effectMatrix();
-void effectHeartbeat();
-void effectBreathe();
-void effectDissolve();
-void effectFade();
-void effectPolice();
-void effectStrobe();
+// Configuration constants (EffectDefs.h maps NUM_LEDS to the current render span)
+#ifndef NUM_LEDS
+#define NUM_LEDS spanLength
+#endif
 
 // Helper functions
 uint16_t mapLed(uint16_t pos, Direction dir);
@@ -68,23 +26,25 @@ CRGB getColorFromPalette(PaletteType paletteType, uint8_t index, uint8_t brightn
 // CATEGORY 1: STATIC EFFECTS
 // ============================================================================
 
-void effectSolid() {
+uint32_t effectSolid(NoEffectState&) {
     // Simplest effect - solid color
     CRGB col = solidParams.color;
     col.nscale8(solidParams.brightness);
     fill_solid(leds, NUM_LEDS, col);
+    
+    return EFFECT_NO_CHANGE;
 }
 
-void effectGradient() {
+uint32_t effectGradient(NoEffectState&) {
     // Apply style-specific gradient
     if (gradientParams.style == GRADIENT_MIRROR) {
         // MIRROR: symmetric gradient
-        uint8_t half = NUM_LEDS / 2;
+        uint16_t half = NUM_LEDS / 2;
         
         if (gradientParams.threePoint) {
             // 3-point mirror: create full gradient on first half, then mirror
             // First quarter: colorStart -> colorMiddle
-            uint8_t quarter = half / 2;
+            uint16_t quarter = half / 2;
             if (quarter > 0) {
                 fill_gradient_RGB(leds, 0, gradientParams.colorStart, 
                                  quarter, gradientParams.colorMiddle);
@@ -109,7 +69,7 @@ void effectGradient() {
         // SCATTERED: random-looking gradient with color clusters
         if (gradientParams.threePoint) {
             // Divide strip into random segments with different colors
-            uint8_t third = NUM_LEDS / 3;
+            uint16_t third = NUM_LEDS / 3;
             
             // Create 3 sections with smooth transitions
             fill_gradient_RGB(leds, 0, gradientParams.colorStart,
@@ -120,7 +80,7 @@ void effectGradient() {
                              NUM_LEDS - 1, gradientParams.colorEnd);
         } else {
             // 2-point: alternate gradient with middle mix
-            uint8_t third = NUM_LEDS / 3;
+            uint16_t third = NUM_LEDS / 3;
             CRGB mixColor = blend(gradientParams.colorStart, gradientParams.colorEnd, 128);
             
             fill_gradient_RGB(leds, 0, gradientParams.colorEnd, third, mixColor);
@@ -131,7 +91,7 @@ void effectGradient() {
     else {
         // LINEAR (default): normal gradient
         if (gradientParams.threePoint) {
-            uint8_t midPoint = NUM_LEDS / 2;
+            uint16_t midPoint = NUM_LEDS / 2;
             // colorStart -> colorMiddle -> colorEnd
             if (midPoint > 0) {
                 fill_gradient_RGB(leds, 0, gradientParams.colorStart, 
@@ -146,10 +106,12 @@ void effectGradient() {
             fill_gradient_RGB(leds, NUM_LEDS, gradientParams.colorStart, gradientParams.colorEnd);
         }
     }
+    
+    return EFFECT_NO_CHANGE;
 }
 
-void effectSpots() {
-    FastLED.clear();
+uint32_t effectSpots(NoEffectState&) {
+    clearLeds();
     
     for (uint16_t i = 0; i < NUM_LEDS; i += spotsParams.spread) {
         for (uint8_t w = 0; w < spotsParams.width && (i + w) < NUM_LEDS; w++) {
@@ -176,9 +138,11 @@ void effectSpots() {
             }
         }
     }
+    
+    return EFFECT_NO_CHANGE;
 }
 
-void effectPattern() {
+uint32_t effectPattern(NoEffectState&) {
     uint8_t patternLen = patternParams.fgSize + patternParams.bgSize;
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
@@ -189,36 +153,53 @@ void effectPattern() {
             leds[i] = patternParams.colorBg;
         }
     }
+    
+    return EFFECT_NO_CHANGE;
 }
 
 // ============================================================================
 // CATEGORY 2: WAVE EFFECTS
 // ============================================================================
 
-void effectRainbowWave() {
-    static uint16_t hueOffset = 0;
+struct RainbowWaveState {
+    uint16_t hueOffset = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectRainbowWave(RainbowWaveState& st) {
+    st.hueOffset += frameStep(map(rainbowWaveParams.speed, 0, 255, 1, 10), st.carry);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         uint16_t pos = mapLed(i, rainbowWaveParams.direction);
-        uint8_t hue = (pos * 256 / rainbowWaveParams.size + hueOffset) & 0xFF;
+        uint8_t hue = (pos * 256 / rainbowWaveParams.size + st.hueOffset) & 0xFF;
         leds[i] = CHSV(hue, rainbowWaveParams.saturation, 255);
     }
     
-    hueOffset += map(rainbowWaveParams.speed, 0, 255, 1, 10);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectColorWave() {
-    static float offset = 0;
-    
+struct ColorWaveState {
+    float offset = 0;
+};
+
+uint32_t effectColorWave(ColorWaveState& st) {
     // Prevent division by zero
-    if (colorWaveParams.numColors == 0) return;
+    if (colorWaveParams.numColors == 0) return EFFECT_NEXT_FRAME;
     
     uint16_t segmentLen = NUM_LEDS / colorWaveParams.numColors;
     if (segmentLen == 0) segmentLen = 1; // Safety check
     
+    // Normalize speed: higher numColors = smaller segments, so scale offset increment
+    // This keeps visual wave speed constant regardless of number of colors
+    float speedFactor = map(colorWaveParams.speed, 0, 255, 10, 100) / 100.0;
+    float normalizedIncrement = speedFactor * (float)segmentLen / 10.0;
+    
+    st.offset += normalizedIncrement * frameScale();
+    while (st.offset >= NUM_LEDS) st.offset -= NUM_LEDS;
+    
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         uint16_t pos = mapLed(i, colorWaveParams.direction);
-        uint16_t adjustedPos = ((uint16_t)(pos + offset)) % NUM_LEDS;
+        uint16_t adjustedPos = ((uint16_t)(pos + st.offset)) % NUM_LEDS;
         
         uint8_t colorIdx = adjustedPos / segmentLen;
         uint8_t nextColorIdx = (colorIdx + 1) % colorWaveParams.numColors;
@@ -238,44 +219,40 @@ void effectColorWave() {
         }
     }
     
-    // Normalize speed: higher numColors = smaller segments, so scale offset increment
-    // This keeps visual wave speed constant regardless of number of colors
-    float speedFactor = map(colorWaveParams.speed, 0, 255, 10, 100) / 100.0;
-    float normalizedIncrement = speedFactor * (float)segmentLen / 10.0;
-    
-    offset += normalizedIncrement;
-    if (offset >= NUM_LEDS) offset -= NUM_LEDS;
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectOscillate() {
-    static int16_t position = 0;
-    static int8_t direction = 1;
-    static uint32_t lastMove = 0;
-    
+struct OscillateState {
+    int16_t position = 0;
+    int8_t direction = 1;
+    uint32_t lastMove = 0;
+};
+
+uint32_t effectOscillate(OscillateState& st) {
     uint16_t delayMs = map(oscillateParams.speed, 0, 255, 80, 5);
     
-    if (millis() - lastMove > delayMs) {
-        position += direction;
-        if (position >= NUM_LEDS - 1 || position <= 0) {
-            direction = -direction;
+    for (uint16_t s = intervalSteps(st.lastMove, delayMs); s > 0; s--) {
+        st.position += st.direction;
+        if (st.position >= NUM_LEDS - 1 || st.position <= 0) {
+            st.direction = -st.direction;
         }
-        lastMove = millis();
     }
     
     // Fade trail effect - softer fade for brightness
+    uint8_t keep = 255 - frameFade(255 - 220); // 86% brightness retention, gentler fade
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        leds[i].nscale8(220); // 86% brightness retention, gentler fade
+        leds[i].nscale8(keep);
     }
     
     // Color based on position: left side = colorPrimary, right side = colorSecondary
     CRGB pointColor;
-    if (position < NUM_LEDS / 2) {
+    if (st.position < NUM_LEDS / 2) {
         // Left half - mostly colorPrimary
-        uint8_t blendAmt = map(position, 0, NUM_LEDS / 2, 0, 128);
+        uint8_t blendAmt = map(st.position, 0, NUM_LEDS / 2, 0, 128);
         pointColor = blend(oscillateParams.colorPrimary, oscillateParams.colorSecondary, blendAmt);
     } else {
         // Right half - mostly colorSecondary
-        uint8_t blendAmt = map(position, NUM_LEDS / 2, NUM_LEDS - 1, 128, 255);
+        uint8_t blendAmt = map(st.position, NUM_LEDS / 2, NUM_LEDS - 1, 128, 255);
         pointColor = blend(oscillateParams.colorPrimary, oscillateParams.colorSecondary, blendAmt);
     }
     
@@ -285,7 +262,7 @@ void effectOscillate() {
     if (size > 20) size = 20;
     
     for (int8_t offset = -size; offset <= size; offset++) {
-        int16_t ledPos = position + offset;
+        int16_t ledPos = st.position + offset;
         if (ledPos >= 0 && ledPos < NUM_LEDS) {
             uint8_t brightness = map(abs(offset), 0, size, 255, 0);
             CRGB col = pointColor;
@@ -293,148 +270,163 @@ void effectOscillate() {
             leds[ledPos] = col;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectWavy() {
-    static uint16_t phase = 0;
-    CRGBPalette16 pal = getPalette(wavyParams.palette);
+struct WavyState {
+    uint16_t phase = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectWavy(WavyState& st) {
+    st.phase += frameStep(map(wavyParams.speed, 0, 255, 1, 8), st.carry);
+    
+    const CRGB* pal = getPaletteLUT(wavyParams.palette);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         // Sinusoid with multiple waves
-        uint8_t sinVal = sin8(i * wavyParams.frequency * 256 / NUM_LEDS + phase);
+        uint8_t sinVal = sin8(i * wavyParams.frequency * 256 / NUM_LEDS + st.phase);
         uint8_t brightness = scale8(sinVal, wavyParams.amplitude);
         
-        uint8_t colorIndex = i * 256 / NUM_LEDS + phase / 2;
-        leds[i] = ColorFromPalette(pal, colorIndex, brightness + (255 - wavyParams.amplitude), LINEARBLEND);
+        uint8_t colorIndex = i * 256 / NUM_LEDS + st.phase / 2;
+        leds[i] = paletteLookup(pal, colorIndex, brightness + (255 - wavyParams.amplitude));
     }
     
-    phase += map(wavyParams.speed, 0, 255, 1, 8);
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 3: CHASE/RUNNING EFFECTS
 // ============================================================================
 
-void effectTheaterChase() {
-    static uint8_t step = 0;
-    static uint32_t lastStep = 0;
-    static uint8_t hue = 0;
-    
+struct TheaterChaseState {
+    uint8_t step = 0;
+    uint32_t lastStep = 0;
+    uint8_t hue = 0;
+};
+
+uint32_t effectTheaterChase(TheaterChaseState& st) {
     uint16_t delayMs = map(theaterChaseParams.speed, 0, 255, 150, 20);
     
-    if (millis() - lastStep > delayMs) {
-        step = (step + 1) % (theaterChaseParams.gapSize + 1);
+    for (uint16_t s = intervalSteps(st.lastStep, delayMs); s > 0; s--) {
+        st.step = (st.step + 1) % (theaterChaseParams.gapSize + 1);
         if (theaterChaseParams.rainbowMode) {
-            hue += 2;
+            st.hue += 2;
         }
-        lastStep = millis();
     }
     
-    FastLED.clear();
+    clearLeds();
     
+    const CRGB* rainbow = getRainbowLUT();
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if ((i + step) % (theaterChaseParams.gapSize + 1) == 0) {
+        if ((i + st.step) % (theaterChaseParams.gapSize + 1) == 0) {
             if (theaterChaseParams.rainbowMode) {
-                leds[i] = CHSV(hue + i * 2, 255, 255);
+                leds[i] = rainbow[(uint8_t)(st.hue + i * 2)];
             } else {
                 leds[i] = theaterChaseParams.color;
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectScanner() {
-    static int16_t positions[8] = {0};
-    static int8_t directions[8] = {1, 1, 1, 1, 1, 1, 1, 1};
-    static uint32_t lastMove = 0;
-    static bool initialized = false;
-    
-    if (!initialized) {
+struct ScannerState {
+    int16_t positions[8] = {0};
+    int8_t directions[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    uint32_t lastMove = 0;
+    bool initialized = false;
+};
+
+uint32_t effectScanner(ScannerState& st) {
+    if (!st.initialized) {
         // Distribute dots evenly
         for (uint8_t i = 0; i < scannerParams.numDots; i++) {
-            positions[i] = i * (NUM_LEDS / scannerParams.numDots);
+            st.positions[i] = i * (NUM_LEDS / scannerParams.numDots);
         }
-        initialized = true;
+        st.initialized = true;
     }
     
     uint16_t delayMs = map(scannerParams.speed, 0, 255, 80, 10);
     
     // Fade
-    if (!scannerParams.overlay) {
-        uint8_t fadeAmount = map(scannerParams.trailLength, 1, 50, 100, 20);
-        fadeAll(fadeAmount);
-    }
+    uint8_t fadeAmount = map(scannerParams.trailLength, 1, 50, 100, 20);
+    fadeAll(frameFade(fadeAmount));
     
-    if (millis() - lastMove > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastMove, delayMs); s > 0; s--) {
         for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-            positions[d] += directions[d];
+            st.positions[d] += st.directions[d];
             
-            if (positions[d] >= NUM_LEDS - 1) {
-                positions[d] = NUM_LEDS - 1;
-                directions[d] = -1;
-            } else if (positions[d] <= 0) {
-                positions[d] = 0;
-                directions[d] = 1;
+            if (st.positions[d] >= NUM_LEDS - 1) {
+                st.positions[d] = NUM_LEDS - 1;
+                st.directions[d] = -1;
+            } else if (st.positions[d] <= 0) {
+                st.positions[d] = 0;
+                st.directions[d] = 1;
             }
         }
-        lastMove = millis();
     }
     
     // Draw dots - each dot has its own color
     for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-        if (positions[d] >= 0 && positions[d] < NUM_LEDS) {
-            leds[positions[d]] = scannerParams.colors[d % 8]; // Modulo 8 for safety
+        if (st.positions[d] >= 0 && st.positions[d] < NUM_LEDS) {
+            leds[st.positions[d]] = scannerParams.colors[d % 8]; // Modulo 8 for safety
         }
     }
     
     // Dual mode - second set from the other side
     if (scannerParams.dualMode) {
         for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-            int16_t mirrorPos = NUM_LEDS - 1 - positions[d];
+            int16_t mirrorPos = NUM_LEDS - 1 - st.positions[d];
             if (mirrorPos >= 0 && mirrorPos < NUM_LEDS) {
                 leds[mirrorPos] = scannerParams.colors[d % 8]; // Same color for mirrored dot
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectComet() {
-    static int16_t position = 0;
-    static uint32_t lastMove = 0;
-    static uint8_t sparkles[100]; // Sparkle brightness for each position
-    
+struct CometState {
+    int16_t position = 0;
+    uint32_t lastMove = 0;
+    uint8_t sparkles[100]; // Sparkle brightness for each position
+    uint32_t sparkleCarry = 0;
+};
+
+uint32_t effectComet(CometState& st) {
     uint16_t delayMs = map(cometParams.speed, 0, 255, 60, 5);
     
     // Fade existing sparkles FAST
+    uint8_t sparkleFade = min(frameStep(50, st.sparkleCarry), (uint32_t)255);
     for (uint16_t i = 0; i < NUM_LEDS && i < 100; i++) {
-        if (sparkles[i] > 50) sparkles[i] -= 50; // Very fast fade
-        else sparkles[i] = 0;
+        st.sparkles[i] = qsub8(st.sparkles[i], sparkleFade); // Very fast fade
     }
     
-    if (millis() - lastMove > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastMove, delayMs); s > 0; s--) {
         if (cometParams.direction == DIR_FORWARD) {
-            position++;
-            if (position >= NUM_LEDS + cometParams.trailLength) {
-                position = -cometParams.trailLength;
+            st.position++;
+            if (st.position >= NUM_LEDS + cometParams.trailLength) {
+                st.position = -cometParams.trailLength;
             }
         } else {
-            position--;
-            if (position < -cometParams.trailLength) {
-                position = NUM_LEDS + cometParams.trailLength;
+            st.position--;
+            if (st.position < -cometParams.trailLength) {
+                st.position = NUM_LEDS + cometParams.trailLength;
             }
         }
-        lastMove = millis();
     }
     
-    FastLED.clear();
+    clearLeds();
     
     // Draw comet with trail
     for (int16_t i = 0; i < cometParams.trailLength; i++) {
         int16_t ledPos;
         if (cometParams.direction == DIR_FORWARD) {
-            ledPos = position - i;
+            ledPos = st.position - i;
         } else {
-            ledPos = position + i;
+            ledPos = st.position + i;
         }
         
         if (ledPos >= 0 && ledPos < NUM_LEDS) {
@@ -448,7 +440,7 @@ void effectComet() {
             // Occasionally create sparkle in the trail
             if (i > 4 && cometParams.sparkleEnabled && ledPos < 100) {
                 if (random8() < 12) { // Low chance
-                    sparkles[ledPos] = 255;
+                    st.sparkles[ledPos] = 255;
                 }
             }
         }
@@ -457,29 +449,30 @@ void effectComet() {
     // Draw sparkles - REPLACE pixel instead of adding
     if (cometParams.sparkleEnabled) {
         for (uint16_t i = 0; i < NUM_LEDS && i < 100; i++) {
-            if (sparkles[i] > 30) {
+            if (st.sparkles[i] > 30) {
                 // Replace with sparkle color (not add)
                 leds[i] = cometParams.sparkleColor;
-                leds[i].nscale8(sparkles[i]);
+                leds[i].nscale8(st.sparkles[i]);
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectRunningLights() {
-    static uint16_t offset = 0;
-    static uint32_t lastStep = 0;
-    
+struct RunningLightsState {
+    uint16_t offset = 0;
+    uint32_t lastStep = 0;
+};
+
+uint32_t effectRunningLights(RunningLightsState& st) {
     uint16_t delayMs = map(runningLightsParams.speed, 0, 255, 80, 10);
     
-    if (millis() - lastStep > delayMs) {
-        offset++;
-        lastStep = millis();
-    }
+    st.offset += intervalSteps(st.lastStep, delayMs);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         uint8_t wave;
-        uint16_t phase = (i * 256 / runningLightsParams.waveWidth) + offset * 8;
+        uint16_t phase = (i * 256 / runningLightsParams.waveWidth) + st.offset * 8;
         
         switch (runningLightsParams.shape) {
             case SHAPE_SINE:
@@ -502,7 +495,7 @@ void effectRunningLights() {
         uint8_t numC = runningLightsParams.numColors;
         if (numC < 1) numC = 1;
         if (numC > 4) numC = 4;
-        uint8_t colorIndex = ((i + offset) * numC / NUM_LEDS) % numC;
+        uint8_t colorIndex = ((i + st.offset) * numC / NUM_LEDS) % numC;
         CRGB col = runningLightsParams.colors[colorIndex];
         col.nscale8(wave);
         leds[i] = col;
@@ -512,88 +505,94 @@ void effectRunningLights() {
     if (runningLightsParams.dualMode) {
         for (uint16_t i = 0; i < NUM_LEDS; i++) {
             uint8_t wave;
-            uint16_t phase = (i * 256 / runningLightsParams.waveWidth) - offset * 8;
+            uint16_t phase = (i * 256 / runningLightsParams.waveWidth) - st.offset * 8;
             wave = sin8(phase);
             
             uint8_t numC = runningLightsParams.numColors;
             if (numC < 1) numC = 1;
-            uint8_t colorIndex = ((i - offset) * numC / NUM_LEDS) % numC;
+            uint8_t colorIndex = ((i - st.offset) * numC / NUM_LEDS) % numC;
             CRGB col = runningLightsParams.colors[colorIndex];
             col.nscale8(wave / 2); // Dimmer for dual mode
             leds[i] += col;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectAndroid() {
-    static int16_t position = 0;
-    static int8_t direction = 1;
-    static uint32_t lastMove = 0;
-    
+struct AndroidState {
+    int16_t position = 0;
+    int8_t direction = 1;
+    uint32_t lastMove = 0;
+};
+
+uint32_t effectAndroid(AndroidState& st) {
     uint16_t sectionLen = NUM_LEDS * androidParams.sectionWidth / 100;
     if (sectionLen < 3) sectionLen = 3;
     
     uint16_t delayMs = map(androidParams.speed, 0, 255, 50, 5);
     
-    if (millis() - lastMove > delayMs) {
-        position += direction;
-        if (position + sectionLen >= NUM_LEDS) {
-            direction = -1;
-        } else if (position <= 0) {
-            direction = 1;
+    for (uint16_t s = intervalSteps(st.lastMove, delayMs); s > 0; s--) {
+        st.position += st.direction;
+        if (st.position + sectionLen >= NUM_LEDS) {
+            st.direction = -1;
+        } else if (st.position <= 0) {
+            st.direction = 1;
         }
-        lastMove = millis();
     }
     
     fill_solid(leds, NUM_LEDS, androidParams.colorSecondary);
     
     for (uint16_t i = 0; i < sectionLen; i++) {
-        if (position + i >= 0 && position + i < NUM_LEDS) {
-            leds[position + i] = androidParams.colorPrimary;
+        if (st.position + i >= 0 && st.position + i < NUM_LEDS) {
+            leds[st.position + i] = androidParams.colorPrimary;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 4: TWINKLE/SPARKLE EFFECTS
 // ============================================================================
 
-// State for twinkle effects
-static uint8_t twinkleState[NUM_LEDS];
-static uint8_t twinkleBrightness[NUM_LEDS];
-static CRGB twinkleColors[NUM_LEDS];
-
-void effectTwinkle() {
-    static uint32_t lastUpdate = 0;
-    static bool initialized = false;
-    
-    CRGBPalette16 pal = getPalette(twinkleParams.palette);
+struct TwinkleState {
+    uint8_t* twinkleState = allocEffectBuffer<uint8_t>();
+    uint8_t* twinkleBrightness = allocEffectBuffer<uint8_t>();
+    CRGB* twinkleColors = allocEffectBuffer<CRGB>();
+    uint32_t lastUpdate = 0;
     
-    if (!initialized) {
-        memset(twinkleState, 0, NUM_LEDS);
-        memset(twinkleBrightness, 0, NUM_LEDS);
-        initialized = true;
+    ~TwinkleState() {
+        freePixelBuffer(twinkleState);
+        freePixelBuffer(twinkleBrightness);
+        freePixelBuffer(twinkleColors);
     }
+};
+
+uint32_t effectTwinkle(TwinkleState& st) {
+    if (!st.twinkleState || !st.twinkleBrightness || !st.twinkleColors) return EFFECT_NEXT_FRAME;
+    
+    const CRGB* pal = getPaletteLUT(twinkleParams.palette);
     
     uint16_t delayMs = map(twinkleParams.speed, 0, 255, 50, 5);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, delayMs); s > 0; s--) {
         // Randomly light up new LEDs
         if (random8() < twinkleParams.intensity) {
             uint16_t idx = random16(NUM_LEDS);
-            if (twinkleState[idx] == 0) {
-                twinkleState[idx] = 1;  // Brightening
-                twinkleBrightness[idx] = 0;
+            if (st.twinkleState[idx] == 0) {
+                st.twinkleState[idx] = 1;  // Brightening
+                st.twinkleBrightness[idx] = 0;
                 
                 switch (twinkleParams.colorMode) {
                     case TWINKLE_SINGLE:
-                        twinkleColors[idx] = twinkleParams.twinkleColor;
+                        st.twinkleColors[idx] = twinkleParams.twinkleColor;
                         break;
                     case TWINKLE_PALETTE:
-                        twinkleColors[idx] = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
+                        st.twinkleColors[idx] = pal[random8()];
                         break;
                     case TWINKLE_RANDOM:
-                        twinkleColors[idx] = CHSV(random8(), 255, 255);
+                        st.twinkleColors[idx] = CHSV(random8(), 255, 255);
                         break;
                 }
             }
@@ -603,86 +602,93 @@ void effectTwinkle() {
         uint8_t fadeStep = map(twinkleParams.fadeSpeed, 0, 255, 5, 30);
         
         for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            if (twinkleState[i] == 1) {
+            if (st.twinkleState[i] == 1) {
                 // Brightening
-                twinkleBrightness[i] = qadd8(twinkleBrightness[i], fadeStep * 2);
-                if (twinkleBrightness[i] >= 250) {
-                    twinkleState[i] = 2;  // Switch to dimming
+                st.twinkleBrightness[i] = qadd8(st.twinkleBrightness[i], fadeStep * 2);
+                if (st.twinkleBrightness[i] >= 250) {
+                    st.twinkleState[i] = 2;  // Switch to dimming
                 }
-            } else if (twinkleState[i] == 2) {
+            } else if (st.twinkleState[i] == 2) {
                 // Dimming
-                twinkleBrightness[i] = qsub8(twinkleBrightness[i], fadeStep);
-                if (twinkleBrightness[i] <= 5) {
-                    twinkleState[i] = 0;
-                    twinkleBrightness[i] = 0;
+                st.twinkleBrightness[i] = qsub8(st.twinkleBrightness[i], fadeStep);
+                if (st.twinkleBrightness[i] <= 5) {
+                    st.twinkleState[i] = 0;
+                    st.twinkleBrightness[i] = 0;
                 }
             }
         }
-        
-        lastUpdate = millis();
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (twinkleBrightness[i] > 0) {
-            CRGB col = twinkleColors[i];
-            col.nscale8(twinkleBrightness[i]);
+        if (st.twinkleBrightness[i] > 0) {
+            CRGB col = st.twinkleColors[i];
+            col.nscale8(st.twinkleBrightness[i]);
             leds[i] = col;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectTwinkleFox() {
-    static uint8_t foxBrightness[NUM_LEDS];
-    static CRGB foxColors[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
+struct TwinkleFoxState {
+    uint8_t* foxBrightness = allocEffectBuffer<uint8_t>();
+    CRGB* foxColors = allocEffectBuffer<CRGB>();
+    uint32_t lastUpdate = 0;
     
-    CRGBPalette16 pal = getPalette(twinkleFoxParams.palette);
+    ~TwinkleFoxState() {
+        freePixelBuffer(foxBrightness);
+        freePixelBuffer(foxColors);
+    }
+};
+
+uint32_t effectTwinkleFox(TwinkleFoxState& st) {
+    if (!st.foxBrightness || !st.foxColors) return EFFECT_NEXT_FRAME;
+    
+    const CRGB* pal = getPaletteLUT(twinkleFoxParams.palette);
     
     uint16_t delayMs = map(twinkleFoxParams.speed, 0, 255, 30, 5);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, delayMs); s > 0; s--) {
         // Randomly light up
         if (random8() < twinkleFoxParams.twinkleRate) {
             uint16_t idx = random16(NUM_LEDS);
-            foxBrightness[idx] = 255;
-            foxColors[idx] = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
+            st.foxBrightness[idx] = 255;
+            st.foxColors[idx] = pal[random8()];
         }
         
         // Slowly fade all
         uint8_t fadeAmount = map(twinkleFoxParams.fadeOut, 0, 255, 1, 15);
         for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            foxBrightness[i] = qsub8(foxBrightness[i], fadeAmount);
+            st.foxBrightness[i] = qsub8(st.foxBrightness[i], fadeAmount);
         }
-        
-        lastUpdate = millis();
     }
     
     // Render
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        CRGB col = foxColors[i];
-        col.nscale8(foxBrightness[i]);
+        CRGB col = st.foxColors[i];
+        col.nscale8(st.foxBrightness[i]);
         leds[i] = col;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectSparkle() {
-    static uint32_t lastSpark = 0;
-    
-    // Background
-    if (!sparkleParams.overlay) {
-        fill_solid(leds, NUM_LEDS, sparkleParams.colorBg);
-    } else {
-        // In overlay mode always fade sparkles
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            leds[i] = blend(leds[i], sparkleParams.colorBg, 30);
-        }
+struct SparkleState {
+    uint32_t lastSpark = 0;
+};
+
+uint32_t effectSparkle(SparkleState& st) {
+    // Background: sparkles fade into it
+    uint8_t bgBlend = frameFade(30);
+    for (uint16_t i = 0; i < NUM_LEDS; i++) {
+        leds[i] = blend(leds[i], sparkleParams.colorBg, bgBlend);
     }
     
     uint16_t delayMs = map(sparkleParams.speed, 0, 255, 80, 10);
     
-    if (millis() - lastSpark > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastSpark, delayMs); s > 0; s--) {
         // Random sparkles
         uint8_t numSparks = map(sparkleParams.intensity, 0, 255, 1, 10);
         for (uint8_t s = 0; s < numSparks; s++) {
@@ -693,32 +699,33 @@ void effectSparkle() {
                 leds[idx] = sparkleParams.colorSpark;
             }
         }
-        lastSpark = millis();
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectGlitter() {
-    static uint8_t hue = 0;
+struct GlitterState {
+    uint8_t hue = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectGlitter(GlitterState& st) {
+    uint8_t bgBlend = frameFade(30);
     
-    if (!glitterParams.overlay) {
-        // Without overlay: normal background (immediate)
-        if (glitterParams.rainbowBg) {
-            fill_rainbow(leds, NUM_LEDS, hue++, 7);
-        } else {
-            fill_solid(leds, NUM_LEDS, glitterParams.bgColor);
+    if (glitterParams.rainbowBg) {
+        st.hue += frameStep(1, st.carry);
+    }
+    
+    // Smooth transition to background (glitter fades slower)
+    if (glitterParams.rainbowBg) {
+        const CRGB* rainbow = getRainbowLUT();
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            CRGB rainbowColor = rainbow[(uint8_t)(st.hue + i * 7)];
+            leds[i] = blend(leds[i], rainbowColor, bgBlend);
         }
     } else {
-        // With overlay: smooth transition to background (glitter fades slower)
-        if (glitterParams.rainbowBg) {
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                CRGB rainbowColor = CHSV(hue + (i * 7), 255, 255);
-                leds[i] = blend(leds[i], rainbowColor, 30);
-            }
-            hue++;
-        } else {
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                leds[i] = blend(leds[i], glitterParams.bgColor, 30);
-            }
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            leds[i] = blend(leds[i], glitterParams.bgColor, bgBlend);
         }
     }
     
@@ -729,125 +736,158 @@ void effectGlitter() {
             leds[random16(NUM_LEDS)] += CRGB::White;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectStarryNight() {
-    static uint8_t starBrightness[NUM_LEDS];
-    static int16_t shootingPos = -1;
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastShoot = 0;
+struct StarryNightState {
+    uint8_t* starBrightness = allocEffectBuffer<uint8_t>();
+    int16_t shootingPos = -1;
+    uint32_t lastUpdate = 0;
+    uint32_t lastShoot = 0;
+    uint32_t shootCarry = 0;
+    
+    ~StarryNightState() {
+        freePixelBuffer(starBrightness);
+    }
+};
+
+uint32_t effectStarryNight(StarryNightState& st) {
+    if (!st.starBrightness) return EFFECT_NEXT_FRAME;
     
     uint16_t delayMs = map(starryNightParams.speed, 0, 255, 200, 5);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, delayMs); s > 0; s--) {
         // Star twinkling
         for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            if (starBrightness[i] > 0) {
+            if (st.starBrightness[i] > 0) {
                 // Random brightness fluctuations
                 int8_t change = random8(20) - 10;
-                starBrightness[i] = constrain((int16_t)starBrightness[i] + change, 0, 255);
+                st.starBrightness[i] = constrain((int16_t)st.starBrightness[i] + change, 0, 255);
                 
                 // Sometimes fades out
                 if (random8() < 5) {
-                    starBrightness[i] = qsub8(starBrightness[i], 30);
+                    st.starBrightness[i] = qsub8(st.starBrightness[i], 30);
                 }
             } else {
                 // Randomly light up new stars (density 0-255 -> chance 0-25)
                 uint8_t chance = map(starryNightParams.density, 0, 255, 1, 25);
                 if (random8() < chance) {
-                    starBrightness[i] = random8(100, 255);
+                    st.starBrightness[i] = random8(100, 255);
                 }
             }
         }
-        lastUpdate = millis();
     }
     
     // Shooting star
     if (starryNightParams.shootingStars) {
-        if (shootingPos < 0 && millis() - lastShoot > 3000 + random16(5000)) {
-            shootingPos = 0;
-            lastShoot = millis();
+        if (st.shootingPos < 0 && millis() - st.lastShoot > 3000 + random16(5000)) {
+            st.shootingPos = 0;
+            st.lastShoot = millis();
         }
         
-        if (shootingPos >= 0) {
-            shootingPos += 3;
-            if (shootingPos >= NUM_LEDS) {
-                shootingPos = -1;
+        if (st.shootingPos >= 0) {
+            st.shootingPos += frameStep(3, st.shootCarry);
+            if (st.shootingPos >= NUM_LEDS) {
+                st.shootingPos = -1;
             }
         }
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (starBrightness[i] > 0) {
+        if (st.starBrightness[i] > 0) {
             CRGB col = starryNightParams.colorStars;
-            col.nscale8(starBrightness[i]);
+            col.nscale8(st.starBrightness[i]);
             leds[i] = col;
         }
     }
     
     // Draw shooting star
-    if (shootingPos >= 0) {
+    if (st.shootingPos >= 0) {
         for (int8_t t = 0; t < 8; t++) {
-            int16_t pos = shootingPos - t;
+            int16_t pos = st.shootingPos - t;
             if (pos >= 0 && pos < NUM_LEDS) {
                 uint8_t bright = 255 - t * 30;
                 leds[pos] = CRGB(bright, bright, bright);
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 5: FIRE/ORGANIC EFFECTS
 // ============================================================================
 
-// Buffer for fire effect
-static uint8_t heat[NUM_LEDS];
-
-void effectFire() {
-    CRGBPalette16 pal = getPalette(fireParams.palette);
+struct FireState {
+    uint8_t* heat = allocEffectBuffer<uint8_t>();
+    uint32_t carry = 0;
     
-    // Cooling
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        heat[i] = qsub8(heat[i], random8(0, ((fireParams.cooling * 10) / NUM_LEDS) + 2));
+    ~FireState() {
+        freePixelBuffer(heat);
     }
+};
+
+uint32_t effectFire(FireState& st) {
+    if (!st.heat) return EFFECT_NEXT_FRAME;
     
-    // Move heat upwards
-    for (uint16_t k = NUM_LEDS - 1; k >= 2; k--) {
-        heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
-    }
+    const CRGB* pal = getPaletteLUT(fireParams.palette);
     
-    // Random sparks at bottom
-    if (random8() < fireParams.sparking) {
-        uint8_t y = random8(7);
-        if (y < NUM_LEDS) {
-            heat[y] = qadd8(heat[y], random8(160, 255));
+    // Simulation runs once per nominal frame
+    for (uint32_t s = frameTicks(st.carry); s > 0; s--) {
+        // Cooling
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            st.heat[i] = qsub8(st.heat[i], random8(0, ((fireParams.cooling * 10) / NUM_LEDS) + 2));
         }
-    }
-    
-    // Boost
-    if (fireParams.boost) {
-        for (uint16_t i = 0; i < 3 && i < NUM_LEDS; i++) {
-            heat[i] = qadd8(heat[i], 50);
+        
+        // Move heat upwards
+        for (uint16_t k = NUM_LEDS - 1; k >= 2; k--) {
+            st.heat[k] = (st.heat[k - 1] + st.heat[k - 2] + st.heat[k - 2]) / 3;
+        }
+        
+        // Random sparks at bottom
+        if (random8() < fireParams.sparking) {
+            uint8_t y = random8(7);
+            if (y < NUM_LEDS) {
+                st.heat[y] = qadd8(st.heat[y], random8(160, 255));
+            }
+        }
+        
+        // Boost
+        if (fireParams.boost) {
+            for (uint16_t i = 0; i < 3 && i < NUM_LEDS; i++) {
+                st.heat[i] = qadd8(st.heat[i], 50);
+            }
         }
     }
     
     // Map to colors
     for (uint16_t j = 0; j < NUM_LEDS; j++) {
-        uint8_t colorIndex = scale8(heat[j], 240);
-        leds[j] = ColorFromPalette(pal, colorIndex, 255, LINEARBLEND);
+        uint8_t colorIndex = scale8(st.heat[j], 240);
+        leds[j] = pal[colorIndex];
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectCandle() {
-    static uint8_t candleBrightness[NUM_LEDS];
-    static uint32_t lastFlicker = 0;
+struct CandleState {
+    uint8_t* candleBrightness = allocEffectBuffer<uint8_t>();
+    uint32_t lastFlicker = 0;
+    
+    ~CandleState() {
+        freePixelBuffer(candleBrightness);
+    }
+};
+
+uint32_t effectCandle(CandleState& st) {
+    if (!st.candleBrightness) return EFFECT_NEXT_FRAME;
     
     uint16_t delayMs = map(candleParams.speed, 0, 255, 80, 5);
     
-    if (millis() - lastFlicker > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastFlicker, delayMs); s > 0; s--) {
         // Intensity controls the RANGE of brightness fluctuations
         // 0 = almost no fluctuations (±5), 255 = dramatic fluctuations (±127)
         uint8_t flickerRange = map(candleParams.intensity, 0, 255, 5, 127);
@@ -858,17 +898,16 @@ void effectCandle() {
             // Each LED as its own candle
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
                 int16_t change = random8(flickerRange * 2) - flickerRange;
-                candleBrightness[i] = constrain((int16_t)candleBrightness[i] + change, minBright, 255);
+                st.candleBrightness[i] = constrain((int16_t)st.candleBrightness[i] + change, minBright, 255);
             }
         } else {
             // All as one candle
             int16_t change = random8(flickerRange * 2) - flickerRange;
-            uint8_t newBright = constrain((int16_t)candleBrightness[0] + change, minBright, 255);
+            uint8_t newBright = constrain((int16_t)st.candleBrightness[0] + change, minBright, 255);
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                candleBrightness[i] = newBright;
+                st.candleBrightness[i] = newBright;
             }
         }
-        lastFlicker = millis();
     }
     
     // Render
@@ -878,7 +917,7 @@ void effectCandle() {
         // Color shift - changes color for each LED stably (not random)
         if (candleParams.colorShift > 0) {
             // Use sin8 with LED index for stable variation
-            uint8_t variation = sin8(i * 17 + candleBrightness[i]);
+            uint8_t variation = sin8(i * 17 + st.candleBrightness[i]);
             int16_t shiftAmount = map(variation, 0, 255, -candleParams.colorShift, candleParams.colorShift);
             
             // Shift mainly towards red/orange for fire effect
@@ -886,12 +925,14 @@ void effectCandle() {
             col.g = constrain((int16_t)col.g + shiftAmount / 3, 0, 255);
         }
         
-        col.nscale8(candleBrightness[i]);
+        col.nscale8(st.candleBrightness[i]);
         leds[i] = col;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectFireFlicker() {
+uint32_t effectFireFlicker(NoEffectState&) {
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         uint8_t flicker = random8(fireFlickerParams.intensity);
         CRGB col = fireFlickerParams.color;
@@ -899,16 +940,22 @@ void effectFireFlicker() {
         leds[i] = col;
     }
     
-    FastLED.delay(map(fireFlickerParams.speed, 0, 255, 100, 20));
+    // Hold each flicker for a speed-dependent time; the scheduler wakes us
+    return effectWakeIn(map(fireFlickerParams.speed, 0, 255, 100, 20));
 }
 
-void effectLava() {
-    static uint16_t offset = 0;
+struct LavaState {
+    uint16_t offset = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectLava(LavaState& st) {
+    st.offset += frameStep(map(lavaParams.speed, 0, 255, 5, 30), st.carry);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         // Two noise layers for blob effect
-        uint8_t noise1 = inoise8(i * lavaParams.blobSize, offset);
-        uint8_t noise2 = inoise8(i * lavaParams.blobSize + 1000, offset + 5000);
+        uint8_t noise1 = inoise8(i * lavaParams.blobSize, st.offset);
+        uint8_t noise2 = inoise8(i * lavaParams.blobSize + 1000, st.offset + 5000);
         
         uint8_t combined = (noise1 + noise2) / 2;
         
@@ -925,126 +972,156 @@ void effectLava() {
         leds[i] = blend(leds[i], col, blendAmount);
     }
     
-    offset += map(lavaParams.speed, 0, 255, 5, 30);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectAurora() {
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(auroraParams.palette);
+struct AuroraState {
+    uint16_t offset = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectAurora(AuroraState& st) {
+    st.offset += frameStep(map(auroraParams.speed, 0, 255, 3, 30), st.carry);
+    
+    const CRGB* pal = getPaletteLUT(auroraParams.palette);
     
     // Intensity = wave size (low = thin, high = wide)
     uint8_t waveScale = map(auroraParams.intensity, 0, 255, 30, 8);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint8_t noise = inoise8(i * waveScale, offset);
-        uint8_t colorIdx = noise + (offset >> 4);
+        uint8_t noise = inoise8(i * waveScale, st.offset);
+        uint8_t colorIdx = noise + (st.offset >> 4);
         uint8_t brightness = map(noise, 0, 255, 100, 255);
         
-        leds[i] = ColorFromPalette(pal, colorIdx, brightness, LINEARBLEND);
+        leds[i] = paletteLookup(pal, colorIdx, brightness);
     }
     
-    offset += map(auroraParams.speed, 0, 255, 3, 30);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectPacifica() {
+struct PacificaState {
+    uint16_t offset = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectPacifica(PacificaState& st) {
     // Simple ocean effect - color waves from palette
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(pacificaParams.palette);
+    
+    st.offset += frameStep(map(pacificaParams.speed, 0, 255, 1, 15), st.carry);
+    
+    const CRGB* pal = getPaletteLUT(pacificaParams.palette);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         // Three overlapping waves with different frequencies
-        uint8_t wave1 = sin8(i * 7 + offset);
-        uint8_t wave2 = sin8(i * 11 - offset / 2);
-        uint8_t wave3 = sin8(i * 5 + offset / 3);
+        uint8_t wave1 = sin8(i * 7 + st.offset);
+        uint8_t wave2 = sin8(i * 11 - st.offset / 2);
+        uint8_t wave3 = sin8(i * 5 + st.offset / 3);
         
         // Combine waves
         uint8_t combined = (wave1 + wave2 + wave3) / 3;
         
         // Use combination as color index from palette
-        uint8_t colorIdx = combined + (offset >> 3);
+        uint8_t colorIdx = combined + (st.offset >> 3);
         
         // Brightness based on wave
         uint8_t brightness = map(combined, 0, 255, 120, 255);
         
-        leds[i] = ColorFromPalette(pal, colorIdx, brightness, LINEARBLEND);
+        leds[i] = paletteLookup(pal, colorIdx, brightness);
     }
     
-    offset += map(pacificaParams.speed, 0, 255, 1, 15);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectLake() {
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(lakeParams.palette);
+struct LakeState {
+    uint16_t offset = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectLake(LakeState& st) {
+    st.offset += frameStep(map(lakeParams.speed, 0, 255, 2, 15), st.carry);
+    
+    const CRGB* pal = getPaletteLUT(lakeParams.palette);
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         // Slow, calm rippling
-        uint8_t wave1 = sin8(i * 5 + offset / 3);
-        uint8_t wave2 = sin8(i * 7 - offset / 2);
+        uint8_t wave1 = sin8(i * 5 + st.offset / 3);
+        uint8_t wave2 = sin8(i * 7 - st.offset / 2);
         uint8_t combined = (wave1 + wave2) / 2;
         
-        uint8_t colorIdx = i * 256 / NUM_LEDS + offset / 10;
-        leds[i] = ColorFromPalette(pal, colorIdx, combined, LINEARBLEND);
+        uint8_t colorIdx = i * 256 / NUM_LEDS + st.offset / 10;
+        leds[i] = paletteLookup(pal, colorIdx, combined);
     }
     
-    offset += map(lakeParams.speed, 0, 255, 2, 15);
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 6: HOLIDAY EFFECTS
 // ============================================================================
 
-void effectFairy() {
-    static uint8_t flasherBrightness[NUM_LEDS];
-    static uint8_t flasherHue[NUM_LEDS];
-    static uint8_t flasherState[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
-    static bool initialized = false;
+struct FairyState {
+    uint8_t* flasherBrightness = allocEffectBuffer<uint8_t>();
+    uint8_t* flasherHue = allocEffectBuffer<uint8_t>();
+    uint8_t* flasherState = allocEffectBuffer<uint8_t>();
+    uint32_t lastUpdate = 0;
+    bool initialized = false;
+    
+    ~FairyState() {
+        freePixelBuffer(flasherBrightness);
+        freePixelBuffer(flasherHue);
+        freePixelBuffer(flasherState);
+    }
+};
+
+uint32_t effectFairy(FairyState& st) {
+    if (!st.flasherBrightness || !st.flasherHue || !st.flasherState) return EFFECT_NEXT_FRAME;
     
     // Normalize numFlashers: slider 1-255 -> 1-NUM_LEDS
-    uint8_t numFlashers = map(fairyParams.numFlashers, 1, 255, 1, NUM_LEDS);
+    uint16_t numFlashers = map(fairyParams.numFlashers, 1, 255, 1, NUM_LEDS);
     if (numFlashers < 1) numFlashers = 1;
     if (numFlashers > NUM_LEDS) numFlashers = NUM_LEDS;
     
-    if (!initialized) {
-        for (uint8_t i = 0; i < NUM_LEDS; i++) {
-            flasherBrightness[i] = random8(50, 200);
-            flasherHue[i] = random8();
-            flasherState[i] = random8(3);
+    if (!st.initialized) {
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            st.flasherBrightness[i] = random8(50, 200);
+            st.flasherHue[i] = random8();
+            st.flasherState[i] = random8(3);
         }
-        initialized = true;
+        st.initialized = true;
     }
     
     uint16_t delayMs = map(fairyParams.speed, 0, 255, 60, 8);
     
-    if (millis() - lastUpdate > delayMs) {
-        for (uint8_t i = 0; i < numFlashers; i++) {
-            switch (flasherState[i]) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, delayMs); s > 0; s--) {
+        for (uint16_t i = 0; i < numFlashers; i++) {
+            switch (st.flasherState[i]) {
                 case 0: // Off
-                    if (random8() < 25) flasherState[i] = 1;
+                    if (random8() < 25) st.flasherState[i] = 1;
                     break;
                 case 1: // Brightening
-                    flasherBrightness[i] = qadd8(flasherBrightness[i], 20);
-                    if (flasherBrightness[i] >= 250) flasherState[i] = 2;
+                    st.flasherBrightness[i] = qadd8(st.flasherBrightness[i], 20);
+                    if (st.flasherBrightness[i] >= 250) st.flasherState[i] = 2;
                     break;
                 case 2: // Dimming
-                    flasherBrightness[i] = qsub8(flasherBrightness[i], 10);
-                    if (flasherBrightness[i] <= 80) {
-                        flasherState[i] = 0;
-                        flasherHue[i] = random8(); // New color
+                    st.flasherBrightness[i] = qsub8(st.flasherBrightness[i], 10);
+                    if (st.flasherBrightness[i] <= 80) {
+                        st.flasherState[i] = 0;
+                        st.flasherHue[i] = random8(); // New color
                     }
                     break;
             }
         }
-        lastUpdate = millis();
     }
     
     // Black background
-    FastLED.clear();
+    clearLeds();
     
     // Distribute lights evenly
-    uint16_t spacing = NUM_LEDS / max((uint8_t)1, numFlashers);
+    uint16_t spacing = NUM_LEDS / max((uint16_t)1, numFlashers);
+    const CRGB* pal = getPaletteLUT(fairyParams.palette);
+    const CRGB* rainbow = getRainbowLUT();
     
-    for (uint8_t i = 0; i < numFlashers; i++) {
+    for (uint16_t i = 0; i < numFlashers; i++) {
         uint16_t pos = (i * spacing + i * 7) % NUM_LEDS;
         
         CRGB col;
@@ -1057,37 +1134,44 @@ void effectFairy() {
                 col = CRGB(200, 220, 255);
                 break;
             case 2: // Multicolor
-                col = CHSV(flasherHue[i], 255, 255);
+                col = rainbow[st.flasherHue[i]];
                 break;
             case 3: // Palette
             default:
-                CRGBPalette16 pal = getPalette(fairyParams.palette);
-                col = ColorFromPalette(pal, flasherHue[i], 255, LINEARBLEND);
+                col = pal[st.flasherHue[i]];
                 break;
         }
         
-        col.nscale8(flasherBrightness[i]);
+        col.nscale8(st.flasherBrightness[i]);
         leds[pos] = col;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectChristmasChase() {
-    static uint16_t offset = 0;
-    static uint32_t lastStep = 0;
-    static uint8_t sparkleBrightness[NUM_LEDS]; // Sparkle brightness for XMAS_SPARKLE
-    static uint32_t lastSparkle = 0;
+struct ChristmasChaseState {
+    uint16_t offset = 0;
+    uint32_t lastStep = 0;
+    uint8_t* sparkleBrightness = allocEffectBuffer<uint8_t>(); // Sparkle brightness for XMAS_SPARKLE
+    uint32_t lastSparkle = 0;
+    uint32_t sparkleCarry = 0;
+    
+    ~ChristmasChaseState() {
+        freePixelBuffer(sparkleBrightness);
+    }
+};
+
+uint32_t effectChristmasChase(ChristmasChaseState& st) {
+    if (!st.sparkleBrightness) return EFFECT_NEXT_FRAME;
     
     uint16_t delayMs = map(christmasChaseParams.speed, 0, 255, 100, 15);
     
-    if (millis() - lastStep > delayMs) {
-        offset++;
-        lastStep = millis();
-    }
+    st.offset += intervalSteps(st.lastStep, delayMs);
     
     switch (christmasChaseParams.pattern) {
         case XMAS_ALTERNATING:
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                if ((i + offset) % 6 < 3) {
+                if ((i + st.offset) % 6 < 3) {
                     leds[i] = christmasChaseParams.color1;
                 } else {
                     leds[i] = christmasChaseParams.color2;
@@ -1096,9 +1180,9 @@ void effectChristmasChase() {
             break;
             
         case XMAS_CHASE:
-            FastLED.clear();
+            clearLeds();
             for (uint16_t i = 0; i < NUM_LEDS; i += 6) {
-                uint16_t pos = (i + offset) % NUM_LEDS;
+                uint16_t pos = (i + st.offset) % NUM_LEDS;
                 leds[pos] = christmasChaseParams.color1;
                 if (pos + 1 < NUM_LEDS) leds[pos + 1] = christmasChaseParams.color2;
             }
@@ -1111,75 +1195,78 @@ void effectChristmasChase() {
             }
             
             // Fade out existing sparks - fade speed depends on speed
-            uint8_t fadeAmount = map(christmasChaseParams.speed, 0, 255, 5, 30);
+            uint8_t fadeAmount = min(frameStep(map(christmasChaseParams.speed, 0, 255, 5, 30), st.sparkleCarry), (uint32_t)255);
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                if (sparkleBrightness[i] > fadeAmount) {
-                    sparkleBrightness[i] -= fadeAmount;
+                if (st.sparkleBrightness[i] > fadeAmount) {
+                    st.sparkleBrightness[i] -= fadeAmount;
                 } else {
-                    sparkleBrightness[i] = 0;
+                    st.sparkleBrightness[i] = 0;
                 }
             }
             
             // Add new sparks according to speed
-            if (millis() - lastSparkle > delayMs) {
+            for (uint16_t n = intervalSteps(st.lastSparkle, delayMs); n > 0; n--) {
                 for (uint8_t s = 0; s < 5; s++) {
                     if (random8() < 80) {
-                        sparkleBrightness[random16(NUM_LEDS)] = 255;
+                        st.sparkleBrightness[random16(NUM_LEDS)] = 255;
                     }
                 }
-                lastSparkle = millis();
             }
             
             // Overlay sparks on background
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                if (sparkleBrightness[i] > 0) {
+                if (st.sparkleBrightness[i] > 0) {
                     CRGB sparkle = CRGB::White;
-                    sparkle.nscale8(sparkleBrightness[i]);
-                    leds[i] = blend(leds[i], CRGB::White, sparkleBrightness[i]);
+                    sparkle.nscale8(st.sparkleBrightness[i]);
+                    leds[i] = blend(leds[i], CRGB::White, st.sparkleBrightness[i]);
                 }
             }
             break;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectHalloweenEyes() {
-    static int16_t eyePositions[4] = {-1, -1, -1, -1};  // Eye pairs
-    static uint8_t eyeBrightness[4] = {0};
-    static uint8_t eyeState[4] = {0};  // 0=inactive, 1=appearing, 2=blinking, 3=fading
-    static uint32_t eyeTimers[4] = {0};
-    static uint32_t lastUpdate = 0;
-    
-    if (millis() - lastUpdate > 30) {
+struct HalloweenEyesState {
+    int16_t eyePositions[4] = {-1, -1, -1, -1};  // Eye pairs
+    uint8_t eyeBrightness[4] = {0};
+    uint8_t eyeState[4] = {0};  // 0=inactive, 1=appearing, 2=blinking, 3=fading
+    uint32_t eyeTimers[4] = {0};
+    uint32_t lastUpdate = 0;
+};
+
+uint32_t effectHalloweenEyes(HalloweenEyesState& st) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, 30); s > 0; s--) {
         // Manage eye pairs
         for (uint8_t e = 0; e < 2; e++) {
-            switch (eyeState[e]) {
+            switch (st.eyeState[e]) {
                 case 0:  // Inactive - randomly activate
                     if (random8() < 20) {
-                        eyePositions[e] = random8(NUM_LEDS - 5);
-                        eyeState[e] = 1;
-                        eyeBrightness[e] = 0;
+                        st.eyePositions[e] = random16(NUM_LEDS - 5);
+                        st.eyeState[e] = 1;
+                        st.eyeBrightness[e] = 0;
                     }
                     break;
                     
                 case 1:  // Appearing
-                    eyeBrightness[e] = qadd8(eyeBrightness[e], 10);
-                    if (eyeBrightness[e] >= 250) {
-                        eyeState[e] = 2;
-                        eyeTimers[e] = millis();
+                    st.eyeBrightness[e] = qadd8(st.eyeBrightness[e], 10);
+                    if (st.eyeBrightness[e] >= 250) {
+                        st.eyeState[e] = 2;
+                        st.eyeTimers[e] = millis();
                     }
                     break;
                     
                 case 2:  // Visible/Blinking
                     // Sometimes blink
                     if (random8() < 5) {
-                        eyeBrightness[e] = random8(50, 200);
+                        st.eyeBrightness[e] = random8(50, 200);
                     } else {
-                        eyeBrightness[e] = 255;
+                        st.eyeBrightness[e] = 255;
                     }
                     
                     // After time start fading
-                    if (millis() - eyeTimers[e] > halloweenEyesParams.duration) {
-                        eyeState[e] = 3;
+                    if (millis() - st.eyeTimers[e] > halloweenEyesParams.duration) {
+                        st.eyeState[e] = 3;
                     }
                     break;
                     
@@ -1187,64 +1274,64 @@ void effectHalloweenEyes() {
                     // fadeTime controls fade speed (higher fadeTime = slower fade)
                     {
                         uint8_t fadeStep = map(halloweenEyesParams.fadeTime, 50, 1275, 20, 2);
-                        eyeBrightness[e] = qsub8(eyeBrightness[e], fadeStep);
+                        st.eyeBrightness[e] = qsub8(st.eyeBrightness[e], fadeStep);
                     }
-                    if (eyeBrightness[e] <= 5) {
-                        eyeState[e] = 0;
-                        eyePositions[e] = -1;
+                    if (st.eyeBrightness[e] <= 5) {
+                        st.eyeState[e] = 0;
+                        st.eyePositions[e] = -1;
                     }
                     break;
             }
         }
-        lastUpdate = millis();
     }
     
     // Render
-    if (!halloweenEyesParams.overlay) {
-        FastLED.clear();
-    }
+    clearLeds();
     
     for (uint8_t e = 0; e < 2; e++) {
-        if (eyePositions[e] >= 0 && eyeBrightness[e] > 0) {
+        if (st.eyePositions[e] >= 0 && st.eyeBrightness[e] > 0) {
             CRGB col = halloweenEyesParams.color;
-            col.nscale8(eyeBrightness[e]);
+            col.nscale8(st.eyeBrightness[e]);
             
             // Left eye
-            if (eyePositions[e] < NUM_LEDS) {
-                leds[eyePositions[e]] = col;
+            if (st.eyePositions[e] < NUM_LEDS) {
+                leds[st.eyePositions[e]] = col;
             }
             // Right eye (2-4 LEDs further)
-            uint16_t rightEye = eyePositions[e] + 3;
+            uint16_t rightEye = st.eyePositions[e] + 3;
             if (rightEye < NUM_LEDS) {
                 leds[rightEye] = col;
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 // Structure for firework fragment
 struct FireworkFragment {
-    int16_t position;
+    int32_t position;           // Fixed point (x10) - exceeds int16 on long chains
     int8_t velocity;
     uint8_t brightness;
     CRGB color;
     bool active;
 };
 
-static FireworkFragment fragments[32];  // Max fragments
+struct FireworksState {
+    FireworkFragment fragments[32];  // Max fragments
+    uint32_t lastLaunch = 0;
+    uint32_t lastUpdate = 0;
+};
 
-void effectFireworks() {
-    static uint32_t lastLaunch = 0;
-    static uint32_t lastUpdate = 0;
-    
+uint32_t effectFireworks(FireworksState& st) {
     // Normalize gravity: 0-255 -> 1-8 (visible effect on falling)
     uint8_t gravityForce = map(fireworksParams.gravity, 0, 255, 1, 8);
     
-    if (millis() - lastUpdate > 20) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, 20); s > 0; s--) {
         // Randomly launch new firework
         if (random8() < fireworksParams.chance / 4) {
             // Find free fragments
-            int16_t launchPos = random8(NUM_LEDS);
+            int32_t launchPos = random16(NUM_LEDS);
             CRGB launchColor = CHSV(random8(), 255, 255);
             
             // Normalize fragments: 4-16 -> use directly
@@ -1252,65 +1339,69 @@ void effectFireworks() {
             
             uint8_t fragCount = 0;
             for (uint8_t f = 0; f < 32 && fragCount < targetFragments; f++) {
-                if (!fragments[f].active) {
-                    fragments[f].active = true;
-                    fragments[f].position = launchPos * 10;  // Fixed point
-                    fragments[f].velocity = random8(10, 30) * (random8(2) ? 1 : -1);
-                    fragments[f].brightness = 255;
-                    fragments[f].color = launchColor;
+                if (!st.fragments[f].active) {
+                    st.fragments[f].active = true;
+                    st.fragments[f].position = launchPos * 10;  // Fixed point
+                    st.fragments[f].velocity = random8(10, 30) * (random8(2) ? 1 : -1);
+                    st.fragments[f].brightness = 255;
+                    st.fragments[f].color = launchColor;
                     fragCount++;
                 }
             }
-            lastLaunch = millis();
+            st.lastLaunch = millis();
         }
         
         // Update fragments
         for (uint8_t f = 0; f < 32; f++) {
-            if (fragments[f].active) {
-                fragments[f].position += fragments[f].velocity;
+            if (st.fragments[f].active) {
+                st.fragments[f].position += st.fragments[f].velocity;
                 
                 // Gravity - now with visible effect
-                fragments[f].velocity -= gravityForce;
+                st.fragments[f].velocity -= gravityForce;
                 
                 // Fading
-                fragments[f].brightness = qsub8(fragments[f].brightness, 8);
+                st.fragments[f].brightness = qsub8(st.fragments[f].brightness, 8);
                 
                 // Deactivation
-                if (fragments[f].brightness < 10 || 
-                    fragments[f].position < 0 || 
-                    fragments[f].position >= NUM_LEDS * 10) {
-                    fragments[f].active = false;
+                if (st.fragments[f].brightness < 10 || 
+                    st.fragments[f].position < 0 || 
+                    st.fragments[f].position >= NUM_LEDS * 10) {
+                    st.fragments[f].active = false;
                 }
             }
         }
-        
-        lastUpdate = millis();
     }
     
     // Render
-    if (!fireworksParams.overlay) {
-        fadeAll(50);  // Normal fading
-    } else {
-        fadeAll(10);  // Gentle fading in overlay mode to prevent saturation
-    }
+    fadeAll(frameFade(50));
     
     for (uint8_t f = 0; f < 32; f++) {
-        if (fragments[f].active) {
-            int16_t ledPos = fragments[f].position / 10;
+        if (st.fragments[f].active) {
+            int32_t ledPos = st.fragments[f].position / 10;
             if (ledPos >= 0 && ledPos < NUM_LEDS) {
-                CRGB col = fragments[f].color;
-                col.nscale8(fragments[f].brightness);
+                CRGB col = st.fragments[f].color;
+                col.nscale8(st.fragments[f].brightness);
                 // Use blend instead of += to avoid cumulation to white
                 leds[ledPos] = blend(leds[ledPos], col, 180);
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectSnowSparkle() {
-    static uint8_t snowBrightness[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastSpawn = 0;
+struct SnowSparkleState {
+    uint8_t* snowBrightness = allocEffectBuffer<uint8_t>();
+    uint32_t lastUpdate = 0;
+    uint32_t lastSpawn = 0;
+    
+    ~SnowSparkleState() {
+        freePixelBuffer(snowBrightness);
+    }
+};
+
+uint32_t effectSnowSparkle(SnowSparkleState& st) {
+    if (!st.snowBrightness) return EFFECT_NEXT_FRAME;
     
     uint16_t moveDelayMs = map(snowSparkleParams.speed, 0, 255, 80, 15);  // Movement speed
     uint16_t spawnDelayMs = map(snowSparkleParams.density, 0, 255, 500, 30);  // Frequency of new flakes
@@ -1319,53 +1410,52 @@ void effectSnowSparkle() {
         // Falling mode
         
         // Move flakes downward
-        if (millis() - lastUpdate > moveDelayMs) {
+        for (uint16_t s = intervalSteps(st.lastUpdate, moveDelayMs); s > 0; s--) {
             for (int16_t i = NUM_LEDS - 1; i > 0; i--) {
-                snowBrightness[i] = snowBrightness[i - 1];
+                st.snowBrightness[i] = st.snowBrightness[i - 1];
             }
-            snowBrightness[0] = 0;  // Clear top
-            lastUpdate = millis();
+            st.snowBrightness[0] = 0;  // Clear top
         }
         
         // Add new flakes at top
-        if (millis() - lastSpawn > spawnDelayMs) {
+        if (millis() - st.lastSpawn > spawnDelayMs) {
             // Add flake in random position near top (0-2)
             uint8_t startPos = random8(3);
             if (startPos < NUM_LEDS) {
-                snowBrightness[startPos] = 255;
+                st.snowBrightness[startPos] = 255;
             }
-            lastSpawn = millis();
+            st.lastSpawn = millis();
         }
         
     } else {
         // Random mode
-        if (millis() - lastUpdate > moveDelayMs) {
+        for (uint16_t n = intervalSteps(st.lastUpdate, moveDelayMs); n > 0; n--) {
             // New random flakes - add several at once depending on density
             uint8_t numSpawns = map(snowSparkleParams.density, 0, 255, 1, 5);
             for (uint8_t s = 0; s < numSpawns; s++) {
                 if (random8() < 120) {  // High chance
-                    snowBrightness[random16(NUM_LEDS)] = 255;
+                    st.snowBrightness[random16(NUM_LEDS)] = 255;
                 }
             }
             
             // Fade out in random mode - slower fade
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                snowBrightness[i] = qsub8(snowBrightness[i], 8);
+                st.snowBrightness[i] = qsub8(st.snowBrightness[i], 8);
             }
-            
-            lastUpdate = millis();
         }
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (snowBrightness[i] > 0) {
+        if (st.snowBrightness[i] > 0) {
             CRGB col = snowSparkleParams.color;
-            col.nscale8(snowBrightness[i]);
+            col.nscale8(st.snowBrightness[i]);
             leds[i] = col;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
@@ -1380,63 +1470,63 @@ struct Ball {
     CRGB color;
 };
 
-static Ball balls[8];
+struct BouncingBallsState {
+    Ball balls[8];
+    bool initialized = false;
+    uint32_t lastUpdate = 0;
+    uint8_t lastNumBalls = 0;
+};
 
-void effectBouncingBalls() {
-    static bool initialized = false;
-    static uint32_t lastUpdate = 0;
-    static uint8_t lastNumBalls = 0;
-    
-    CRGBPalette16 pal = getPalette(bouncingBallsParams.palette);
+uint32_t effectBouncingBalls(BouncingBallsState& st) {
+    const CRGB* pal = getPaletteLUT(bouncingBallsParams.palette);
     
     // Reinitialize when number of balls changes or on first run
-    if (!initialized || lastNumBalls != bouncingBallsParams.numBalls) {
+    if (!st.initialized || st.lastNumBalls != bouncingBallsParams.numBalls) {
         for (uint8_t i = 0; i < 8; i++) {
             // Distribute balls at different starting positions
-            balls[i].position = (i * NUM_LEDS / 8);
-            balls[i].velocity = 0;
-            balls[i].height = random8(NUM_LEDS / 2, NUM_LEDS);
+            st.balls[i].position = (i * NUM_LEDS / 8);
+            st.balls[i].velocity = 0;
+            st.balls[i].height = random16(NUM_LEDS / 2, NUM_LEDS);
         }
-        lastNumBalls = bouncingBallsParams.numBalls;
-        initialized = true;
+        st.lastNumBalls = bouncingBallsParams.numBalls;
+        st.initialized = true;
     }
     
     float gravity = (float)bouncingBallsParams.gravity / 5000.0;
     float damping = 0.9;
     
-    if (millis() - lastUpdate > 15) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, 15); s > 0; s--) {
         for (uint8_t i = 0; i < bouncingBallsParams.numBalls && i < 8; i++) {
-            balls[i].velocity += gravity;
-            balls[i].position += balls[i].velocity;
+            st.balls[i].velocity += gravity;
+            st.balls[i].position += st.balls[i].velocity;
             
             // Bounce from bottom
-            if (balls[i].position >= NUM_LEDS - 1) {
-                balls[i].position = NUM_LEDS - 1;
-                balls[i].velocity = -balls[i].velocity * damping;
+            if (st.balls[i].position >= NUM_LEDS - 1) {
+                st.balls[i].position = NUM_LEDS - 1;
+                st.balls[i].velocity = -st.balls[i].velocity * damping;
                 
                 // Reset if too slow
-                if (abs(balls[i].velocity) < 0.5) {
-                    balls[i].position = 0;
-                    balls[i].velocity = 0;
+                if (abs(st.balls[i].velocity) < 0.5) {
+                    st.balls[i].position = 0;
+                    st.balls[i].velocity = 0;
                 }
             }
             
             // Bounce from top
-            if (balls[i].position < 0) {
-                balls[i].position = 0;
-                balls[i].velocity = -balls[i].velocity * damping;
+            if (st.balls[i].position < 0) {
+                st.balls[i].position = 0;
+                st.balls[i].velocity = -st.balls[i].velocity * damping;
             }
         }
-        lastUpdate = millis();
     }
     
     // Render - use only trail to control fading
-    fadeAll(bouncingBallsParams.trail > 0 ? 50 : 255);
+    fadeAll(bouncingBallsParams.trail > 0 ? frameFade(50) : 255);
     
     for (uint8_t i = 0; i < bouncingBallsParams.numBalls && i < 8; i++) {
-        int16_t pos = (int16_t)balls[i].position;
+        int16_t pos = (int16_t)st.balls[i].position;
         // Get color from palette dynamically - responds to palette change
-        CRGB ballColor = ColorFromPalette(pal, i * 32, 255, LINEARBLEND);
+        CRGB ballColor = pal[i * 32];
         
         if (pos >= 0 && pos < NUM_LEDS) {
             leds[pos] = ballColor;
@@ -1444,7 +1534,7 @@ void effectBouncingBalls() {
             // Trail
             if (bouncingBallsParams.trail > 0) {
                 for (uint8_t t = 1; t <= bouncingBallsParams.trail; t++) {
-                    int16_t trailPos = pos - (balls[i].velocity > 0 ? t : -t);
+                    int16_t trailPos = pos - (st.balls[i].velocity > 0 ? t : -t);
                     if (trailPos >= 0 && trailPos < NUM_LEDS) {
                         CRGB col = ballColor;
                         col.nscale8(255 - t * (255 / bouncingBallsParams.trail));
@@ -1455,6 +1545,8 @@ void effectBouncingBalls() {
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 struct PopcornKernel {
@@ -1464,13 +1556,14 @@ struct PopcornKernel {
     bool active;
 };
 
-static PopcornKernel kernels[20];
+struct PopcornState {
+    PopcornKernel kernels[20];
+    uint32_t lastUpdate = 0;
+    uint32_t lastPop = 0;
+};
 
-void effectPopcorn() {
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastPop = 0;
-    
-    CRGBPalette16 pal = getPalette(popcornParams.palette);
+uint32_t effectPopcorn(PopcornState& st) {
+    const CRGB* pal = getPaletteLUT(popcornParams.palette);
     
     // Speed controls physics update tempo
     uint16_t updateDelay = map(popcornParams.speed, 0, 255, 40, 10);
@@ -1478,67 +1571,68 @@ void effectPopcorn() {
     uint16_t popDelay = map(popcornParams.intensity, 0, 255, 800, 50);
     
     // Adding new kernels
-    if (millis() - lastPop > popDelay) {
+    if (millis() - st.lastPop > popDelay) {
         for (uint8_t k = 0; k < 20; k++) {
-            if (!kernels[k].active) {
-                kernels[k].active = true;
+            if (!st.kernels[k].active) {
+                st.kernels[k].active = true;
                 // Kernels start from random position near bottom (simulating pan frying)
-                kernels[k].position = random8(5);
+                st.kernels[k].position = random8(5);
                 // Different jump heights - most small/medium, but sometimes "super" jump
                 if (random8() < 20) {
                     // ~8% chance for super jump - flies to the very top
-                    kernels[k].velocity = (float)random8(90, 120) / 10.0;  // 9.0 - 12.0
+                    st.kernels[k].velocity = (float)random8(90, 120) / 10.0;  // 9.0 - 12.0
                 } else {
                     // Normal jump
-                    kernels[k].velocity = (float)random8(20, 80) / 10.0;   // 2.0 - 8.0
+                    st.kernels[k].velocity = (float)random8(20, 80) / 10.0;   // 2.0 - 8.0
                 }
                 // Dynamic color from palette
-                kernels[k].color = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
+                st.kernels[k].color = pal[random8()];
                 break;
             }
         }
-        lastPop = millis();
+        st.lastPop = millis();
     }
     
     // Physics update
-    if (millis() - lastUpdate > updateDelay) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, updateDelay); s > 0; s--) {
         for (uint8_t k = 0; k < 20; k++) {
-            if (kernels[k].active) {
+            if (st.kernels[k].active) {
                 // Gravity
-                kernels[k].velocity -= 0.25;
-                kernels[k].position += kernels[k].velocity;
+                st.kernels[k].velocity -= 0.25;
+                st.kernels[k].position += st.kernels[k].velocity;
                 
                 // Bounce from ground with damping (simulating bouncing)
-                if (kernels[k].position < 0) {
-                    kernels[k].position = 0;
-                    kernels[k].velocity = -kernels[k].velocity * 0.6;  // Bounce with energy loss
+                if (st.kernels[k].position < 0) {
+                    st.kernels[k].position = 0;
+                    st.kernels[k].velocity = -st.kernels[k].velocity * 0.6;  // Bounce with energy loss
                     
                     // Deactivate if too little energy
-                    if (abs(kernels[k].velocity) < 0.3) {
-                        kernels[k].active = false;
+                    if (abs(st.kernels[k].velocity) < 0.3) {
+                        st.kernels[k].active = false;
                     }
                 }
                 
                 // Deactivate if flew too high
-                if (kernels[k].position >= NUM_LEDS) {
-                    kernels[k].active = false;
+                if (st.kernels[k].position >= NUM_LEDS) {
+                    st.kernels[k].active = false;
                 }
             }
         }
-        lastUpdate = millis();
     }
     
     // Render
-    fadeAll(80);
+    fadeAll(frameFade(80));
     
     for (uint8_t k = 0; k < 20; k++) {
-        if (kernels[k].active) {
-            int16_t pos = (int16_t)kernels[k].position;
+        if (st.kernels[k].active) {
+            int16_t pos = (int16_t)st.kernels[k].position;
             if (pos >= 0 && pos < NUM_LEDS) {
-                leds[pos] = kernels[k].color;
+                leds[pos] = st.kernels[k].color;
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 struct Drip {
@@ -1547,27 +1641,28 @@ struct Drip {
     bool active;
 };
 
-static Drip drips[8];
+struct DripState {
+    Drip drips[8];
+    uint32_t lastUpdate = 0;
+    uint8_t dripState[8] = {0};      // 0=ready, 1=falling, 2=splashing
+    uint8_t splashBrightness[8] = {0};
+    uint32_t nextDripTime = 0;
+};
 
-void effectDrip() {
-    static uint32_t lastUpdate = 0;
-    static uint8_t dripState[8] = {0};      // 0=ready, 1=falling, 2=splashing
-    static uint8_t splashBrightness[8] = {0};
-    static uint32_t nextDripTime = 0;
-    
+uint32_t effectDrip(DripState& st) {
     float gravity = (float)dripParams.gravity / 2500.0;
     
-    if (millis() - lastUpdate > 20) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, 20); s > 0; s--) {
         // Try to add new drip - only if time has passed
-        if (millis() > nextDripTime) {
+        if (millis() > st.nextDripTime) {
             for (uint8_t d = 0; d < dripParams.numDrips && d < 8; d++) {
-                if (dripState[d] == 0) {  // Ready for new drip
-                    dripState[d] = 1;
-                    drips[d].active = true;
-                    drips[d].position = 0;
-                    drips[d].velocity = 0.2;
+                if (st.dripState[d] == 0) {  // Ready for new drip
+                    st.dripState[d] = 1;
+                    st.drips[d].active = true;
+                    st.drips[d].position = 0;
+                    st.drips[d].velocity = 0.2;
                     // Next drip after 800-1500ms
-                    nextDripTime = millis() + 800 + random16(700);
+                    st.nextDripTime = millis() + 800 + random16(700);
                     break;
                 }
             }
@@ -1575,47 +1670,41 @@ void effectDrip() {
         
         // Update all drips
         for (uint8_t d = 0; d < 8; d++) {
-            if (dripState[d] == 1) {
+            if (st.dripState[d] == 1) {
                 // Falling
-                drips[d].velocity += gravity;
-                drips[d].position += drips[d].velocity;
+                st.drips[d].velocity += gravity;
+                st.drips[d].position += st.drips[d].velocity;
                 
                 // Reached bottom - splash!
-                if (drips[d].position >= NUM_LEDS - 1) {
-                    dripState[d] = 2;
-                    splashBrightness[d] = 255;
-                    drips[d].active = false;
+                if (st.drips[d].position >= NUM_LEDS - 1) {
+                    st.dripState[d] = 2;
+                    st.splashBrightness[d] = 255;
+                    st.drips[d].active = false;
                 }
-            } else if (dripState[d] == 2) {
+            } else if (st.dripState[d] == 2) {
                 // Splash fades
-                splashBrightness[d] = qsub8(splashBrightness[d], 12);
-                if (splashBrightness[d] < 5) {
-                    dripState[d] = 0;  // Ready for next drip
+                st.splashBrightness[d] = qsub8(st.splashBrightness[d], 12);
+                if (st.splashBrightness[d] < 5) {
+                    st.dripState[d] = 0;  // Ready for next drip
                 }
             }
         }
-        
-        lastUpdate = millis();
     }
     
     // Render
-    if (!dripParams.overlay) {
-        fadeAll(30);
-    } else {
-        fadeAll(10);
-    }
+    fadeAll(frameFade(30));
     
     for (uint8_t d = 0; d < 8; d++) {
-        if (dripState[d] == 1 && drips[d].active) {
+        if (st.dripState[d] == 1 && st.drips[d].active) {
             // Falling drip
-            int16_t pos = (int16_t)drips[d].position;
+            int16_t pos = (int16_t)st.drips[d].position;
             
             if (pos >= 0 && pos < NUM_LEDS) {
                 leds[pos] = dripParams.color;
             }
             
             // Tail
-            uint8_t tailLen = constrain((int)(drips[d].velocity * 1.5), 1, 6);
+            uint8_t tailLen = constrain((int)(st.drips[d].velocity * 1.5), 1, 6);
             for (uint8_t t = 1; t <= tailLen; t++) {
                 int16_t tailPos = pos - t;
                 if (tailPos >= 0 && tailPos < NUM_LEDS) {
@@ -1624,10 +1713,10 @@ void effectDrip() {
                     leds[tailPos] = col;
                 }
             }
-        } else if (dripState[d] == 2) {
+        } else if (st.dripState[d] == 2) {
             // Splash at bottom
             CRGB splashCol = dripParams.color;
-            splashCol.nscale8(splashBrightness[d]);
+            splashCol.nscale8(st.splashBrightness[d]);
             
             // Main impact point
             leds[NUM_LEDS - 1] = splashCol;
@@ -1637,72 +1726,76 @@ void effectDrip() {
                 int16_t splashPos = NUM_LEDS - 1 - s;
                 if (splashPos >= 0) {
                     CRGB col = dripParams.color;
-                    col.nscale8(splashBrightness[d] * (9 - s) / 9);
-                    leds[splashPos] = blend(leds[splashPos], col, splashBrightness[d]);
+                    col.nscale8(st.splashBrightness[d] * (9 - s) / 9);
+                    leds[splashPos] = blend(leds[splashPos], col, st.splashBrightness[d]);
                 }
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectPlasma() {
-    static uint16_t phase1 = 0;
-    static uint16_t phase2 = 0;
+struct PlasmaState {
+    uint16_t phase1 = 0;
+    uint16_t phase2 = 0;
+    uint32_t carry1 = 0;
+    uint32_t carry2 = 0;
+};
+
+uint32_t effectPlasma(PlasmaState& st) {
+    st.phase1 += frameStep(map(plasmaParams.speed, 0, 255, 2, 15), st.carry1);
+    st.phase2 += frameStep(map(plasmaParams.speed, 0, 255, 3, 20), st.carry2);
     
     // Intensity controls wave scale (1-20)
     uint8_t waveScale = map(plasmaParams.intensity, 0, 255, 3, 20);
+    const CRGB* rainbow = getRainbowLUT();
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint8_t sin1 = sin8(i * waveScale + phase1);
-        uint8_t sin2 = sin8(i * (waveScale + 5) - phase2);
-        uint8_t sin3 = sin8(i * (waveScale / 2) + phase1 / 2);
+        uint8_t sin1 = sin8(i * waveScale + st.phase1);
+        uint8_t sin2 = sin8(i * (waveScale + 5) - st.phase2);
+        uint8_t sin3 = sin8(i * (waveScale / 2) + st.phase1 / 2);
         
         uint8_t colorIndex = (sin1 + sin2 + sin3) / 3;
         
-        leds[i] = CHSV(colorIndex + plasmaParams.phase, 255, 255);
+        leds[i] = rainbow[(uint8_t)(colorIndex + plasmaParams.phase)];
     }
     
-    phase1 += map(plasmaParams.speed, 0, 255, 2, 15);
-    phase2 += map(plasmaParams.speed, 0, 255, 3, 20);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectLightning() {
-    static uint32_t lastFlash = 0;
-    static uint8_t flashState = 0;
-    static uint8_t flashCount = 0;
-    static int16_t flashStart = 0;
-    static int16_t flashLen = 0;
-    
-    // Frequency mapped: 0=rarely, 255=often
+struct LightningState {
+    uint32_t lastFlash = 0;
+    uint8_t flashState = 0;
+    uint8_t flashCount = 0;
+    int16_t flashStart = 0;
+    int16_t flashLen = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectLightning(LightningState& st) {
+    // Frequency mapped: 0=rarely, 255=often (chance per nominal frame)
     uint8_t flashChance = map(lightningParams.frequency, 0, 255, 3, 80);
+    bool nominalFrame = frameTicks(st.carry) > 0;
     
     // New flash
-    if (flashState == 0 && random8() < flashChance) {
-        flashState = 1;
-        flashCount = random8(2, 5);  // 2-4 flashes in series
-        flashStart = random8(NUM_LEDS / 4, NUM_LEDS * 3 / 4);  // Middle section
-        flashLen = random8(8, 25);
+    if (st.flashState == 0 && nominalFrame && random8() < flashChance) {
+        st.flashState = 1;
+        st.flashCount = random8(2, 5);  // 2-4 flashes in series
+        st.flashStart = random16(NUM_LEDS / 4, NUM_LEDS * 3 / 4);  // Middle section
+        st.flashLen = random8(8, 25);
     }
     
     // Stormy background
     CRGB bgColor = CRGB(20, 20, 50);  // Dark navy (survives low brightness)
     
-    if (lightningParams.overlay) {
-        // Overlay - fade first, then gently add background
-        fadeAll(25);
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            leds[i] = blend(leds[i], bgColor, 30);  // Gentle blend with background
-        }
-    } else {
-        // Normal mode - full background
-        fill_solid(leds, NUM_LEDS, bgColor);
-    }
+    fill_solid(leds, NUM_LEDS, bgColor);
     
     // Flash handling
-    if (flashState > 0) {
-        if (flashState == 1) {
+    if (st.flashState > 0) {
+        if (st.flashState == 1) {
             // FLASH! - white core
-            for (int16_t i = flashStart; i < flashStart + flashLen && i < NUM_LEDS; i++) {
+            for (int16_t i = st.flashStart; i < st.flashStart + st.flashLen && i < NUM_LEDS; i++) {
                 if (i >= 0) {
                     CRGB core = CRGB::White;
                     core.nscale8(lightningParams.intensity);
@@ -1712,8 +1805,8 @@ void effectLightning() {
             
             // Colored glow on edges
             for (uint8_t edge = 1; edge <= 4; edge++) {
-                int16_t leftPos = flashStart - edge;
-                int16_t rightPos = flashStart + flashLen - 1 + edge;
+                int16_t leftPos = st.flashStart - edge;
+                int16_t rightPos = st.flashStart + st.flashLen - 1 + edge;
                 CRGB glow = lightningParams.color;
                 glow.nscale8(lightningParams.intensity / (edge + 1));
                 
@@ -1723,26 +1816,28 @@ void effectLightning() {
             
             // Random branches
             for (uint8_t b = 0; b < 2; b++) {
-                int16_t branchPos = flashStart + random8(flashLen + 4) - 2;
+                int16_t branchPos = st.flashStart + random8(st.flashLen + 4) - 2;
                 if (branchPos >= 0 && branchPos < NUM_LEDS) {
                     leds[branchPos] = lightningParams.color;
                 }
             }
             
-            flashState = 2;
-            lastFlash = millis();
-        } else if (flashState == 2 && millis() - lastFlash > 40 + random8(60)) {
+            st.flashState = 2;
+            st.lastFlash = millis();
+        } else if (st.flashState == 2 && millis() - st.lastFlash > 40 + random8(60)) {
             // Pause between flashes
-            flashCount--;
-            if (flashCount > 0) {
-                flashState = 1;
-                flashStart += random8(5) - 2;
-                flashLen = random8(6, 18);
+            st.flashCount--;
+            if (st.flashCount > 0) {
+                st.flashState = 1;
+                st.flashStart += random8(5) - 2;
+                st.flashLen = random8(6, 18);
             } else {
-                flashState = 0;
+                st.flashState = 0;
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 struct MatrixDrop {
@@ -1751,27 +1846,28 @@ struct MatrixDrop {
     bool active;
 };
 
-static MatrixDrop matrixDrops[20];
+struct MatrixState {
+    MatrixDrop matrixDrops[20];
+    uint32_t lastUpdate = 0;
+};
 
-void effectMatrix() {
-    static uint32_t lastUpdate = 0;
-    
+uint32_t effectMatrix(MatrixState& st) {
     // Always use color from parameters
     CRGB dropColor = matrixParams.color;
     
     uint16_t delayMs = map(matrixParams.speed, 0, 255, 80, 15);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint16_t s = intervalSteps(st.lastUpdate, delayMs); s > 0; s--) {
         // spawningRate - minimum 10 to always have drops
         uint8_t spawnChance = max((uint8_t)10, matrixParams.spawningRate);
         
         // New drops
         if (random8() < spawnChance) {
             for (uint8_t d = 0; d < 20; d++) {
-                if (!matrixDrops[d].active) {
-                    matrixDrops[d].active = true;
-                    matrixDrops[d].position = 0;
-                    matrixDrops[d].speed = random8(1, 3);
+                if (!st.matrixDrops[d].active) {
+                    st.matrixDrops[d].active = true;
+                    st.matrixDrops[d].position = 0;
+                    st.matrixDrops[d].speed = random8(1, 3);
                     break;
                 }
             }
@@ -1779,24 +1875,22 @@ void effectMatrix() {
         
         // Update drops
         for (uint8_t d = 0; d < 20; d++) {
-            if (matrixDrops[d].active) {
-                matrixDrops[d].position += matrixDrops[d].speed;
+            if (st.matrixDrops[d].active) {
+                st.matrixDrops[d].position += st.matrixDrops[d].speed;
                 
-                if (matrixDrops[d].position >= NUM_LEDS + matrixParams.trailLength) {
-                    matrixDrops[d].active = false;
+                if (st.matrixDrops[d].position >= NUM_LEDS + matrixParams.trailLength) {
+                    st.matrixDrops[d].active = false;
                 }
             }
         }
-        
-        lastUpdate = millis();
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     
     for (uint8_t d = 0; d < 20; d++) {
-        if (matrixDrops[d].active) {
-            int16_t headPos = matrixDrops[d].position;
+        if (st.matrixDrops[d].active) {
+            int16_t headPos = st.matrixDrops[d].position;
             
             // Head of drop (white/bright)
             if (headPos >= 0 && headPos < NUM_LEDS) {
@@ -1817,73 +1911,86 @@ void effectMatrix() {
             }
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectHeartbeat() {
-    static uint32_t lastBeat = 0;
-    static uint8_t beatPhase = 0;  // 0=pause, 1=first, 2=pause2, 3=second
-    static uint8_t brightness = 0;
-    
+struct HeartbeatState {
+    uint32_t lastBeat = 0;
+    uint8_t beatPhase = 0;  // 0=pause, 1=first, 2=pause2, 3=second
+    uint8_t brightness = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectHeartbeat(HeartbeatState& st) {
     uint32_t beatInterval = 60000 / heartbeatParams.bpm;
+    uint8_t frames = min(frameTicks(st.carry), (uint32_t)8);  // Decay steps are per nominal frame
     uint32_t now = millis();
     
     // Simulation of double heartbeat
-    switch (beatPhase) {
+    switch (st.beatPhase) {
         case 0:  // Pause before first beat
-            if (now - lastBeat > beatInterval) {
-                beatPhase = 1;
-                lastBeat = now;
+            if (now - st.lastBeat > beatInterval) {
+                st.beatPhase = 1;
+                st.lastBeat = now;
             }
-            brightness = qsub8(brightness, 10);
+            st.brightness = qsub8(st.brightness, 10 * frames);
             break;
             
         case 1:  // First beat (stronger)
-            if (now - lastBeat < 80) {
-                brightness = 255;  // Maximum brightness
+            if (now - st.lastBeat < 80) {
+                st.brightness = 255;  // Maximum brightness
             } else {
-                beatPhase = 2;
-                lastBeat = now;
+                st.beatPhase = 2;
+                st.lastBeat = now;
             }
             break;
             
         case 2:  // Short pause
-            brightness = qsub8(brightness, 30);
-            if (now - lastBeat > 100) {
-                beatPhase = 3;
-                lastBeat = now;
+            st.brightness = qsub8(st.brightness, 30 * frames);
+            if (now - st.lastBeat > 100) {
+                st.beatPhase = 3;
+                st.lastBeat = now;
             }
             break;
             
         case 3:  // Second beat (weaker)
-            if (now - lastBeat < 60) {
-                brightness = 192;  // 75% brightness
+            if (now - st.lastBeat < 60) {
+                st.brightness = 192;  // 75% brightness
             } else {
-                beatPhase = 0;
-                lastBeat = now;
+                st.beatPhase = 0;
+                st.lastBeat = now;
             }
             break;
     }
     
     // Fade outside beats
-    if (beatPhase == 0 || beatPhase == 2) {
-        brightness = qsub8(brightness, 15);
+    if (st.beatPhase == 0 || st.beatPhase == 2) {
+        st.brightness = qsub8(st.brightness, 15 * frames);
     }
     
     // Render
     CRGB col = heartbeatParams.color;
-    col.nscale8(brightness);
+    col.nscale8(st.brightness);
     fill_solid(leds, NUM_LEDS, col);
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 8: BREATHING/FADE EFFECTS
 // ============================================================================
 
-void effectBreathe() {
-    static uint16_t phase = 0;
+struct BreatheState {
+    uint16_t phase = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectBreathe(BreatheState& st) {
+    st.phase += frameStep(map(breatheParams.speed, 0, 255, 1, 8), st.carry);
     
     // Sinusoidal breathing
-    uint8_t breath = sin8(phase);
+    uint8_t breath = sin8(st.phase);
     
     CRGB col;
     if (breatheParams.twoColor) {
@@ -1895,84 +2002,96 @@ void effectBreathe() {
     
     fill_solid(leds, NUM_LEDS, col);
     
-    phase += map(breatheParams.speed, 0, 255, 1, 8);
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectDissolve() {
-    static uint8_t pixelState[NUM_LEDS];  // 0=off, 1=on
-    static uint8_t dissolvePhase = 0;      // 0=filling, 1=dissolving
-    static uint16_t activeCount = 0;
-    static uint32_t lastStep = 0;
-    static CRGB currentColor;
+struct DissolveState {
+    uint8_t* pixelState = allocEffectBuffer<uint8_t>();  // 0=off, 1=on
+    uint8_t dissolvePhase = 0;      // 0=filling, 1=dissolving
+    uint16_t activeCount = 0;
+    uint32_t lastStep = 0;
+    CRGB currentColor;
+    
+    ~DissolveState() {
+        freePixelBuffer(pixelState);
+    }
+};
+
+uint32_t effectDissolve(DissolveState& st) {
+    if (!st.pixelState) return EFFECT_NEXT_FRAME;
     
     uint16_t delayMs = map(dissolveParams.repeatSpeed, 0, 255, 50, 10);
     
-    if (millis() - lastStep > delayMs) {
-        if (dissolvePhase == 0) {
+    for (uint16_t s = intervalSteps(st.lastStep, delayMs); s > 0; s--) {
+        if (st.dissolvePhase == 0) {
             // Filling phase
             uint8_t toFill = map(dissolveParams.dissolveSpeed, 0, 255, 1, 5);
-            for (uint8_t f = 0; f < toFill && activeCount < NUM_LEDS; f++) {
+            for (uint8_t f = 0; f < toFill && st.activeCount < NUM_LEDS; f++) {
                 // Find random unfilled pixel
                 uint16_t attempts = 0;
                 while (attempts < 50) {
                     uint16_t idx = random16(NUM_LEDS);
-                    if (pixelState[idx] == 0) {
-                        pixelState[idx] = 1;
-                        activeCount++;
+                    if (st.pixelState[idx] == 0) {
+                        st.pixelState[idx] = 1;
+                        st.activeCount++;
                         break;
                     }
                     attempts++;
                 }
             }
             
-            if (activeCount >= NUM_LEDS) {
-                dissolvePhase = 1;
+            if (st.activeCount >= NUM_LEDS) {
+                st.dissolvePhase = 1;
             }
         } else {
             // Dissolving phase
             uint8_t toDissolve = map(dissolveParams.dissolveSpeed, 0, 255, 1, 5);
-            for (uint8_t d = 0; d < toDissolve && activeCount > 0; d++) {
+            for (uint8_t d = 0; d < toDissolve && st.activeCount > 0; d++) {
                 uint16_t attempts = 0;
                 while (attempts < 50) {
                     uint16_t idx = random16(NUM_LEDS);
-                    if (pixelState[idx] == 1) {
-                        pixelState[idx] = 0;
-                        activeCount--;
+                    if (st.pixelState[idx] == 1) {
+                        st.pixelState[idx] = 0;
+                        st.activeCount--;
                         break;
                     }
                     attempts++;
                 }
             }
             
-            if (activeCount == 0) {
-                dissolvePhase = 0;
+            if (st.activeCount == 0) {
+                st.dissolvePhase = 0;
                 if (dissolveParams.randomColors) {
-                    currentColor = CHSV(random8(), 255, 255);
+                    st.currentColor = CHSV(random8(), 255, 255);
                 } else {
-                    currentColor = dissolveParams.color;
+                    st.currentColor = dissolveParams.color;
                 }
             }
         }
-        
-        lastStep = millis();
     }
     
     // Render
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (pixelState[i]) {
-            leds[i] = currentColor;
+        if (st.pixelState[i]) {
+            leds[i] = st.currentColor;
         } else {
             leds[i] = CRGB::Black;
         }
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectFade() {
-    static uint16_t phase = 0;
-    static uint8_t currentColor = 0;
+struct FadeState {
+    uint16_t phase = 0;
+    uint8_t currentColor = 0;
+    uint32_t carry = 0;
+};
+
+uint32_t effectFade(FadeState& st) {
+    st.phase += frameStep(map(fadeParams.speed, 0, 255, 1, 8), st.carry);
     
-    uint8_t blendAmount = phase & 0xFF;
-    uint8_t nextColor = currentColor + 1;
+    uint8_t nextColor = st.currentColor + 1;
     bool isLastToFirst = false;
     
     // Check if we're transitioning from last to first
@@ -1981,97 +2100,111 @@ void effectFade() {
         isLastToFirst = true;
     }
     
+    if (st.phase >= 256) {
+        st.phase -= 256;
+        st.currentColor = nextColor;
+        nextColor = st.currentColor + 1;
+        isLastToFirst = false;
+        if (nextColor >= fadeParams.numColors) {
+            nextColor = 0;
+            isLastToFirst = true;
+        }
+    }
+    
+    uint8_t blendAmount = st.phase & 0xFF;
+    
     CRGB col;
     
     // If loop is off and we're going from last to first, don't blend - just show current color
     if (!fadeParams.loop && isLastToFirst) {
-        col = fadeParams.colors[currentColor];
+        col = fadeParams.colors[st.currentColor];
     } else {
-        col = blend(fadeParams.colors[currentColor], 
+        col = blend(fadeParams.colors[st.currentColor], 
                     fadeParams.colors[nextColor], 
                     blendAmount);
     }
     
     fill_solid(leds, NUM_LEDS, col);
     
-    phase += map(fadeParams.speed, 0, 255, 1, 8);
-    
-    if (phase >= 256) {
-        phase = 0;
-        currentColor = nextColor;
-    }
+    return EFFECT_NEXT_FRAME;
 }
 
 // ============================================================================
 // CATEGORY 9: ALARM EFFECTS
 // ============================================================================
 
-void effectPolice() {
-    static uint32_t lastSwitch = 0;
-    static bool side = false;
-    static uint8_t flashCount = 0;
-    
+struct PoliceState {
+    uint32_t lastSwitch = 0;
+    bool side = false;
+    uint8_t flashCount = 0;
+};
+
+uint32_t effectPolice(PoliceState& st) {
     uint16_t flashInterval = map(policeLightsParams.speed, 0, 255, 150, 30);
     
-    if (millis() - lastSwitch > flashInterval) {
-        flashCount++;
-        if (flashCount >= 3) {
-            flashCount = 0;
-            side = !side;
+    if (millis() - st.lastSwitch > flashInterval) {
+        st.flashCount++;
+        if (st.flashCount >= 3) {
+            st.flashCount = 0;
+            st.side = !st.side;
         }
-        lastSwitch = millis();
+        st.lastSwitch = millis();
     }
     
     switch (policeLightsParams.style) {
         case POLICE_SINGLE:
-            fill_solid(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
+            fill_solid(leds, NUM_LEDS, st.side ? policeLightsParams.color1 : policeLightsParams.color2);
             break;
             
         case POLICE_SOLID:
-            if (flashCount % 2 == 0) {
-                fill_solid(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
+            if (st.flashCount % 2 == 0) {
+                fill_solid(leds, NUM_LEDS, st.side ? policeLightsParams.color1 : policeLightsParams.color2);
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
             
         case POLICE_ALTERNATING:
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
                 if (i < NUM_LEDS / 2) {
-                    leds[i] = side ? policeLightsParams.color1 : CRGB::Black;
+                    leds[i] = st.side ? policeLightsParams.color1 : CRGB::Black;
                 } else {
-                    leds[i] = side ? CRGB::Black : policeLightsParams.color2;
+                    leds[i] = st.side ? CRGB::Black : policeLightsParams.color2;
                 }
             }
             // Flash effect
-            if (flashCount % 2 == 1) {
+            if (st.flashCount % 2 == 1) {
                 for (uint16_t i = 0; i < NUM_LEDS; i++) {
                     leds[i].nscale8(50);
                 }
             }
             break;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
-void effectStrobe() {
-    static uint32_t lastFlash = 0;
-    static bool on = false;
-    static uint8_t hue = 0;
-    static uint8_t megaFlashCount = 0;
-    
+struct StrobeState {
+    uint32_t lastFlash = 0;
+    bool on = false;
+    uint8_t hue = 0;
+    uint8_t megaFlashCount = 0;
+};
+
+uint32_t effectStrobe(StrobeState& st) {
     uint16_t interval = map(strobeParams.frequency, 0, 255, 200, 20);
     
     switch (strobeParams.mode) {
         case STROBE_NORMAL:
             // Single flash with chosen color
-            if (millis() - lastFlash > (on ? 30 : interval)) {
-                on = !on;
-                lastFlash = millis();
+            if (millis() - st.lastFlash > (st.on ? 30 : interval)) {
+                st.on = !st.on;
+                st.lastFlash = millis();
             }
-            if (on) {
+            if (st.on) {
                 fill_solid(leds, NUM_LEDS, strobeParams.color);
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
             
@@ -2079,44 +2212,46 @@ void effectStrobe() {
             // Rapid triple flashes - first 2 in color, 3rd in white
             {
                 uint16_t megaInterval = interval / 2; // 2x faster base
-                if (millis() - lastFlash > (on ? 15 : megaInterval)) {
-                    on = !on;
-                    lastFlash = millis();
-                    if (!on) {
-                        megaFlashCount++;
-                        if (megaFlashCount >= 3) {
-                            megaFlashCount = 0;
+                if (millis() - st.lastFlash > (st.on ? 15 : megaInterval)) {
+                    st.on = !st.on;
+                    st.lastFlash = millis();
+                    if (!st.on) {
+                        st.megaFlashCount++;
+                        if (st.megaFlashCount >= 3) {
+                            st.megaFlashCount = 0;
                             // Extra pause after burst
-                            lastFlash = millis() - megaInterval + interval / 2;
+                            st.lastFlash = millis() - megaInterval + interval / 2;
                         }
                     }
                 }
-                if (on) {
+                if (st.on) {
                     // Flash 1 and 2 = chosen color, flash 3 = white
-                    CRGB flashColor = (megaFlashCount < 2) ? strobeParams.color : CRGB::White;
+                    CRGB flashColor = (st.megaFlashCount < 2) ? strobeParams.color : CRGB::White;
                     fill_solid(leds, NUM_LEDS, flashColor);
                 } else {
-                    FastLED.clear();
+                    clearLeds();
                 }
             }
             break;
             
         case STROBE_RAINBOW:
             // Rainbow color cycling strobe
-            if (millis() - lastFlash > (on ? 25 : interval)) {
-                on = !on;
-                lastFlash = millis();
-                if (on) {
-                    hue += 15; // Change color each flash
+            if (millis() - st.lastFlash > (st.on ? 25 : interval)) {
+                st.on = !st.on;
+                st.lastFlash = millis();
+                if (st.on) {
+                    st.hue += 15; // Change color each flash
                 }
             }
-            if (on) {
-                fill_solid(leds, NUM_LEDS, CHSV(hue, 255, 255));
+            if (st.on) {
+                fill_solid(leds, NUM_LEDS, CHSV(st.hue, 255, 255));
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
     }
+    
+    return EFFECT_NEXT_FRAME;
 }
 
 #endif // EFFECTS_H
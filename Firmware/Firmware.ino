@@ -18,6 +18,7 @@
 #include "HTTPProvisioning.h"
 #include "LEDController.h"
 #include "LEDApi.h"
+#include "RealtimeReceiver.h"
 
 // ============================================================================
 // Global Variables
@@ -53,26 +54,50 @@ void setup() {
         while (1) { delay(100); }
     }
     
+    // Initialize LED Controller (runs on Core 0) with the stored chain config
+    uint8_t ledPins[LED_MAX_OUTPUTS];
+    uint8_t numLedPins = NVSManager::loadLedPins(ledPins, LED_MAX_OUTPUTS);
+    if (LEDController::begin(NVSManager::loadLedCount(), ledPins, numLedPins)) {
+        LOG_INFO("LED Controller started successfully");
+    } else {
+        LOG_ERROR("Failed to start LED Controller!");
+    }
+    
     // Load and set saved effect immediately (before WiFi connection)
     // This ensures smooth transition from startup animation
-    uint8_t savedEffect = NVSManager::loadEffect();
-    bool hasStoredEffect = (savedEffect != 0xFF && savedEffect < LEDController::getNumEffects());
+    NVSManager::LedState saved;
+    bool hasStateBlob = NVSManager::loadLedState(saved);
+    bool hasStoredEffect = (saved.effect != 0xFF && saved.effect < LEDController::getNumEffects());
     if (hasStoredEffect) {
-        LEDController::setEffect(savedEffect);
-        LOG_PRINTF("INFO ", "Restored saved effect: %d", savedEffect);
+        LEDController::setEffect(saved.effect);
+        LOG_PRINTF("INFO ", "Restored saved effect: %d", saved.effect);
         
         // Also restore saved parameters for this effect
-        String savedParams = NVSManager::loadParams();
-        if (!savedParams.isEmpty()) {
-            LEDController::loadParamsFromJson(savedParams);
+        if (hasStateBlob) {
+            if (saved.paramsLen > 0) {
+                LEDController::restoreParams(saved.paramsEffect, saved.params, saved.paramsLen, saved.paramsLayout);
+            }
+        } else {
+            LEDController::loadParamsFromJson(NVSManager::loadLegacyParams());
         }
     }
     
+    // Older firmware stored these as separate keys and JSON: rewrite them as
+    // one blob now, which also drops the old keys
+    if (!hasStateBlob && NVSManager::hasLegacyState()) {
+        NVSManager::saveEffect(saved.effect);
+        if (hasStoredEffect) LEDCommands::saveParams(saved.effect);
+        NVSManager::flush();
+    }
+    
+    // Segments override the single effect when present
+    LEDController::loadSegmentsFromJson(NVSManager::loadSegments());
+    LEDController::loadLayersFromJson(NVSManager::loadLayers());
+    
     // Load saved brightness
-    uint8_t savedBrightness = NVSManager::loadBrightness();
-    if (savedBrightness != 0xFF) {
-        LEDController::setBrightness(savedBrightness);
-        LOG_PRINTF("INFO ", "Restored saved brightness: %d", savedBrightness);
+    if (saved.brightness != 0xFF) {
+        LEDController::setBrightness(saved.brightness);
+        LOG_PRINTF("INFO ", "Restored saved brightness: %d", saved.brightness);
     }
     
     // Note: if no stored effect, effectReady stays false until provisioning sets Rainbow Wave
@@ -144,6 +169,9 @@ void setup() {
                 LOG_INFO("HTTP server with LED API started in Station mode");
             }
             
+            // Sequencer pixel streams (DDP / E1.31 / Art-Net)
+            RealtimeReceiver::begin();
+            
             // Optional: Start BLE anyway for additional control
             // BLEProvisioning::begin();
         } else {
@@ -230,6 +258,13 @@ void loop() {
         }
     }
     
+    // Write LED state staged by the API once it has settled
+    NVSManager::service();
+    
+    // Release closed WebSocket control clients
+    LEDSocket::loop();
+    LEDEvents::loop();
+    
     // Blink LED to indicate alive
     static unsigned long lastBlink = 0;
     if (millis() - lastBlink > 2000) {
@@ -272,13 +307,6 @@ void initGPIO() {
     pinMode(LED_BUILTIN_PIN, OUTPUT);
     digitalWrite(LED_BUILTIN_PIN, LOW);
     LOG_PRINTF("INFO ", "  Status LED: GPIO%d", LED_BUILTIN_PIN);
-    
-    // Initialize LED Controller (runs on Core 0)
-    if (LEDController::begin()) {
-        LOG_INFO("LED Controller started successfully");
-    } else {
-        LOG_ERROR("Failed to start LED Controller!");
-    }
 }
 
 // Start provisioning mode (BLE + AP + HTTP)
@@ -14,6 +14,11 @@
 #include "Config.h"
 #include "SerialLogger.h"
 #include "LEDController.h"
+#include "LEDCommands.h"
+#include "LEDSocket.h"
+#include "LEDEvents.h"
+#include "StaticPayloads.h"
+#include "RealtimeReceiver.h"
 #include "NVSManager.h"
 
 // ============================================================================
@@ -21,11 +26,21 @@
 // ============================================================================
 // Endpoints:
 // - GET  /api/led/status     → Current state
-// - POST /api/led/effect     → Change effect
+// - POST /api/led/effect     → Change effect (optional transition + duration)
 // - POST /api/led/params     → Update parameters  
 // - POST /api/led/power      → Power on/off
 // - POST /api/led/brightness → Set brightness
-// - GET  /api/led/effects    → List all effects
+// - POST /api/led/scene      → Effect, params, brightness, power at once
+// - GET  /api/led/effects    → List all effects         (cached, ETag)
+// - GET  /api/led/palettes   → List all palettes        (cached, ETag)
+// - GET  /api/led/schema     → Params of every effect   (cached, ETag)
+// - POST /api/led/config     → LED count / data pins (applied after reboot)
+// - GET  /api/led/segments   → Segment table with per-segment params
+// - POST /api/led/segments   → Replace segment table ([] = whole strip)
+// - GET  /api/led/layers     → Layer stack with blend modes and params
+// - POST /api/led/layers     → Replace layer stack ([] = no layers)
+// - WS   /api/led/ws         → Live control and state pushes (LEDSocket.h)
+// - GET  /api/led/events     → State changes as Server-Sent Events (LEDEvents.h)
 // ============================================================================
 
 class LEDApi {
@@ -38,6 +53,7 @@ public:
         }
         
         LOG_SECTION("Initializing LED API");
+        StaticPayloads::begin();
         
         // CORS preflight for LED routes
         server->on("/api/led/*", HTTP_OPTIONS, [](AsyncWebServerRequest *request) {
@@ -49,8 +65,16 @@ public:
         // GET /api/led/status - Get current LED status
         server->on("/api/led/status", HTTP_GET, handleStatus);
         
-        // GET /api/led/effects - Get list of all effects
-        server->on("/api/led/effects", HTTP_GET, handleEffects);
+        // GET /api/led/effects, /palettes, /schema - Built once at boot
+        server->on("/api/led/effects", HTTP_GET, [](AsyncWebServerRequest *request) {
+            sendStatic(request, StaticPayloads::EFFECTS);
+        });
+        server->on("/api/led/palettes", HTTP_GET, [](AsyncWebServerRequest *request) {
+            sendStatic(request, StaticPayloads::PALETTES);
+        });
+        server->on("/api/led/schema", HTTP_GET, [](AsyncWebServerRequest *request) {
+            sendStatic(request, StaticPayloads::SCHEMA);
+        });
         
         // GET /api/led/params - Get current effect parameters
         server->on("/api/led/params", HTTP_GET, handleGetParams);
@@ -83,14 +107,61 @@ public:
         );
         server->addHandler(brightnessHandler);
         
+        // POST /api/led/scene - Several settings in one frame, one NVS write
+        AsyncCallbackJsonWebHandler* sceneHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/scene",
+            handleScene
+        );
+        server->addHandler(sceneHandler);
+        
+        // POST /api/led/config - Set LED count and data pin
+        AsyncCallbackJsonWebHandler* configHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/config",
+            handleConfig
+        );
+        server->addHandler(configHandler);
+        
+        // GET /api/led/segments - Get segment table
+        server->on("/api/led/segments", HTTP_GET, handleGetSegments);
+        
+        // POST /api/led/segments - Replace segment table
+        AsyncCallbackJsonWebHandler* segmentsHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/segments",
+            handleSetSegments
+        );
+        server->addHandler(segmentsHandler);
+        
+        // GET /api/led/layers - Get layer stack
+        server->on("/api/led/layers", HTTP_GET, handleGetLayers);
+        
+        // POST /api/led/layers - Replace layer stack
+        AsyncCallbackJsonWebHandler* layersHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/layers",
+            handleSetLayers
+        );
+        server->addHandler(layersHandler);
+        
         LOG_INFO("LED API endpoints registered");
         LOG_INFO("  GET  /api/led/status");
         LOG_INFO("  GET  /api/led/effects");
+        LOG_INFO("  GET  /api/led/palettes");
+        LOG_INFO("  GET  /api/led/schema");
         LOG_INFO("  GET  /api/led/params");
         LOG_INFO("  POST /api/led/effect");
         LOG_INFO("  POST /api/led/params");
         LOG_INFO("  POST /api/led/power");
         LOG_INFO("  POST /api/led/brightness");
+        LOG_INFO("  POST /api/led/scene");
+        LOG_INFO("  POST /api/led/config");
+        LOG_INFO("  GET  /api/led/segments");
+        LOG_INFO("  POST /api/led/segments");
+        LOG_INFO("  GET  /api/led/layers");
+        LOG_INFO("  POST /api/led/layers");
+        
+        // Live control channel (same messages as the routes above, combined)
+        // and state push
+        LEDSocket::begin(server);
+        LEDEvents::begin(server);
     }
 
 private:
@@ -102,8 +173,16 @@ private:
     static void handleStatus(AsyncWebServerRequest *request) {
         LOG_DEBUG("GET /api/led/status");
         
-        StaticJsonDocument<512> doc;
+        StaticJsonDocument<768> doc;
         LEDController::getStatusJson(doc);
+        doc["nvsWrites"] = NVSManager::getWritesIssued();
+        doc["nvsCoalesced"] = NVSManager::getWritesCoalesced();
+        doc["nvsPending"] = NVSManager::hasPendingWrites();
+        doc["wsClients"] = LEDSocket::getClientCount();
+        doc["wsMessages"] = LEDSocket::getMessageCount();
+        doc["sseClients"] = LEDEvents::getClientCount();
+        doc["sseEvents"] = LEDEvents::getEventCount();
+        RealtimeReceiver::getStatusJson(doc["udp"].to<JsonObject>());
         
         String response;
         serializeJson(doc, response);
@@ -114,16 +193,27 @@ private:
     }
     
     // GET /api/led/effects
-    static void handleEffects(AsyncWebServerRequest *request) {
-        LOG_DEBUG("GET /api/led/effects");
-        
-        StaticJsonDocument<4096> doc;
-        LEDController::getEffectsJson(doc);
-        
-        String response;
-        serializeJson(doc, response);
+    // GET of a StaticPayloads entry: sent from its buffer as is, or 304
+    // when the client already holds it
+    static void sendStatic(AsyncWebServerRequest *request, StaticPayloads::Id id) {
+        LOG_DEBUG("GET " + request->url());
+        
+        const StaticPayload& payload = StaticPayloads::get(id);
+        if (payload.data == NULL) {
+            sendError(request, 500, "Out of memory");
+            return;
+        }
         
-        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        AsyncWebServerResponse *res;
+        if (request->hasHeader("If-None-Match") &&
+            StaticPayloads::matches(id, request->header("If-None-Match").c_str())) {
+            res = request->beginResponse(304);
+        } else {
+            res = request->beginResponse_P(200, "application/json", (const uint8_t*)payload.data, payload.len);
+        }
+        res->addHeader("ETag", payload.etag);
+        res->addHeader("Cache-Control", "no-cache");  // Revalidate, then 304
+        res->addHeader("Access-Control-Expose-Headers", "ETag");
         addCorsHeaders(res);
         request->send(res);
     }
@@ -144,6 +234,7 @@ private:
     }
     
     // POST /api/led/effect
+    // Body: {"id", "transition": "crossfade|wipe|dissolve", "duration": ms (0 = cut)}
     static void handleSetEffect(AsyncWebServerRequest *request, JsonVariant &json) {
         LOG_DEBUG("POST /api/led/effect");
         
@@ -161,10 +252,30 @@ private:
             return;
         }
         
-        LEDController::setEffect(effectId);
+        uint8_t transition = LEDController::parseTransition(jsonObj["transition"] | "crossfade");
+        if (transition >= LEDController::NUM_TRANSITIONS) {
+            sendError(request, 400, "Invalid transition");
+            return;
+        }
         
-        // Save to NVS so effect persists after reboot
+        uint32_t duration = jsonObj["duration"] | LED_TRANSITION_MS;
+        if (duration > LED_TRANSITION_MAX_MS) {
+            sendError(request, 400, "Transition duration too long");
+            return;
+        }
+        
+        LEDController::setEffect(effectId, transition, duration);
+        
+        // A whole-strip effect replaces any segment layout
+        if (LEDController::getNumSegments() > 0) {
+            LEDController::clearSegments();
+            NVSManager::saveSegments("");
+        }
+        
+        // Save to NVS so effect persists after reboot, with the params it
+        // will start with
         NVSManager::saveEffect(effectId);
+        LEDCommands::saveParams(effectId);
         
         StaticJsonDocument<256> doc;
         doc["status"] = "ok";
@@ -190,21 +301,21 @@ private:
             return;
         }
         
-        // Apply each parameter
+        // Apply each parameter; keys the effect does not have, or values of
+        // the wrong type, are reported back
+        StaticJsonDocument<512> doc;
+        JsonArray rejected = doc["rejected"].to<JsonArray>();
+        uint8_t updated = 0;
         for (JsonPair kv : jsonObj) {
-            LEDController::setParam(kv.key().c_str(), kv.value());
+            if (LEDController::setParam(kv.key().c_str(), kv.value())) updated++;
+            else rejected.add(kv.key().c_str());
         }
         
-        // Save current effect's params to NVS for persistence
-        StaticJsonDocument<1024> paramsDoc;
-        LEDController::getParamsJson(paramsDoc);
-        String paramsJson;
-        serializeJson(paramsDoc["params"], paramsJson);
-        NVSManager::saveParams(paramsJson);
+        // Stage current effect's params for NVS (a slider's stream ends up as one write)
+        LEDCommands::saveParams(LEDController::getCurrentEffect());
         
-        StaticJsonDocument<128> doc;
         doc["status"] = "ok";
-        doc["updated"] = jsonObj.size();
+        doc["updated"] = updated;
         
         String response;
         serializeJson(doc, response);
@@ -228,6 +339,9 @@ private:
         bool powerOn = jsonObj["on"].as<bool>();
         LEDController::setPower(powerOn);
         
+        // Switching off often comes right before pulling the plug
+        if (!powerOn) NVSManager::flush();
+        
         StaticJsonDocument<128> doc;
         doc["status"] = "ok";
         doc["power"] = powerOn;
@@ -272,6 +386,204 @@ private:
         request->send(res);
     }
     
+    // POST /api/led/scene - LEDCommands message (effect, transition,
+    // duration, params, brightness, save, power), applied as one update
+    static void handleScene(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/scene");
+        
+        uint32_t start = micros();
+        StaticJsonDocument<WS_MAX_MESSAGE> doc;
+        const char* error = NULL;
+        JsonArray rejected = doc["rejected"].to<JsonArray>();
+        if (!json.is<JsonObject>() ||
+            !LEDCommands::applyScene(json.as<JsonObject>(), doc["applied"].to<JsonObject>(), rejected, &error)) {
+            sendError(request, 400, error ? error : "Body must be an object");
+            return;
+        }
+        
+        doc["status"] = "ok";
+        doc["applyUs"] = micros() - start;  // Staging plus the NVS write
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/config
+    static void handleConfig(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/config");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("numLeds") && !jsonObj.containsKey("pin") && !jsonObj.containsKey("pins")) {
+            sendError(request, 400, "Missing 'numLeds', 'pin' or 'pins' field");
+            return;
+        }
+        
+        // Unspecified fields keep their stored value
+        uint8_t pins[LED_MAX_OUTPUTS];
+        uint8_t numPins = NVSManager::loadLedPins(pins, LED_MAX_OUTPUTS);
+        uint32_t numLeds = jsonObj["numLeds"] | (uint32_t)NVSManager::loadLedCount();
+        
+        if (jsonObj.containsKey("pins")) {
+            numPins = 0;
+            for (JsonVariant v : jsonObj["pins"].as<JsonArray>()) {
+                if (numPins == LED_MAX_OUTPUTS) {
+                    sendError(request, 400, "Too many data pins");
+                    return;
+                }
+                pins[numPins++] = v.as<uint8_t>();
+            }
+        } else if (jsonObj.containsKey("pin")) {
+            pins[0] = jsonObj["pin"].as<uint8_t>();
+            numPins = 1;
+        }
+        
+        if (!LEDController::isValidLedCount(numLeds)) {
+            sendError(request, 400, "Invalid LED count");
+            return;
+        }
+        if (!LEDController::isValidPinSet(pins, numPins, numLeds)) {
+            sendError(request, 400, "Unsupported data pin set");
+            return;
+        }
+        
+        // Buffers and RMT channels are set up once at boot
+        NVSManager::saveLedConfig(numLeds, pins, numPins);
+        
+        bool changed = numLeds != LEDController::getNumLeds() || numPins != LEDController::getNumOutputs();
+        for (uint8_t i = 0; i < numPins && !changed; i++) {
+            changed = pins[i] != LEDController::getOutput(i).pin;
+        }
+        
+        StaticJsonDocument<256> doc;
+        doc["status"] = "ok";
+        doc["numLeds"] = numLeds;
+        JsonArray pinsOut = doc["pins"].to<JsonArray>();
+        for (uint8_t i = 0; i < numPins; i++) {
+            pinsOut.add(pins[i]);
+        }
+        doc["rebootRequired"] = changed;
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/segments
+    static void handleGetSegments(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/segments");
+        
+        StaticJsonDocument<4096> doc;
+        LEDController::getSegmentsJson(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/segments
+    // Body: {"segments": [{"start", "length", "effect", "reverse", "mirror", "params": {...}}]}
+    static void handleSetSegments(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/segments");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("segments")) {
+            sendError(request, 400, "Missing 'segments' field");
+            return;
+        }
+        
+        const char* error = NULL;
+        if (!LEDController::setSegmentsFromJson(jsonObj["segments"].as<JsonArray>(), &error)) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        // Save segments with their params so the layout persists after reboot
+        String segmentsJson;
+        if (LEDController::getNumSegments() > 0) {
+            StaticJsonDocument<4096> segmentsDoc;
+            LEDController::getSegmentsJson(segmentsDoc);
+            serializeJson(segmentsDoc, segmentsJson);
+        }
+        NVSManager::saveSegments(segmentsJson);
+        
+        StaticJsonDocument<128> doc;
+        doc["status"] = "ok";
+        doc["segments"] = LEDController::getNumSegments();
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/layers
+    static void handleGetLayers(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/layers");
+        
+        StaticJsonDocument<2048> doc;
+        LEDController::getLayersJson(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/layers
+    // Body: {"layers": [{"effect", "blend": "add|screen|alpha|max", "opacity", "params": {...}}]}
+    static void handleSetLayers(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/layers");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("layers")) {
+            sendError(request, 400, "Missing 'layers' field");
+            return;
+        }
+        
+        const char* error = NULL;
+        if (!LEDController::setLayersFromJson(jsonObj["layers"].as<JsonArray>(), &error)) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        // Save layers with their params so the stack persists after reboot
+        String layersJson;
+        if (LEDController::getNumLayers() > 0) {
+            StaticJsonDocument<2048> layersDoc;
+            LEDController::getLayersJson(layersDoc);
+            serializeJson(layersDoc, layersJson);
+        }
+        NVSManager::saveLayers(layersJson);
+        
+        StaticJsonDocument<128> doc;
+        doc["status"] = "ok";
+        doc["layers"] = LEDController::getNumLayers();
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
     // ========================================================================
     // Helpers
     // ========================================================================
@@ -279,7 +591,7 @@ private:
     static void addCorsHeaders(AsyncWebServerResponse *response) {
         response->addHeader("Access-Control-Allow-Origin", HTTP_CORS_ORIGIN);
         response->addHeader("Access-Control-Allow-Methods", "GET, POST, OPTIONS");
-        response->addHeader("Access-Control-Allow-Headers", "Content-Type");
+        response->addHeader("Access-Control-Allow-Headers", "Content-Type, If-None-Match");
     }
     
     static void sendError(AsyncWebServerRequest *request, int code, const char* message) {
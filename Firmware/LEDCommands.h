@@ -0,0 +1,141 @@
+/*
+ * LEDCommands.h - Transport-independent LED control messages
+ *
+ * Applies one control message (effect, params, brightness, power in any
+ * combination) the way the REST handlers apply them one at a time,
+ * persistence included. No AsyncWebServer types, so it also builds on the
+ * host.
+ */
+
+#ifndef LED_COMMANDS_H
+#define LED_COMMANDS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "LEDController.h"
+#include "NVSManager.h"
+
+// ============================================================================
+// LEDCommands - Control Messages
+// ============================================================================
+// Message (every field optional, at least one required):
+//   {"effect": id, "transition": "crossfade|wipe|dissolve", "duration": ms,
+//    "params": {key: value, ...}, "brightness": 0-255, "save": bool,
+//    "power": bool}
+// Params go to the effect running after the message, so an effect switch
+// and its params can travel together. The whole message lands in one frame.
+// Brightness is only persisted with "save": true, as on
+// POST /api/led/brightness; a scene saves it unless "save": false.
+// ============================================================================
+
+class LEDCommands {
+public:
+    // Validate and apply `msg`. `applied` receives the resulting value of
+    // every field that was set (params as read back, i.e. clamped),
+    // `rejected` the param keys the effect did not take. An invalid message
+    // applies nothing and returns false with the reason in `error`.
+    static bool apply(JsonObject msg, JsonObject applied, JsonArray rejected, const char** error) {
+        bool hasEffect = msg.containsKey("effect");
+        bool hasParams = msg.containsKey("params");
+        bool hasBrightness = msg.containsKey("brightness");
+        bool hasPower = msg.containsKey("power");
+
+        if (!hasEffect && !hasParams && !hasBrightness && !hasPower) {
+            *error = "Nothing to apply";
+            return false;
+        }
+        if (hasEffect && !(msg["effect"].is<uint8_t>() && msg["effect"].as<uint8_t>() < LEDController::getNumEffects())) {
+            *error = "Invalid effect ID";
+            return false;
+        }
+        uint8_t transition = LEDController::parseTransition(msg["transition"] | "crossfade");
+        if (transition >= LEDController::NUM_TRANSITIONS) {
+            *error = "Invalid transition";
+            return false;
+        }
+        uint32_t duration = msg["duration"] | LED_TRANSITION_MS;
+        if (duration > LED_TRANSITION_MAX_MS) {
+            *error = "Transition duration too long";
+            return false;
+        }
+        if (hasParams && !msg["params"].is<JsonObject>()) {
+            *error = "Params must be an object";
+            return false;
+        }
+        if (hasBrightness && !msg["brightness"].is<uint8_t>()) {
+            *error = "Brightness must be 0-255";
+            return false;
+        }
+        if (hasPower && !msg["power"].is<bool>()) {
+            *error = "Power must be true or false";
+            return false;
+        }
+
+        LEDController::beginUpdate();
+
+        if (hasEffect) {
+            uint8_t effectId = msg["effect"].as<uint8_t>();
+            LEDController::setEffect(effectId, transition, duration);
+
+            // A whole-strip effect replaces any segment layout
+            if (LEDController::getNumSegments() > 0) {
+                LEDController::clearSegments();
+                NVSManager::saveSegments("");
+            }
+            NVSManager::saveEffect(effectId);
+            applied["effect"] = effectId;
+        }
+
+        if (hasParams) {
+            uint8_t effect = LEDController::getCurrentEffect();
+            JsonObject params = applied["params"].to<JsonObject>();
+            for (JsonPair kv : msg["params"].as<JsonObject>()) {
+                if (LEDController::setParam(kv.key().c_str(), kv.value())) {
+                    LEDController::getParamJson(params, kv.key().c_str(), effect);
+                } else {
+                    rejected.add(kv.key().c_str());
+                }
+            }
+        }
+        if (hasEffect || hasParams) saveParams(LEDController::getCurrentEffect());
+
+        if (hasBrightness) {
+            uint8_t brightness = msg["brightness"].as<uint8_t>();
+            LEDController::setBrightness(brightness);
+            if (msg["save"] | false) NVSManager::saveBrightness(brightness);
+            applied["brightness"] = brightness;
+        }
+
+        if (hasPower) {
+            bool powerOn = msg["power"].as<bool>();
+            LEDController::setPower(powerOn);
+            // Switching off often comes right before pulling the plug
+            if (!powerOn) NVSManager::flush();
+            applied["power"] = powerOn;
+        }
+
+        LEDController::endUpdate();
+        return true;
+    }
+
+    // apply() for a scene (POST /api/led/scene): brightness kept unless
+    // "save": false, and everything staged written to NVS in one commit
+    static bool applyScene(JsonObject msg, JsonObject applied, JsonArray rejected, const char** error) {
+        if (!msg.containsKey("save")) msg["save"] = true;
+        if (!apply(msg, applied, rejected, error)) return false;
+        NVSManager::flush();
+        return true;
+    }
+
+    // Stage an effect's params (as the API last set them) for NVS
+    static void saveParams(uint8_t effect) {
+        uint8_t params[NVS_PARAMS_MAX_BYTES];
+        uint32_t layout;
+        uint8_t len = LEDController::copyParams(effect, params, layout);
+        if (len > 0) NVSManager::saveParams(effect, params, len, layout);
+    }
+};
+
+#endif // LED_COMMANDS_H
@@ -16,6 +16,9 @@
 // Include effect definitions (must come before Effects.h)
 #include "EffectDefs.h"
 #include "Effects.h"
+#include "ParamRegistry.h"
+
+static_assert(paramBlockMaxSize() <= NVS_PARAMS_MAX_BYTES, "a params struct does not fit the NVS LED state");
 
 // ============================================================================
 // LEDController - FreeRTOS Task for LED Animations
@@ -23,43 +26,169 @@
 // Features:
 // - Runs on Core 0 (separate from WiFi on Core 1)
 // - Non-blocking effect rendering at ~60 FPS
-// - Live parameter updates via setParam()
+// - Double-buffered output: the next frame renders while the previous one
+//   is clocked out by the output task
+// - Live parameter updates via setParam(); API-side changes are staged and
+//   taken by the render task in one go at a frame boundary
+// - Segments (effects on slices) and layers (effects blended on top)
+// - Every running effect is an instance with its own state, so one effect
+//   can run in several places at once
+// - Timed transitions (crossfade, wipe, dissolve) on every effect switch
+// - Effects run on their own wake times; frames with nothing due are not sent
+// - Frame rate follows the running effects and the measured frame cost
 // ============================================================================
 
 class LEDController {
 public:
-    // Effect definition
+    // Effect type: how to build, render and destroy one instance of it
     struct EffectEntry {
         const char* name;
-        void (*func)();
+        uint16_t stateSize;             // Bytes per instance, 0 = stateless
+        void (*init)(void* state);
+        uint32_t (*render)(void* state);    // Returns micros until its next frame (EffectDefs.h)
+        void (*teardown)(void* state);
         uint8_t category;
+        uint8_t minFps;     // Useful frame-rate range, 0 = LED_MIN_FPS /
+        uint8_t maxFps;     // LED_TARGET_FPS
+    };
+    
+    static const uint8_t NO_EFFECT = 0xFF;
+    
+    // A running effect: its type, the state block it owns, its own timebase
+    // and when it wants its next frame
+    struct EffectInstance {
+        uint8_t effect = NO_EFFECT;
+        void* state = NULL;
+        EffectTime time = {};
+        uint32_t wakeAt = 0;
+    };
+    
+    // One physical data line: pixels [start, start + count) of the logical strip
+    struct LedOutput {
+        uint8_t pin;
+        uint16_t start;
+        uint16_t count;
+    };
+    
+    // Slice of the strip running its own effect. reverse flips the slice,
+    // mirror renders the first half and reflects it onto the second.
+    struct Segment {
+        uint16_t start;
+        uint16_t length;
+        uint8_t effect;
+        bool reverse;
+        bool mirror;
+    };
+    
+    // How a layer merges onto what is below it
+    enum BlendMode : uint8_t {
+        BLEND_ADD,          // Saturating sum
+        BLEND_SCREEN,       // 1 - (1 - a)(1 - b): brightens without clipping
+        BLEND_ALPHA,        // Covers the base in proportion to the layer's brightness
+        BLEND_MAX,          // Per-channel maximum
+        NUM_BLEND_MODES
+    };
+    
+    // How the outgoing picture gives way to a new effect
+    enum TransitionType : uint8_t {
+        TRANSITION_FADE,        // Crossfade
+        TRANSITION_WIPE,        // New effect sweeps in from pixel 0
+        TRANSITION_DISSOLVE,    // Pixels switch one by one in scrambled order
+        NUM_TRANSITIONS
+    };
+    
+    // Effect drawn over the whole strip into its own buffer and blended onto
+    // the base (current effect or segments) at opacity 0-255
+    struct Layer {
+        uint8_t effect;
+        uint8_t mode;
+        uint8_t opacity;
     };
 
-    // Initialize LED controller and start FreeRTOS task
-    static bool begin() {
+    // Initialize LED controller and start FreeRTOS task.
+    // numLeds/dataPins come from NVS; invalid values fall back to Config.h.
+    // With several pins the strip is split into consecutive runs, one per
+    // pin, which the RMT channels clock out in parallel.
+    static bool begin(uint16_t numLeds = ARGB_NUM_LEDS, const uint8_t* dataPins = NULL, uint8_t numPins = 0) {
         LOG_SECTION("Initializing LED Controller");
         
-        // Initialize FastLED
-        FastLED.addLeds<WS2812, ARGB_DATA_PIN, GRB>(leds, ARGB_NUM_LEDS)
-               .setCorrection(TypicalLEDStrip);
+        static const uint8_t defaultPins[] = {ARGB_DATA_PIN};
+        if (dataPins == NULL || numPins == 0) {
+            dataPins = defaultPins;
+            numPins = 1;
+        }
+        
+        if (!isValidLedCount(numLeds)) {
+            LOG_PRINTF("WARN ", "Invalid LED count %d, using %d", numLeds, ARGB_NUM_LEDS);
+            numLeds = ARGB_NUM_LEDS;
+        }
+        if (!isValidPinSet(dataPins, numPins, numLeds)) {
+            LOG_PRINTF("WARN ", "Unsupported LED data pin set, using GPIO%d", ARGB_DATA_PIN);
+            dataPins = defaultPins;
+            numPins = 1;
+        }
+        ledCount = numLeds;
+        numOutputs = planOutputs(numLeds, dataPins, numPins, outputs);
+        
+        // Frame buffers in internal RAM: leds[] is read back by effects every
+        // frame, outputLeds is what the RMT driver encodes from
+        frameLeds = allocPixelBuffer<CRGB>(true);
+        outputLeds = allocPixelBuffer<CRGB>(true);
+        resetRenderSpan();
+        if (frameLeds == NULL || outputLeds == NULL) {
+            LOG_PRINTF("ERROR", "Cannot allocate frame buffers for %d LEDs!", ledCount);
+            return false;
+        }
+        
+        // Initialize FastLED on the front buffer; effects render into leds[]
+        for (uint8_t i = 0; i < numOutputs; i++) {
+            addOutput(outputs[i].pin, outputLeds + outputs[i].start, outputs[i].count);
+        }
         FastLED.setBrightness(brightness);
         FastLED.setMaxPowerInMilliWatts(45000); // 45W max
         
         // Clear LEDs
-        FastLED.clear();
-        FastLED.show();
+        clearLeds();
+        presentFrame();
         
         // Init random seed
         random16_set_seed(esp_random());
         
-        LOG_PRINTF("INFO ", "LED Data Pin: GPIO%d", ARGB_DATA_PIN);
-        LOG_PRINTF("INFO ", "Number of LEDs: %d", ARGB_NUM_LEDS);
+        // Param lookup is ready before the HTTP handlers and the NVS restore run
+        buildParamIndex();
+        stateLock = xSemaphoreCreateMutex();
+        frameLock = xSemaphoreCreateMutex();
+        
+        for (uint8_t i = 0; i < numOutputs; i++) {
+            LOG_PRINTF("INFO ", "LED Data Pin: GPIO%d (LEDs %d-%d)", outputs[i].pin,
+                       outputs[i].start, outputs[i].start + outputs[i].count - 1);
+        }
+        LOG_PRINTF("INFO ", "Number of LEDs: %d", ledCount);
         
         // Play startup animation (blocking - before FreeRTOS task starts)
         playStartupAnimation();
         
-        // Create LED task on Core 0
+        // Create output task on Core 0. It blocks on the RMT transfer, so the
+        // render task keeps the core while a frame is on the wire.
+        outputIdle = xSemaphoreCreateBinary();
+        xSemaphoreGive(outputIdle);
         BaseType_t result = xTaskCreatePinnedToCore(
+            outputTask,               // Task function
+            "LEDOutput",              // Task name
+            TASK_STACK_SIZE_LED_OUT,  // Stack size
+            NULL,                     // Parameters
+            TASK_PRIORITY_LED_OUT,    // Priority
+            &outputTaskHandle,        // Task handle
+            0                         // Core 0 (WiFi uses Core 1)
+        );
+        
+        if (result != pdPASS) {
+            LOG_ERROR("Failed to create LED output task!");
+            return false;
+        }
+        
+        // Create LED task on Core 0
+        result = xTaskCreatePinnedToCore(
             ledTask,              // Task function
             "LEDTask",            // Task name
             TASK_STACK_SIZE_LED,  // Stack size
@@ -76,6 +205,7 @@ public:
         
         LOG_INFO("LED Controller initialized successfully!");
         LOG_PRINTF("INFO ", "Loaded %d effects", NUM_EFFECTS);
+        fpsWindowStart = micros();
         
         return true;
     }
@@ -89,27 +219,367 @@ public:
         return effectReady;
     }
     
-    static void setEffect(uint8_t id) {
+    // Switch effect. The outgoing picture gives way over durationMs
+    // (0 = cut); the render task picks the switch up at the next frame.
+    static void setEffect(uint8_t id, uint8_t transition = TRANSITION_FADE, uint16_t durationMs = LED_TRANSITION_MS) {
         if (id < NUM_EFFECTS) {
+            lockState();
+            pendingTransition = transition < NUM_TRANSITIONS ? transition : TRANSITION_FADE;
+            pendingTransitionMs = min(durationMs, (uint16_t)LED_TRANSITION_MAX_MS);
             currentEffect = id;
             effectChanged = true;
             effectReady = true;  // Effect is now set, task can proceed
+            markPending();
+            unlockState();
             LOG_PRINTF("INFO ", "Effect changed to: %s", effects[id].name);
         }
     }
     
+    // The render loop blanks the strip on its next frame, so the output
+    // buffer is only ever written from one task
+    static const char* transitionName(uint8_t type) {
+        static const char* const names[NUM_TRANSITIONS] = {"crossfade", "wipe", "dissolve"};
+        return names[type < NUM_TRANSITIONS ? type : TRANSITION_FADE];
+    }
+    
+    // Returns NUM_TRANSITIONS for an unknown name
+    static uint8_t parseTransition(const char* name) {
+        uint8_t type = 0;
+        while (type < NUM_TRANSITIONS && strcmp(name, transitionName(type)) != 0) type++;
+        return type;
+    }
+    
+    static bool isTransitioning() { return transitionActive; }
+    
+    // Frame period picked by the governor (ledTask sleeps to it)
+    static uint32_t getFramePeriodMicros() { return framePeriodMicros; }
+    static uint8_t getTargetFps() { return targetFps; }
+    
     static void setPower(bool on) {
+        lockState();
         powerOn = on;
-        if (!on) {
-            FastLED.clear();
-            FastLED.show();
-        }
+        markPending();
+        unlockState();
         LOG_PRINTF("INFO ", "LED Power: %s", on ? "ON" : "OFF");
     }
     
+    // Stage several changes as one (a scene): the frame boundary takes none
+    // of them before endUpdate(), then all in the same frame. Calls nest.
+    static void beginUpdate() {
+        lockState();
+        updateDepth++;
+        unlockState();
+    }
+    
+    static void endUpdate() {
+        lockState();
+        if (updateDepth > 0) updateDepth--;
+        unlockState();
+    }
+    
+    static bool isValidLedCount(uint32_t n) {
+        return n >= 1 && n <= LED_MAX_LEDS;
+    }
+    
+    static bool isValidDataPin(uint8_t pin) {
+        static const uint8_t pins[] = LED_DATA_PINS;
+        for (uint8_t p : pins) {
+            if (p == pin) return true;
+        }
+        return pin == ARGB_DATA_PIN;
+    }
+    
+    // 1..LED_MAX_OUTPUTS distinct supported pins, at least one LED on each
+    static bool isValidPinSet(const uint8_t* pins, uint8_t numPins, uint16_t numLeds) {
+        if (numPins == 0 || numPins > LED_MAX_OUTPUTS || numPins > numLeds) return false;
+        for (uint8_t i = 0; i < numPins; i++) {
+            if (!isValidDataPin(pins[i])) return false;
+            for (uint8_t j = 0; j < i; j++) {
+                if (pins[j] == pins[i]) return false;
+            }
+        }
+        return true;
+    }
+    
+    // Split numLeds into numPins consecutive runs of near-equal length (the
+    // first numLeds % numPins runs get one extra LED). Returns numPins.
+    static uint8_t planOutputs(uint16_t numLeds, const uint8_t* pins, uint8_t numPins, LedOutput* out) {
+        uint16_t start = 0;
+        for (uint8_t i = 0; i < numPins; i++) {
+            out[i].pin = pins[i];
+            out[i].start = start;
+            out[i].count = numLeds / numPins + (i < numLeds % numPins ? 1 : 0);
+            start += out[i].count;
+        }
+        return numPins;
+    }
+    
+    static uint16_t getNumLeds() { return ledCount; }
+    static uint8_t getNumOutputs() { return numOutputs; }
+    static const LedOutput& getOutput(uint8_t i) { return outputs[i]; }
+    
+    // ========================================================================
+    // Segments
+    // ========================================================================
+    // With no segments the whole strip runs currentEffect. Otherwise each
+    // segment renders its effect into its own slice and pixels outside every
+    // segment stay dark. Effect parameters are per effect, so a segment's
+    // params are those of its effect. An effect may run in several segments;
+    // each gets its own instance.
+    
+    static bool isValidSegments(const Segment* segs, uint8_t n, const char** error) {
+        if (n > LED_MAX_SEGMENTS) {
+            *error = "Too many segments";
+            return false;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            if (segs[i].length == 0 || (uint32_t)segs[i].start + segs[i].length > ledCount) {
+                *error = "Segment outside the strip";
+                return false;
+            }
+            if (segs[i].effect >= NUM_EFFECTS) {
+                *error = "Invalid effect ID";
+                return false;
+            }
+            for (uint8_t j = 0; j < i; j++) {
+                if (segs[i].start < segs[j].start + segs[j].length &&
+                    segs[j].start < segs[i].start + segs[i].length) {
+                    *error = "Segments overlap";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    // Replace the segment table (n = 0 returns to whole-strip mode).
+    // The render task picks it up at the next frame boundary.
+    static bool setSegments(const Segment* segs, uint8_t n, const char** error) {
+        if (!isValidSegments(segs, n, error)) return false;
+        lockState();
+        if (n > 0) memcpy(segments, segs, sizeof(Segment) * n);
+        numSegments = n;
+        segmentsChanged = true;
+        effectReady = true;
+        markPending();
+        unlockState();
+        LOG_PRINTF("INFO ", "Segments set: %d", n);
+        return true;
+    }
+    
+    static void clearSegments() {
+        const char* error;
+        setSegments(NULL, 0, &error);
+    }
+    
+    static uint8_t getNumSegments() { return numSegments; }
+    static const Segment& getSegment(uint8_t i) { return segments[i]; }
+    
+    // Parse a segment array as returned by getSegmentsJson (params optional)
+    // and apply it
+    static bool setSegmentsFromJson(JsonArray arr, const char** error) {
+        Segment segs[LED_MAX_SEGMENTS];
+        uint8_t n = 0;
+        for (JsonVariant v : arr) {
+            if (n == LED_MAX_SEGMENTS) {
+                *error = "Too many segments";
+                return false;
+            }
+            JsonObject obj = v.as<JsonObject>();
+            if (!obj.containsKey("start") || !obj.containsKey("length") || !obj.containsKey("effect")) {
+                *error = "Segment needs 'start', 'length' and 'effect'";
+                return false;
+            }
+            segs[n].start = obj["start"].as<uint16_t>();
+            segs[n].length = obj["length"].as<uint16_t>();
+            segs[n].effect = obj["effect"].as<uint8_t>();
+            segs[n].reverse = obj["reverse"] | false;
+            segs[n].mirror = obj["mirror"] | false;
+            n++;
+        }
+        if (!isValidSegments(segs, n, error)) return false;
+        
+        uint8_t i = 0;
+        for (JsonVariant v : arr) {
+            for (JsonPair kv : v["params"].as<JsonObject>()) {
+                setParam(kv.key().c_str(), kv.value(), segs[i].effect);
+            }
+            i++;
+        }
+        return setSegments(segs, n, error);
+    }
+    
+    // Restore segments saved by LEDApi (NVS)
+    static void loadSegmentsFromJson(const String& jsonStr) {
+        if (jsonStr.isEmpty()) return;
+        
+        StaticJsonDocument<4096> doc;
+        DeserializationError err = deserializeJson(doc, jsonStr);
+        if (err) {
+            LOG_PRINTF("WARN ", "Failed to parse segments JSON: %s", err.c_str());
+            return;
+        }
+        
+        const char* error;
+        if (!setSegmentsFromJson(doc.as<JsonArray>(), &error)) {
+            LOG_PRINTF("WARN ", "Stored segments rejected: %s", error);
+            return;
+        }
+        LOG_INFO("Segments restored from NVS");
+    }
+    
+    static void getSegmentsJson(JsonDocument& doc) {
+        JsonArray arr = doc.to<JsonArray>();
+        lockState();
+        for (uint8_t i = 0; i < numSegments; i++) {
+            const Segment& seg = segments[i];
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = i;
+            obj["start"] = seg.start;
+            obj["length"] = seg.length;
+            obj["effect"] = seg.effect;
+            obj["effectName"] = effects[seg.effect].name;
+            obj["reverse"] = seg.reverse;
+            obj["mirror"] = seg.mirror;
+            writeParamsJson(obj["params"].to<JsonObject>(), seg.effect);
+        }
+        unlockState();
+    }
+    
+    // ========================================================================
+    // Layers
+    // ========================================================================
+    // Layers stack on top of the base in order. Each renders the full strip
+    // into its own buffer and copyToOutput merges all of them in a single
+    // pass over the front buffer. Like segments, a layer's params are those
+    // of its effect, and it runs its own instance even when the base draws
+    // the same effect.
+    
+    static bool isValidLayers(const Layer* stack, uint8_t n, const char** error) {
+        if (n > LED_MAX_LAYERS) {
+            *error = "Too many layers";
+            return false;
+        }
+        for (uint8_t i = 0; i < n; i++) {
+            if (stack[i].effect >= NUM_EFFECTS) {
+                *error = "Invalid effect ID";
+                return false;
+            }
+            if (stack[i].mode >= NUM_BLEND_MODES) {
+                *error = "Invalid blend mode";
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Replace the layer stack (n = 0 removes all layers).
+    // The render task picks it up at the next frame boundary.
+    static bool setLayers(const Layer* stack, uint8_t n, const char** error) {
+        if (!isValidLayers(stack, n, error)) return false;
+        lockState();
+        if (n > 0) memcpy(layers, stack, sizeof(Layer) * n);
+        numLayers = n;
+        layersChanged = true;
+        markPending();
+        unlockState();
+        LOG_PRINTF("INFO ", "Layers set: %d", n);
+        return true;
+    }
+    
+    static void clearLayers() {
+        const char* error;
+        setLayers(NULL, 0, &error);
+    }
+    
+    static uint8_t getNumLayers() { return numLayers; }
+    static const Layer& getLayer(uint8_t i) { return layers[i]; }
+    
+    static const char* blendModeName(uint8_t mode) {
+        static const char* const names[NUM_BLEND_MODES] = {"add", "screen", "alpha", "max"};
+        return names[mode < NUM_BLEND_MODES ? mode : BLEND_ADD];
+    }
+    
+    // Returns NUM_BLEND_MODES for an unknown name
+    static uint8_t parseBlendMode(const char* name) {
+        uint8_t mode = 0;
+        while (mode < NUM_BLEND_MODES && strcmp(name, blendModeName(mode)) != 0) mode++;
+        return mode;
+    }
+    
+    // Parse a layer array as returned by getLayersJson ("blend" defaults to
+    // add, "opacity" to 255, params optional) and apply it
+    static bool setLayersFromJson(JsonArray arr, const char** error) {
+        Layer stack[LED_MAX_LAYERS];
+        uint8_t n = 0;
+        for (JsonVariant v : arr) {
+            if (n == LED_MAX_LAYERS) {
+                *error = "Too many layers";
+                return false;
+            }
+            JsonObject obj = v.as<JsonObject>();
+            if (!obj.containsKey("effect")) {
+                *error = "Layer needs 'effect'";
+                return false;
+            }
+            stack[n].effect = obj["effect"].as<uint8_t>();
+            stack[n].mode = parseBlendMode(obj["blend"] | "add");
+            stack[n].opacity = obj["opacity"] | 255;
+            n++;
+        }
+        if (!isValidLayers(stack, n, error)) return false;
+        
+        uint8_t i = 0;
+        for (JsonVariant v : arr) {
+            for (JsonPair kv : v["params"].as<JsonObject>()) {
+                setParam(kv.key().c_str(), kv.value(), stack[i].effect);
+            }
+            i++;
+        }
+        return setLayers(stack, n, error);
+    }
+    
+    // Restore layers saved by LEDApi (NVS)
+    static void loadLayersFromJson(const String& jsonStr) {
+        if (jsonStr.isEmpty()) return;
+        
+        StaticJsonDocument<2048> doc;
+        DeserializationError err = deserializeJson(doc, jsonStr);
+        if (err) {
+            LOG_PRINTF("WARN ", "Failed to parse layers JSON: %s", err.c_str());
+            return;
+        }
+        
+        const char* error;
+        if (!setLayersFromJson(doc.as<JsonArray>(), &error)) {
+            LOG_PRINTF("WARN ", "Stored layers rejected: %s", error);
+            return;
+        }
+        LOG_INFO("Layers restored from NVS");
+    }
+    
+    static void getLayersJson(JsonDocument& doc) {
+        JsonArray arr = doc.to<JsonArray>();
+        lockState();
+        for (uint8_t i = 0; i < numLayers; i++) {
+            const Layer& layer = layers[i];
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = i;
+            obj["effect"] = layer.effect;
+            obj["effectName"] = effects[layer.effect].name;
+            obj["blend"] = blendModeName(layer.mode);
+            obj["opacity"] = layer.opacity;
+            writeParamsJson(obj["params"].to<JsonObject>(), layer.effect);
+        }
+        unlockState();
+    }
+    
+    // Applied to the strip with the next frame (presentFrame)
     static void setBrightness(uint8_t b) {
+        lockState();
         brightness = b;
-        FastLED.setBrightness(brightness);
+        markPending();
+        unlockState();
         LOG_PRINTF("INFO ", "LED Brightness: %d", brightness);
     }
     
@@ -118,17 +588,17 @@ public:
         LOG_INFO("Playing startup animation...");
         
         // Clear all LEDs first
-        FastLED.clear();
-        FastLED.show();
+        clearLeds();
+        presentFrame();
         
         // Calculate delay per LED (aim for ~2 second total animation)
-        uint16_t delayPerLed = max(5, min(30, 2000 / ARGB_NUM_LEDS));
+        uint16_t delayPerLed = max(5, min(30, 2000 / NUM_LEDS));
         
         // Build animation: light up each LED sequentially with rainbow
-        for (uint16_t i = 0; i < ARGB_NUM_LEDS; i++) {
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
             uint8_t hue = (i * 256 / 15) & 0xFF;  // Use default size=15
             leds[i] = CHSV(hue, 255, brightness);  // Use current brightness
-            FastLED.show();
+            presentFrame();
             delay(delayPerLed);
         }
         
@@ -149,363 +619,72 @@ public:
             return;
         }
         
+        // Stored keys go through the same descriptors as live updates, so a
+        // stale or corrupt entry is dropped instead of applied
         JsonObject params = doc.as<JsonObject>();
+        uint8_t rejected = 0;
         for (JsonPair kv : params) {
-            setParam(kv.key().c_str(), kv.value());
+            if (!setParam(kv.key().c_str(), kv.value())) rejected++;
         }
         
+        if (rejected > 0) LOG_PRINTF("WARN ", "Ignored %d stored parameter(s)", rejected);
         LOG_INFO("Effect parameters restored from NVS");
     }
-    
-    // Set parameter from JSON key-value
-    static void setParam(const String& key, JsonVariant value) {
-        // Speed parameter
-        if (key == "speed" && value.is<uint8_t>()) {
-            applySpeedParam(value.as<uint8_t>());
-        }
-        // Generic color parameter
-        else if (key == "color" && value.is<const char*>()) {
-            CRGB color = parseColor(value.as<const char*>());
-            applyColorParam(color);
-        }
-        // Intensity parameter
-        else if (key == "intensity" && value.is<uint8_t>()) {
-            applyIntensityParam(value.as<uint8_t>());
-        }
-        // Gradient colors
-        else if (key == "colorStart" && value.is<const char*>()) {
-            gradientParams.colorStart = parseColor(value.as<const char*>());
-        }
-        else if (key == "colorMiddle" && value.is<const char*>()) {
-            gradientParams.colorMiddle = parseColor(value.as<const char*>());
-        }
-        else if (key == "colorEnd" && value.is<const char*>()) {
-            gradientParams.colorEnd = parseColor(value.as<const char*>());
-        }
-        else if (key == "threePoint" && value.is<bool>()) {
-            gradientParams.threePoint = value.as<bool>();
-        }
-        else if (key == "style" && value.is<uint8_t>()) {
-            if (currentEffect == 1) gradientParams.style = (GradientStyle)value.as<uint8_t>();
-            else if (currentEffect == 40) policeLightsParams.style = (PoliceStyle)constrain(value.as<uint8_t>(), 0, 2);
-        }
-        // Spots parameters
-        else if (key == "spread" && value.is<uint8_t>()) {
-            spotsParams.spread = value.as<uint8_t>();
-        }
-        else if (key == "width" && value.is<uint8_t>()) {
-            spotsParams.width = value.as<uint8_t>();
-        }
-        else if (key == "fade" && value.is<bool>()) {
-            spotsParams.fade = value.as<bool>();
-        }
-        // Pattern parameters
-        else if (key == "colorFg" && value.is<const char*>()) {
-            patternParams.colorFg = parseColor(value.as<const char*>());
-        }
-        else if (key == "colorBg" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 3) patternParams.colorBg = c;  // Pattern effect
-            else if (currentEffect == 15) sparkleParams.colorBg = c;  // Sparkle
-            else if (currentEffect == 16) glitterParams.bgColor = c;  // Glitter
-        }
-        else if (key == "fgSize" && value.is<uint8_t>()) {
-            patternParams.fgSize = value.as<uint8_t>();
-        }
-        else if (key == "bgSize" && value.is<uint8_t>()) {
-            patternParams.bgSize = value.as<uint8_t>();
-        }
-        // Color Wave, Scanner, and Running Lights parameters (color1-8)
-        else if (key == "color1" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[0] = c;
-            else if (currentEffect == 9) scannerParams.colors[0] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[0] = c;
-            else if (currentEffect == 26) christmasChaseParams.color1 = c;
-            else if (currentEffect == 40) policeLightsParams.color1 = c;
-            else if (currentEffect == 39) fadeParams.colors[0] = c;
-        }
-        else if (key == "color2" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[1] = c;
-            else if (currentEffect == 9) scannerParams.colors[1] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[1] = c;
-            else if (currentEffect == 26) christmasChaseParams.color2 = c;
-            else if (currentEffect == 40) policeLightsParams.color2 = c;
-            else if (currentEffect == 39) fadeParams.colors[1] = c;
-        }
-        else if (key == "color3" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[2] = c;
-            else if (currentEffect == 9) scannerParams.colors[2] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[2] = c;
-            else if (currentEffect == 39) fadeParams.colors[2] = c;
-        }
-        else if (key == "color4" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[3] = c;
-            else if (currentEffect == 9) scannerParams.colors[3] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[3] = c;
-            else if (currentEffect == 39) fadeParams.colors[3] = c;
-        }
-        else if (key == "color5" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[4] = c;
-            else if (currentEffect == 9) scannerParams.colors[4] = c;
-            else if (currentEffect == 39) fadeParams.colors[4] = c;
-        }
-        else if (key == "color6" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[5] = c;
-            else if (currentEffect == 9) scannerParams.colors[5] = c;
-            else if (currentEffect == 39) fadeParams.colors[5] = c;
-        }
-        else if (key == "color7" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[6] = c;
-            else if (currentEffect == 9) scannerParams.colors[6] = c;
-            else if (currentEffect == 39) fadeParams.colors[6] = c;
-        }
-        else if (key == "color8" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[7] = c;
-            else if (currentEffect == 9) scannerParams.colors[7] = c;
-            else if (currentEffect == 39) fadeParams.colors[7] = c;
-        }
-        else if (key == "direction" && value.is<uint8_t>()) {
-            Direction dir = (Direction)value.as<uint8_t>();
-            if (currentEffect == 5) colorWaveParams.direction = dir;
-            else if (currentEffect == 10) cometParams.direction = dir;
-            else if (currentEffect == 29) snowSparkleParams.direction = dir;
-        }
-        // Rainbow wave size
-        else if (key == "size" && value.is<uint8_t>()) {
-            rainbowWaveParams.size = value.as<uint8_t>();
-        }
-        else if (key == "saturation" && value.is<uint8_t>()) {
-            rainbowWaveParams.saturation = value.as<uint8_t>();
-        }
-        // Wavy effect parameters
-        else if (key == "amplitude" && value.is<uint8_t>()) {
-            wavyParams.amplitude = value.as<uint8_t>();
-        }
-        else if (key == "frequency" && value.is<uint8_t>()) {
-            if (currentEffect == 7) wavyParams.frequency = value.as<uint8_t>();
-            else if (currentEffect == 34) lightningParams.frequency = value.as<uint8_t>();
-            else if (currentEffect == 41) strobeParams.frequency = value.as<uint8_t>();
-        }
-        // Two-color effects
-        else if (key == "colorPrimary" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 6) oscillateParams.colorPrimary = c;
-            else if (currentEffect == 12) androidParams.colorPrimary = c;
-            else if (currentEffect == 37) breatheParams.colorPrimary = c;
-        }
-        else if (key == "colorSecondary" && value.is<const char*>()) {
-            CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 6) oscillateParams.colorSecondary = c;
-            else if (currentEffect == 12) androidParams.colorSecondary = c;
-            else if (currentEffect == 37) breatheParams.colorSecondary = c;
-        }
-        else if (key == "pointSize" && value.is<uint8_t>()) {
-            oscillateParams.pointSize = value.as<uint8_t>();
-        }
-        // Gap and trail
-        else if (key == "gapSize" && value.is<uint8_t>()) {
-            theaterChaseParams.gapSize = value.as<uint8_t>();
-        }
-        else if (key == "trailLength" && value.is<uint8_t>()) {
-            if (currentEffect == 9) scannerParams.trailLength = value.as<uint8_t>();
-            else if (currentEffect == 10) cometParams.trailLength = value.as<uint8_t>();
-            else if (currentEffect == 35) matrixParams.trailLength = constrain(value.as<uint8_t>(), 3, 30);
-        }
-        else if (key == "sparkleColor" && value.is<const char*>()) {
-            cometParams.sparkleColor = parseColor(value.as<const char*>());
-        }
-        else if (key == "sparkleEnabled" && value.is<bool>()) {
-            cometParams.sparkleEnabled = value.as<bool>();
-        }
-        else if (key == "numDots" && value.is<uint8_t>()) {
-            scannerParams.numDots = value.as<uint8_t>();
-        }
-        // Boolean modes
-        else if (key == "rainbowMode" && value.is<bool>()) {
-            theaterChaseParams.rainbowMode = value.as<bool>();
-        }
-        else if (key == "waveWidth" && value.is<uint8_t>()) {
-            runningLightsParams.waveWidth = value.as<uint8_t>();
-        }
-        else if (key == "shape" && value.is<uint8_t>()) {
-            runningLightsParams.shape = (WaveShape)value.as<uint8_t>();
-        }
-        else if (key == "numColors" && value.is<uint8_t>()) {
-            if (currentEffect == 5) colorWaveParams.numColors = value.as<uint8_t>();
-            else if (currentEffect == 11) runningLightsParams.numColors = value.as<uint8_t>();
-            else if (currentEffect == 39) fadeParams.numColors = constrain(value.as<uint8_t>(), 2, 8);
-        }
-        else if (key == "dualMode" && value.is<bool>()) {
-            if (currentEffect == 9) scannerParams.dualMode = value.as<bool>();
-            else if (currentEffect == 11) runningLightsParams.dualMode = value.as<bool>();
-        }
-        else if (key == "sectionWidth" && value.is<uint8_t>()) {
-            androidParams.sectionWidth = value.as<uint8_t>();
-        }
-        // Palette (for Twinkle, TwinkleFox, Fire, etc.)
-        else if (key == "palette") {
-            int p = value.as<int>();
-            if (currentEffect == 7) wavyParams.palette = (PaletteType)p;
-            else if (currentEffect == 13) twinkleParams.palette = (PaletteType)p;
-            else if (currentEffect == 14) twinkleFoxParams.palette = (PaletteType)p;
-            else if (currentEffect == 18) fireParams.palette = (PaletteType)p;
-            else if (currentEffect == 22) auroraParams.palette = (PaletteType)p;
-            else if (currentEffect == 23) pacificaParams.palette = (PaletteType)p;
-            else if (currentEffect == 24) lakeParams.palette = (PaletteType)p;
-            else if (currentEffect == 25) fairyParams.palette = (PaletteType)p;
-            else if (currentEffect == 30) bouncingBallsParams.palette = (PaletteType)p;
-            else if (currentEffect == 31) popcornParams.palette = (PaletteType)p;
-        }
-        else if (key == "fadeSpeed" && value.is<uint8_t>()) {
-            twinkleParams.fadeSpeed = value.as<uint8_t>();
-        }
-        else if (key == "colorMode") {
-            if (currentEffect == 13) {
-                twinkleParams.colorMode = (TwinkleMode)value.as<int>();
-            } else if (currentEffect == 25) {
-                fairyParams.colorMode = (FairyMode)value.as<uint8_t>();
-            }
-        }
-        else if (key == "twinkleColor" && value.is<const char*>()) {
-            twinkleParams.twinkleColor = parseColor(value.as<const char*>());
-        }
-        else if (key == "twinkleRate" && value.is<uint8_t>()) {
-            twinkleFoxParams.twinkleRate = value.as<uint8_t>();
-        }
-        // Sparkle specific
-        else if (key == "colorSpark" && value.is<const char*>()) {
-            sparkleParams.colorSpark = parseColor(value.as<const char*>());
-        }
-        else if (key == "overlay" && value.is<bool>()) {
-            if (currentEffect == 15) sparkleParams.overlay = value.as<bool>();
-            else if (currentEffect == 16) glitterParams.overlay = value.as<bool>();
-            else if (currentEffect == 27) halloweenEyesParams.overlay = value.as<bool>();
-            else if (currentEffect == 28) fireworksParams.overlay = value.as<bool>();
-            else if (currentEffect == 32) dripParams.overlay = value.as<bool>();
-            else if (currentEffect == 34) lightningParams.overlay = value.as<bool>();
-        }
-        else if (key == "darkMode" && value.is<bool>()) {
-            sparkleParams.darkMode = value.as<bool>();
-        }
-        // Glitter specific
-        else if (key == "rainbowBg" && value.is<bool>()) {
-            glitterParams.rainbowBg = value.as<bool>();
-        }
-        // Starry Night specific
-        else if (key == "density" && value.is<uint8_t>()) {
-            if (currentEffect == 17) starryNightParams.density = value.as<uint8_t>();
-            else if (currentEffect == 29) snowSparkleParams.density = value.as<uint8_t>();
-        }
-        else if (key == "colorStars" && value.is<const char*>()) {
-            starryNightParams.colorStars = parseColor(value.as<const char*>());
-        }
-        else if (key == "shootingStars" && value.is<bool>()) {
-            starryNightParams.shootingStars = value.as<bool>();
-        }
-        // Fire specific
-        else if (key == "cooling" && value.is<uint8_t>()) {
-            fireParams.cooling = value.as<uint8_t>();
-        }
-        else if (key == "sparking" && value.is<uint8_t>()) {
-            fireParams.sparking = value.as<uint8_t>();
-        }
-        else if (key == "boost" && value.is<bool>()) {
-            fireParams.boost = value.as<bool>();
-        }
-        // Candle specific
-        else if (key == "multiMode" && value.is<bool>()) {
-            candleParams.multiMode = value.as<bool>();
-        }
-        else if (key == "colorShift" && value.is<uint8_t>()) {
-            candleParams.colorShift = value.as<uint8_t>();
-        }
-        // Lava specific (effect 21)
-        else if (key == "blobSize" && value.is<uint8_t>()) {
-            lavaParams.blobSize = value.as<uint8_t>();
-        }
-        else if (key == "smoothness" && value.is<uint8_t>()) {
-            lavaParams.smoothness = value.as<uint8_t>();
-        }
-        // Fairy specific (effect 25)
-        else if (key == "numFlashers" && value.is<uint8_t>()) {
-            fairyParams.numFlashers = value.as<uint8_t>();
-        }
-        // ChristmasChase specific (effect 26) - color1/color2 handled earlier with other multi-color effects
-        else if (key == "pattern" && value.is<uint8_t>()) {
-            christmasChaseParams.pattern = (ChristmasPattern)value.as<uint8_t>();
-        }
-        // HalloweenEyes specific (effect 27)
-        else if (key == "duration" && value.is<uint8_t>()) {
-            halloweenEyesParams.duration = value.as<uint8_t>() * 10; // Scale to ms
-        }
-        else if (key == "fadeTime" && value.is<uint8_t>()) {
-            halloweenEyesParams.fadeTime = value.as<uint8_t>() * 5; // Scale to ms
-        }
-        // Fireworks specific (effect 28)
-        else if (key == "chance" && value.is<uint8_t>()) {
-            fireworksParams.chance = value.as<uint8_t>();
-        }
-        else if (key == "fragments" && value.is<uint8_t>()) {
-            fireworksParams.fragments = value.as<uint8_t>();
-        }
-        else if (key == "gravity" && value.is<uint8_t>()) {
-            if (currentEffect == 28) fireworksParams.gravity = value.as<uint8_t>();
-            else if (currentEffect == 30) bouncingBallsParams.gravity = value.as<uint8_t>();
-            else if (currentEffect == 32) dripParams.gravity = value.as<uint8_t>();
-        }
-        // BouncingBalls specific (effect 30)
-        else if (key == "numBalls" && value.is<uint8_t>()) {
-            bouncingBallsParams.numBalls = constrain(value.as<uint8_t>(), 1, 8);
-        }
-        else if (key == "trail" && value.is<uint8_t>()) {
-            bouncingBallsParams.trail = value.as<uint8_t>();
-        }
-        // Drip specific (effect 32)
-        else if (key == "numDrips" && value.is<uint8_t>()) {
-            dripParams.numDrips = constrain(value.as<uint8_t>(), 1, 8);
-        }
-        // Plasma specific (effect 33)
-        else if (key == "phase" && value.is<uint8_t>()) {
-            plasmaParams.phase = value.as<uint8_t>();
-        }
-        // Matrix specific (effect 35)
-        else if (key == "spawningRate" && value.is<uint8_t>()) {
-            matrixParams.spawningRate = value.as<uint8_t>();
-        }
-        // Heartbeat specific (effect 36)
-        else if (key == "bpm" && value.is<uint8_t>()) {
-            heartbeatParams.bpm = constrain(value.as<uint8_t>(), 40, 180);
-        }
-        // Breathe specific (effect 37)
-        else if (key == "twoColor" && value.is<bool>()) {
-            breatheParams.twoColor = value.as<bool>();
-        }
-        // Dissolve specific (effect 38)
-        else if (key == "repeatSpeed" && value.is<uint8_t>()) {
-            dissolveParams.repeatSpeed = value.as<uint8_t>();
-        }
-        else if (key == "dissolveSpeed" && value.is<uint8_t>()) {
-            dissolveParams.dissolveSpeed = value.as<uint8_t>();
-        }
-        else if (key == "randomColors" && value.is<bool>()) {
-            dissolveParams.randomColors = value.as<bool>();
-        }
-        // Fade specific (effect 39) - loop parameter
-        else if (key == "loop" && value.is<bool>()) {
-            fadeParams.loop = value.as<bool>();
-        }
-        // Strobe specific (effect 41) - mode parameter
-        else if (key == "mode" && value.is<uint8_t>()) {
-            strobeParams.mode = (StrobeMode)constrain(value.as<uint8_t>(), 0, 2);
+
+    // Staged params struct of `effect` as raw bytes for NVS, with its layout
+    // fingerprint. Returns the length, 0 for an invalid effect.
+    static uint8_t copyParams(uint8_t effect, uint8_t* buf, uint32_t& layout) {
+        if (effect >= NUM_PARAM_BLOCKS) return 0;
+        buildParamIndex();
+        uint8_t len = effectParamBlocks[effect].size;
+        lockState();
+        memcpy(buf, stagedParams[effect], len);
+        unlockState();
+        layout = paramLayout(effect);
+        return len;
+    }
+
+    // Take back bytes from copyParams (NVS restore). Rejected unless they
+    // were written under the current layout of the effect's struct.
+    static bool restoreParams(uint8_t effect, const uint8_t* data, uint8_t len, uint32_t layout) {
+        if (effect >= NUM_PARAM_BLOCKS || len != effectParamBlocks[effect].size || layout != paramLayout(effect)) {
+            LOG_WARN("Stored parameters do not match this firmware - ignored");
+            return false;
         }
+        buildParamIndex();
+        lockState();
+        memcpy(stagedParams[effect], data, len);
+        paramsStaged |= 1ULL << effect;
+        markPending();
+        unlockState();
+        LOG_INFO("Effect parameters restored from NVS");
+        return true;
+    }
+    
+    // Set parameter from JSON key-value for the running effect
+    static bool setParam(const char* key, JsonVariant value) {
+        return setParam(key, value, currentEffect);
+    }
+    
+    // Set parameter of a given effect (segments run effects other than
+    // currentEffect). Numbers are clamped to the descriptor's range; unknown
+    // keys and values of the wrong JSON type are rejected. The value is
+    // staged; effects see it from the next frame on.
+    static bool setParam(const char* key, JsonVariant value, uint8_t effect) {
+        const ParamDesc* p = findParam(key, effect);
+        if (p == NULL) return false;
+        
+        bool accepted = p->type == PARAM_COLOR ? value.is<const char*>() :
+                        p->type == PARAM_BOOL ? value.is<bool>() : value.is<int>();
+        if (!accepted) return false;
+        
+        lockState();
+        if (p->type == PARAM_COLOR) writeParamColor(*p, parseColor(value.as<const char*>()));
+        else if (p->type == PARAM_BOOL) writeParam(*p, value.as<bool>());
+        else writeParam(*p, value.as<int>());
+        markPending();
+        unlockState();
+        return true;
     }
     
     // ========================================================================
@@ -515,8 +694,12 @@ public:
     static uint8_t getCurrentEffect() { return currentEffect; }
     static bool isPoweredOn() { return powerOn; }
     static uint8_t getBrightness() { return brightness; }
+    // Bumped by every staged change (effect, params, brightness, power,
+    // segments, layers), so watchers can tell that something changed
+    static uint32_t getStateRevision() { return stateRevision; }
     static const char* getEffectName() { return effects[currentEffect].name; }
     static uint8_t getNumEffects() { return NUM_EFFECTS; }
+    static const EffectEntry& getEffect(uint8_t id) { return effects[id < NUM_EFFECTS ? id : 0]; }
     
     // Get current effect params as JSON
     static void getStatusJson(JsonDocument& doc) {
@@ -526,6 +709,23 @@ public:
         doc["effectName"] = effects[currentEffect].name;
         doc["category"] = effects[currentEffect].category;
         doc["numEffects"] = NUM_EFFECTS;
+        doc["segments"] = numSegments;
+        doc["layers"] = numLayers;
+        doc["transitioning"] = transitionActive;
+        doc["numLeds"] = ledCount;
+        doc["dataPin"] = outputs[0].pin;
+        JsonArray pins = doc["dataPins"].to<JsonArray>();
+        for (uint8_t i = 0; i < numOutputs; i++) {
+            pins.add(outputs[i].pin);
+        }
+        doc["renderUs"] = renderMicros;
+        doc["framesSkipped"] = skippedFrames;
+        doc["fps"] = achievedFps;
+        doc["fpsTarget"] = targetFps;
+        doc["showUs"] = showMicros;
+        doc["changeLatencyUs"] = changeLatencyMicros;
+        doc["changeLatencyMaxUs"] = changeLatencyMaxMicros;
+        doc["realtime"] = (bool)realtimeActive;
     }
     
     // Get all effects list as JSON
@@ -541,292 +741,285 @@ public:
     
     // Get parameters for current effect
     static void getParamsJson(JsonDocument& doc) {
-        // Return current effect's parameters
-        doc["effect"] = currentEffect;
+        getParamsJson(doc, currentEffect);
+    }
+    
+    static void getParamsJson(JsonDocument& doc, uint8_t effect) {
+        // Return the effect's parameters (as staged: what the API last set)
+        doc["effect"] = effect;
+        lockState();
+        writeParamsJson(doc["params"].to<JsonObject>(), effect);
+        unlockState();
+    }
+    
+    // Same into an object of the caller's document
+    static void copyParamsJson(JsonObject params, uint8_t effect) {
+        lockState();
+        writeParamsJson(params, effect);
+        unlockState();
+    }
+    
+    static void writeParamsJson(JsonObject params, uint8_t effect) {
+        if (effect >= NUM_PARAM_BLOCKS) return;
+        buildParamIndex();
+        const ParamRange& range = paramRange[effect];
+        for (uint8_t i = range.first; i < range.first + range.count; i++) {
+            const ParamDesc& p = paramTable[i];
+            if (!(p.flags & PARAM_ALIAS)) writeParamJson(params, p);
+        }
+    }
+    
+    // One parameter as getParamsJson reports it, under the key it was asked
+    // by (aliases included). Returns false if the effect has no such key.
+    static bool getParamJson(JsonObject params, const char* key, uint8_t effect) {
+        const ParamDesc* p = findParam(key, effect);
+        if (p == NULL) return false;
+        lockState();
+        writeParamJson(params, *p);
+        unlockState();
+        return true;
+    }
+    
+    // The params of `effect` whose staged value differs from `previous`
+    // (bytes from copyParams), as getParamsJson reports them. Returns how
+    // many were written.
+    static uint8_t getParamsDiffJson(JsonObject params, uint8_t effect, const uint8_t* previous) {
+        if (effect >= NUM_PARAM_BLOCKS) return 0;
+        buildParamIndex();
+        uint8_t changed = 0;
+        const ParamRange& range = paramRange[effect];
+        lockState();
+        for (uint8_t i = range.first; i < range.first + range.count; i++) {
+            const ParamDesc& p = paramTable[i];
+            if (p.flags & PARAM_ALIAS) continue;
+            if (memcmp(paramField(p), previous + p.offset, paramTypeSize(p.type)) != 0) {
+                writeParamJson(params, p);
+                changed++;
+            }
+        }
+        unlockState();
+        return changed;
+    }
+    
+    static void writeParamJson(JsonObject params, const ParamDesc& p) {
+        if (p.type == PARAM_COLOR) params[p.key] = colorToHex(readParamColor(p));
+        else if (p.type == PARAM_BOOL) params[p.key] = (bool)readParam(p);
+        else params[p.key] = readParam(p);
+    }
+
+    // ========================================================================
+    // Effect Instances
+    // ========================================================================
+    
+    // Start `effect` in `inst` (stopping what ran there) with state sized for
+    // the current render span. On allocation failure the instance keeps the
+    // effect but draws nothing, so the caller does not retry every frame.
+    static bool startEffect(EffectInstance& inst, uint8_t effect) {
+        stopEffect(inst);
+        if (effect >= NUM_EFFECTS) return false;
         
-        JsonObject params = doc["params"].to<JsonObject>();
+        const EffectEntry& type = effects[effect];
+        inst.effect = effect;
+        inst.time.frame = 0;
+        inst.wakeAt = micros();
+        if (type.stateSize == 0) return true;
         
-        // Add params based on current effect
-        // This is a simplified version - full implementation would map all params
-        switch (currentEffect) {
-            case 0: // Solid
-                params["color"] = colorToHex(solidParams.color);
-                break;
-            case 1: // Gradient
-                params["colorStart"] = colorToHex(gradientParams.colorStart);
-                params["colorMiddle"] = colorToHex(gradientParams.colorMiddle);
-                params["colorEnd"] = colorToHex(gradientParams.colorEnd);
-                params["style"] = gradientParams.style;
-                params["threePoint"] = gradientParams.threePoint;
-                break;
-            case 2: // Spots
-                params["color"] = colorToHex(spotsParams.color);
-                params["spread"] = spotsParams.spread;
-                params["width"] = spotsParams.width;
-                params["fade"] = spotsParams.fade;
-                break;
-            case 3: // Pattern
-                params["colorFg"] = colorToHex(patternParams.colorFg);
-                params["colorBg"] = colorToHex(patternParams.colorBg);
-                params["fgSize"] = patternParams.fgSize;
-                params["bgSize"] = patternParams.bgSize;
-                break;
-            case 4: // Rainbow Wave
-                params["speed"] = rainbowWaveParams.speed;
-                params["size"] = rainbowWaveParams.size;
-                params["saturation"] = rainbowWaveParams.saturation;
-                break;
-            case 5: // Color Wave
-                params["color1"] = colorToHex(colorWaveParams.colors[0]);
-                params["color2"] = colorToHex(colorWaveParams.colors[1]);
-                params["color3"] = colorToHex(colorWaveParams.colors[2]);
-                params["color4"] = colorToHex(colorWaveParams.colors[3]);
-                params["color5"] = colorToHex(colorWaveParams.colors[4]);
-                params["color6"] = colorToHex(colorWaveParams.colors[5]);
-                params["color7"] = colorToHex(colorWaveParams.colors[6]);
-                params["color8"] = colorToHex(colorWaveParams.colors[7]);
-                params["numColors"] = colorWaveParams.numColors;
-                params["direction"] = colorWaveParams.direction;
-                params["speed"] = colorWaveParams.speed;
-                break;
-            case 6: // Oscillate
-                params["colorPrimary"] = colorToHex(oscillateParams.colorPrimary);
-                params["colorSecondary"] = colorToHex(oscillateParams.colorSecondary);
-                params["speed"] = oscillateParams.speed;
-                params["pointSize"] = oscillateParams.pointSize;
-                break;
-            case 7: // Wavy
-                params["palette"] = wavyParams.palette;
-                params["speed"] = wavyParams.speed;
-                params["amplitude"] = wavyParams.amplitude;
-                params["frequency"] = wavyParams.frequency;
-                break;
-            case 8: // Theater Chase
-                params["color"] = colorToHex(theaterChaseParams.color);
-                params["speed"] = theaterChaseParams.speed;
-                params["gapSize"] = theaterChaseParams.gapSize;
-                params["rainbowMode"] = theaterChaseParams.rainbowMode;
-                break;
-            case 9: // Scanner
-                params["color1"] = colorToHex(scannerParams.colors[0]);
-                params["color2"] = colorToHex(scannerParams.colors[1]);
-                params["color3"] = colorToHex(scannerParams.colors[2]);
-                params["color4"] = colorToHex(scannerParams.colors[3]);
-                params["color5"] = colorToHex(scannerParams.colors[4]);
-                params["color6"] = colorToHex(scannerParams.colors[5]);
-                params["color7"] = colorToHex(scannerParams.colors[6]);
-                params["color8"] = colorToHex(scannerParams.colors[7]);
-                params["speed"] = scannerParams.speed;
-                params["numDots"] = scannerParams.numDots;
-                params["trailLength"] = scannerParams.trailLength;
-                params["dualMode"] = scannerParams.dualMode;
-                break;
-            case 10: // Comet
-                params["color"] = colorToHex(cometParams.color);
-                params["sparkleColor"] = colorToHex(cometParams.sparkleColor);
-                params["speed"] = cometParams.speed;
-                params["trailLength"] = cometParams.trailLength;
-                params["sparkleEnabled"] = cometParams.sparkleEnabled;
-                params["direction"] = cometParams.direction;
-                break;
-            case 11: // Running Lights
-                params["color1"] = colorToHex(runningLightsParams.colors[0]);
-                params["color2"] = colorToHex(runningLightsParams.colors[1]);
-                params["color3"] = colorToHex(runningLightsParams.colors[2]);
-                params["color4"] = colorToHex(runningLightsParams.colors[3]);
-                params["numColors"] = runningLightsParams.numColors;
-                params["speed"] = runningLightsParams.speed;
-                params["waveWidth"] = runningLightsParams.waveWidth;
-                params["shape"] = runningLightsParams.shape;
-                params["dualMode"] = runningLightsParams.dualMode;
-                break;
-            case 12: // Android
-                params["colorPrimary"] = colorToHex(androidParams.colorPrimary);
-                params["colorSecondary"] = colorToHex(androidParams.colorSecondary);
-                params["speed"] = androidParams.speed;
-                params["sectionWidth"] = androidParams.sectionWidth;
-                break;
-            case 13: // Twinkle
-                params["palette"] = twinkleParams.palette;
-                params["twinkleColor"] = colorToHex(twinkleParams.twinkleColor);
-                params["speed"] = twinkleParams.speed;
-                params["intensity"] = twinkleParams.intensity;
-                params["fadeSpeed"] = twinkleParams.fadeSpeed;
-                params["colorMode"] = twinkleParams.colorMode;
-                break;
-            case 14: // TwinkleFox
-                params["palette"] = twinkleFoxParams.palette;
-                params["speed"] = twinkleFoxParams.speed;
-                params["twinkleRate"] = twinkleFoxParams.twinkleRate;
-                break;
-            case 15: // Sparkle
-                params["colorSpark"] = colorToHex(sparkleParams.colorSpark);
-                params["colorBg"] = colorToHex(sparkleParams.colorBg);
-                params["speed"] = sparkleParams.speed;
-                params["intensity"] = sparkleParams.intensity;
-                params["overlay"] = sparkleParams.overlay;
-                params["darkMode"] = sparkleParams.darkMode;
-                break;
-            case 16: // Glitter
-                params["intensity"] = glitterParams.intensity;
-                params["rainbowBg"] = glitterParams.rainbowBg;
-                params["colorBg"] = colorToHex(glitterParams.bgColor);
-                params["overlay"] = glitterParams.overlay;
-                break;
-            case 17: // Starry Night
-                params["speed"] = starryNightParams.speed;
-                params["density"] = starryNightParams.density;
-                params["colorStars"] = colorToHex(starryNightParams.colorStars);
-                params["shootingStars"] = starryNightParams.shootingStars;
-                break;
-            case 18: // Fire
-                params["cooling"] = fireParams.cooling;
-                params["sparking"] = fireParams.sparking;
-                params["boost"] = fireParams.boost;
-                params["palette"] = fireParams.palette;
-                break;
-            case 19: // Candle
-                params["speed"] = candleParams.speed;
-                params["intensity"] = candleParams.intensity;
-                params["multiMode"] = candleParams.multiMode;
-                params["color"] = colorToHex(candleParams.color);
-                params["colorShift"] = candleParams.colorShift;
-                break;
-            case 20: // FireFlicker
-                params["speed"] = fireFlickerParams.speed;
-                params["intensity"] = fireFlickerParams.intensity;
-                params["color"] = colorToHex(fireFlickerParams.color);
-                break;
-            case 21: // Lava
-                params["speed"] = lavaParams.speed;
-                params["blobSize"] = lavaParams.blobSize;
-                params["smoothness"] = lavaParams.smoothness;
-                break;
-            case 22: // Aurora
-                params["speed"] = auroraParams.speed;
-                params["intensity"] = auroraParams.intensity;
-                params["palette"] = auroraParams.palette;
-                break;
-            case 23: // Pacifica
-                params["speed"] = pacificaParams.speed;
-                params["palette"] = pacificaParams.palette;
-                break;
-            case 24: // Lake
-                params["speed"] = lakeParams.speed;
-                params["palette"] = lakeParams.palette;
-                break;
-            case 25: // Fairy
-                params["speed"] = fairyParams.speed;
-                params["numFlashers"] = fairyParams.numFlashers;
-                params["colorMode"] = fairyParams.colorMode;
-                params["palette"] = fairyParams.palette;
-                break;
-            case 26: // ChristmasChase
-                params["speed"] = christmasChaseParams.speed;
-                params["color1"] = colorToHex(christmasChaseParams.color1);
-                params["color2"] = colorToHex(christmasChaseParams.color2);
-                params["pattern"] = christmasChaseParams.pattern;
-                break;
-            case 27: // HalloweenEyes
-                params["duration"] = halloweenEyesParams.duration / 10;
-                params["fadeTime"] = halloweenEyesParams.fadeTime / 5;
-                params["color"] = colorToHex(halloweenEyesParams.color);
-                params["overlay"] = halloweenEyesParams.overlay;
-                break;
-            case 28: // Fireworks
-                params["chance"] = fireworksParams.chance;
-                params["fragments"] = fireworksParams.fragments;
-                params["gravity"] = fireworksParams.gravity;
-                params["overlay"] = fireworksParams.overlay;
-                break;
-            case 29: // SnowSparkle
-                params["speed"] = snowSparkleParams.speed;
-                params["density"] = snowSparkleParams.density;
-                params["color"] = colorToHex(snowSparkleParams.color);
-                params["direction"] = snowSparkleParams.direction;
-                break;
-            case 30: // BouncingBalls
-                params["gravity"] = bouncingBallsParams.gravity;
-                params["numBalls"] = bouncingBallsParams.numBalls;
-                params["trail"] = bouncingBallsParams.trail;
-                params["palette"] = bouncingBallsParams.palette;
-                break;
-            case 31: // Popcorn
-                params["speed"] = popcornParams.speed;
-                params["intensity"] = popcornParams.intensity;
-                params["palette"] = popcornParams.palette;
-                break;
-            case 32: // Drip
-                params["gravity"] = dripParams.gravity;
-                params["numDrips"] = dripParams.numDrips;
-                params["color"] = colorToHex(dripParams.color);
-                params["overlay"] = dripParams.overlay;
-                break;
-            case 33: // Plasma
-                params["phase"] = plasmaParams.phase;
-                params["intensity"] = plasmaParams.intensity;
-                params["speed"] = plasmaParams.speed;
-                break;
-            case 34: // Lightning
-                params["frequency"] = lightningParams.frequency;
-                params["intensity"] = lightningParams.intensity;
-                params["color"] = colorToHex(lightningParams.color);
-                params["overlay"] = lightningParams.overlay;
-                break;
-            case 35: // Matrix
-                params["speed"] = matrixParams.speed;
-                params["spawningRate"] = matrixParams.spawningRate;
-                params["trailLength"] = matrixParams.trailLength;
-                params["color"] = colorToHex(matrixParams.color);
-                break;
-            case 36: // Heartbeat
-                params["bpm"] = heartbeatParams.bpm;
-                params["color"] = colorToHex(heartbeatParams.color);
-                break;
-            case 37: // Breathe
-                params["speed"] = breatheParams.speed;
-                params["colorPrimary"] = colorToHex(breatheParams.colorPrimary);
-                params["colorSecondary"] = colorToHex(breatheParams.colorSecondary);
-                params["twoColor"] = breatheParams.twoColor;
-                break;
-            case 38: // Dissolve
-                params["repeatSpeed"] = dissolveParams.repeatSpeed;
-                params["dissolveSpeed"] = dissolveParams.dissolveSpeed;
-                params["randomColors"] = dissolveParams.randomColors;
-                params["color"] = colorToHex(dissolveParams.color);
-                break;
-            case 39: // Fade
-                params["speed"] = fadeParams.speed;
-                params["color1"] = colorToHex(fadeParams.colors[0]);
-                params["color2"] = colorToHex(fadeParams.colors[1]);
-                params["color3"] = colorToHex(fadeParams.colors[2]);
-                params["color4"] = colorToHex(fadeParams.colors[3]);
-                params["color5"] = colorToHex(fadeParams.colors[4]);
-                params["color6"] = colorToHex(fadeParams.colors[5]);
-                params["color7"] = colorToHex(fadeParams.colors[6]);
-                params["color8"] = colorToHex(fadeParams.colors[7]);
-                params["numColors"] = fadeParams.numColors;
-                params["loop"] = fadeParams.loop;
-                break;
-            case 40: // Police
-                params["speed"] = policeLightsParams.speed;
-                params["color1"] = colorToHex(policeLightsParams.color1);
-                params["color2"] = colorToHex(policeLightsParams.color2);
-                params["style"] = policeLightsParams.style;
-                break;
-            case 41: // Strobe
-                params["frequency"] = strobeParams.frequency;
-                params["color"] = colorToHex(strobeParams.color);
-                params["mode"] = strobeParams.mode;
-                break;
-            default:
-                break;
+        inst.state = heap_caps_calloc(1, type.stateSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (inst.state == NULL) {
+            LOG_PRINTF("WARN ", "No memory for %s", type.name);
+            return false;
         }
+        type.init(inst.state);
+        return true;
     }
-
+    
+    // Destroy the instance's state; safe on a stopped instance
+    static void stopEffect(EffectInstance& inst) {
+        if (inst.state != NULL) {
+            effects[inst.effect].teardown(inst.state);
+            heap_caps_free(inst.state);
+            inst.state = NULL;
+        }
+        inst.effect = NO_EFFECT;
+    }
+    
+    // Render one frame of the instance on the current render span and its
+    // own timebase. Returns micros until it wants the next one.
+    static uint32_t renderEffect(EffectInstance& inst) {
+        const EffectEntry& type = effects[inst.effect];
+        if (type.stateSize > 0 && inst.state == NULL) return EFFECT_NO_CHANGE;
+        effectTime = inst.time;
+        tickEffectTime();
+        uint32_t next = type.render(inst.state);
+        inst.time = effectTime;
+        return next;
+    }
+    
+    // ========================================================================
+    // Realtime Input
+    // ========================================================================
+    // An external sequencer (RealtimeReceiver) writes pixels straight into
+    // the render buffer. The effects are suspended from the first realtime
+    // frame until none has come for LED_REALTIME_TIMEOUT_MS; then the running
+    // effect takes over again. Segments, transitions and layers do not apply
+    // to realtime frames; brightness and power do.
+    
+    // The render buffer (getNumLeds() pixels, RGB), to be written in place
+    // until endRealtimeFrame(). Excludes the render task meanwhile.
+    static CRGB* beginRealtimeFrame() {
+        lockFrame();
+        if (!realtimeActive) {
+            realtimeActive = true;
+            fill_solid(frameLeds, ledCount, CRGB::Black);
+            LOG_INFO("Realtime input started - effects suspended");
+        }
+        realtimeLastFrame = millis();
+        return frameLeds;
+    }
+    
+    // `show`: the frame is complete, send it now (dropped while off)
+    static void endRealtimeFrame(bool show) {
+        if (show && framePower) presentFrame();
+        unlockFrame();
+    }
+    
+    static bool isRealtimeActive() { return realtimeActive; }
+    
+    // ========================================================================
+    // Render Loop
+    // ========================================================================
+    
+    // Render and show one frame (one iteration of ledTask).
+    // Public so host-native tools can drive the loop frame by frame.
+    static void renderFrame() {
+        lockFrame();
+        drawFrame();
+        unlockFrame();
+    }
+    
 private:
+    static void drawFrame() {
+        if (!effectReady) return;
+        
+        // Everything the API changed since the last frame, in one go
+        if (statePending) applyPendingState();
+        
+        // Power off: push one black frame, leave leds[] for power on
+        if (!framePower) {
+            if (!outputBlanked) {
+                presentFrame(true);
+                outputBlanked = true;
+            }
+            changeInFlight = false;  // Changes made while off are never shown
+            return;
+        }
+        outputBlanked = false;
+        
+        // Realtime input owns the pixels until it goes quiet
+        if (realtimeActive) {
+            if (millis() - realtimeLastFrame < LED_REALTIME_TIMEOUT_MS) return;
+            realtimeActive = false;
+            frameDirty = true;
+            LOG_INFO("Realtime input timed out - effects resumed");
+        }
+        
+        uint32_t renderStart = micros();
+        
+        // Params, brightness or power changed: every effect renders now
+        bool force = frameDirty;
+        frameDirty = false;
+        
+        // Run the effects (current or each segment's, outgoing, layers) whose
+        // wake time has come; the others keep last frame's pixels
+        bool drew = false;
+        if (numActiveSegments > 0) {
+            drew = renderSegments(force);
+        } else if (activeEffect < NUM_EFFECTS) {
+            if (baseEffect.effect != activeEffect) startEffect(baseEffect, activeEffect);
+            drew = runEffect(baseEffect, force);
+        }
+        
+        if (transitionActive) {
+            renderTransition(force);
+            drew = true;
+        }
+        
+        if (numActiveLayers > 0) {
+            drew |= renderLayers(force);
+        }
+        
+        // Nothing due: the frame on the strip is still current, skip the show
+        if (!drew) {
+            skippedFrames++;
+            return;
+        }
+        
+        renderMicros = micros() - renderStart;
+        presentFrame();
+        updateFrameRate();
+        
+        frameCounter++;
+        lastFrameTime = millis();
+    }
+    
     static TaskHandle_t ledTaskHandle;
-    static uint8_t currentEffect;
+    static TaskHandle_t outputTaskHandle;
+    static SemaphoreHandle_t outputIdle;    // Given while the front buffer is free
+    static CRGB* outputLeds;                // Front buffer, owned by FastLED
+    static LedOutput outputs[LED_MAX_OUTPUTS];
+    static uint8_t numOutputs;
+    static Segment segments[LED_MAX_SEGMENTS];          // Configured (API side)
+    static uint8_t numSegments;
+    static volatile bool segmentsChanged;
+    static Segment activeSegments[LED_MAX_SEGMENTS];    // Rendering (task side)
+    static EffectInstance segmentEffects[LED_MAX_SEGMENTS];
+    static uint8_t numActiveSegments;
+    static Layer layers[LED_MAX_LAYERS];                // Configured (API side)
+    static uint8_t numLayers;
+    static volatile bool layersChanged;
+    static Layer activeLayers[LED_MAX_LAYERS];          // Rendering (task side)
+    static EffectInstance layerEffects[LED_MAX_LAYERS];
+    static CRGB* layerLeds[LED_MAX_LAYERS];
+    static uint8_t numActiveLayers;
+    static volatile uint8_t pendingTransition;          // Requested with the effect (API side)
+    static volatile uint16_t pendingTransitionMs;
+    static uint8_t activeEffect;                        // Whole-strip effect (task side)
+    static EffectInstance baseEffect;                   // Its instance, started on first render
+    static bool transitionActive;
+    static uint8_t transitionType;
+    static EffectInstance outgoingEffect;               // NO_EFFECT = frozen frame
+    static uint8_t transitionProgress;                  // 0-255 towards the new effect
+    static uint32_t transitionMicros;
+    static uint32_t transitionStart;
+    static CRGB* transitionLeds;                        // Outgoing picture
+    static bool outputBlanked;
+    static SemaphoreHandle_t frameLock;     // Render buffer: render task vs realtime input
+    static volatile bool realtimeActive;
+    static volatile uint32_t realtimeLastFrame;
+    static SemaphoreHandle_t stateLock;     // API-side state vs the frame boundary
+    static volatile bool statePending;      // API side changed since the last frame boundary
+    static volatile uint32_t stateRevision;
+    static uint8_t updateDepth;             // Open beginUpdate() calls
+    static uint32_t pendingSince;           // First change not yet taken by the task
+    static uint8_t frameBrightness;         // Brightness and power as of this frame (task side)
+    static bool framePower;
+    static bool changeInFlight;             // The next frame shown is the first with a change
+    static uint32_t changeStart;            // ...made at this time
+    static bool outputChangeInFlight;       // Same, for the frame on the wire
+    static uint32_t outputChangeStart;
+    static uint32_t changeLatencyMicros;    // API call to the end of the show reflecting it
+    static uint32_t changeLatencyMaxMicros;
+    static bool frameDirty;                 // Every effect renders this frame (task side)
+    static uint32_t skippedFrames;          // Frames with nothing due, neither rendered nor sent
+    static uint8_t targetFps;               // Governor output
+    static uint32_t framePeriodMicros;
+    static uint32_t frameCostMicros;        // Smoothed max(render, show)
+    static uint32_t fpsWindowStart;
+    static uint16_t fpsWindowFrames;
+    static uint16_t achievedFps;            // Frames shown over the last second
+    static uint32_t renderMicros;           // Last effect render + transition + layers
+    static uint32_t showMicros;             // Last transmission
+    static uint8_t currentEffect;           // Requested (API side)
     static uint8_t brightness;
     static bool powerOn;
     static bool effectChanged;
@@ -843,57 +1036,417 @@ private:
     // ========================================================================
     
     static void ledTask(void* params) {
-        const TickType_t frameDelay = pdMS_TO_TICKS(1000 / LED_TARGET_FPS);
         TickType_t lastWakeTime = xTaskGetTickCount();
         
-        // Crossfade state for smooth startup transition
-        static bool firstRun = true;
-        static uint16_t crossfadeProgress = 256;  // Start at 256 = no crossfade active
-        static CRGB previousLeds[ARGB_NUM_LEDS];
-        
         LOG_INFO("LED Task started on Core 0");
         
         while (true) {
-            if (powerOn && effectReady) {
-                // Handle effect change or first run
-                if (effectChanged) {
-                    if (firstRun) {
-                        // Save current LED state for crossfade
-                        memcpy(previousLeds, leds, sizeof(leds));
-                        crossfadeProgress = 0;  // Start crossfade
-                        firstRun = false;
-                    } else {
-                        // Normal effect change - clear LEDs
-                        FastLED.clear();
-                    }
-                    frameCounter = 0;
-                    effectChanged = false;
+            renderFrame();
+            
+            // Frame rate chosen by the governor, in whole ticks
+            TickType_t frameDelay = pdMS_TO_TICKS(framePeriodMicros / 1000);
+            vTaskDelayUntil(&lastWakeTime, frameDelay > 0 ? frameDelay : 1);
+        }
+    }
+    
+    // FastLED takes the data pin as a template argument: one instantiation
+    // per entry of LED_DATA_PINS (keep both lists in sync)
+    static void addOutput(uint8_t pin, CRGB* data, uint16_t count) {
+        #define LED_ADD_OUTPUT(p) \
+            FastLED.addLeds<WS2812, p, GRB>(data, count).setCorrection(TypicalLEDStrip)
+        switch (pin) {
+            case  1: LED_ADD_OUTPUT(1);  break;
+            case  2: LED_ADD_OUTPUT(2);  break;
+            case  3: LED_ADD_OUTPUT(3);  break;
+            case  4: LED_ADD_OUTPUT(4);  break;
+            case  5: LED_ADD_OUTPUT(5);  break;
+            case  6: LED_ADD_OUTPUT(6);  break;
+            case  7: LED_ADD_OUTPUT(7);  break;
+            case  8: LED_ADD_OUTPUT(8);  break;
+            case 43: LED_ADD_OUTPUT(43); break;
+            default: LED_ADD_OUTPUT(ARGB_DATA_PIN); break;
+        }
+        #undef LED_ADD_OUTPUT
+    }
+    
+    static void outputTask(void* params) {
+        LOG_INFO("LED Output Task started on Core 0");
+        
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            uint32_t start = micros();
+            FastLED.show();
+            showMicros = micros() - start;
+            if (outputChangeInFlight) recordChangeLatency(outputChangeStart);
+            xSemaphoreGive(outputIdle);
+        }
+    }
+    
+    static uint16_t segmentRenderLength(const Segment& seg) {
+        return seg.mirror ? (seg.length + 1) / 2 : seg.length;
+    }
+    
+    // Render the instance on the current span if its wake time is within
+    // half a frame (or `force`), and schedule it from what it returns. Even
+    // a static effect is rendered again after LED_STATIC_REFRESH_MS to
+    // repair a frame garbled on the wire. True if it rendered.
+    static bool runEffect(EffectInstance& inst, bool force) {
+        uint32_t now = micros();
+        if (!force && (int32_t)(now + framePeriodMicros / 2 - inst.wakeAt) < 0) return false;
+        uint32_t next = renderEffect(inst);
+        inst.wakeAt = now + min(next, (uint32_t)(LED_STATIC_REFRESH_MS * 1000UL));
+        return true;
+    }
+    
+    // Each segment draws into its slice with its own instance. True if any
+    // segment rendered.
+    static bool renderSegments(bool force) {
+        bool drew = false;
+        for (uint8_t i = 0; i < numActiveSegments; i++) {
+            const Segment& seg = activeSegments[i];
+            setRenderSpan(seg.start, segmentRenderLength(seg));
+            drew |= runEffect(segmentEffects[i], force);
+        }
+        resetRenderSpan();
+        return drew;
+    }
+    
+    static uint8_t effectMinFps(uint8_t effect) {
+        return effects[effect].minFps ? effects[effect].minFps : LED_MIN_FPS;
+    }
+    
+    static uint8_t effectMaxFps(uint8_t effect) {
+        return min(effects[effect].maxFps ? effects[effect].maxFps : LED_TARGET_FPS, LED_MAX_FPS);
+    }
+    
+    // Frame-rate range covering every effect drawn this frame: the fastest
+    // of them sets both ends
+    static void sceneFpsRange(uint8_t& minFps, uint8_t& maxFps) {
+        uint8_t drawn[2 + LED_MAX_SEGMENTS + LED_MAX_LAYERS];
+        uint8_t n = 0;
+        if (numActiveSegments == 0) drawn[n++] = activeEffect;
+        for (uint8_t i = 0; i < numActiveSegments; i++) drawn[n++] = activeSegments[i].effect;
+        for (uint8_t i = 0; i < numActiveLayers; i++) drawn[n++] = activeLayers[i].effect;
+        if (transitionActive && outgoingEffect.effect != NO_EFFECT) drawn[n++] = outgoingEffect.effect;
+        
+        minFps = 1;
+        maxFps = 1;
+        for (uint8_t i = 0; i < n; i++) {
+            minFps = max(minFps, effectMinFps(drawn[i]));
+            maxFps = max(maxFps, effectMaxFps(drawn[i]));
+        }
+        minFps = min(minFps, maxFps);
+    }
+    
+    // Frame-rate governor, run after every shown frame. Picks the fastest
+    // rate the drawn effects can use while frame work stays within
+    // LED_FPS_LOAD_PCT of the period, and spends the whole period if that
+    // is what holding their minimum takes. Render and transmission overlap,
+    // so the slower of the two is the frame cost.
+    static void updateFrameRate() {
+        uint32_t now = micros();
+        fpsWindowFrames++;
+        if (now - fpsWindowStart >= 1000000UL) {
+            achievedFps = (uint64_t)fpsWindowFrames * 1000000UL / (now - fpsWindowStart);
+            fpsWindowFrames = 0;
+            fpsWindowStart = now;
+        }
+        
+        frameCostMicros = (frameCostMicros * 7 + max(renderMicros, showMicros)) / 8;
+        
+        uint8_t minFps, maxFps;
+        sceneFpsRange(minFps, maxFps);
+        uint32_t fps = maxFps;
+        if (frameCostMicros > 0) {
+            fps = min(fps, (uint32_t)(1000000UL / 100 * LED_FPS_LOAD_PCT / frameCostMicros));
+            if (fps < minFps) fps = min((uint32_t)minFps, (uint32_t)(1000000UL / frameCostMicros));
+        }
+        targetFps = max(fps, (uint32_t)1);
+        framePeriodMicros = 1000000UL / targetFps;
+    }
+    
+    // Start the switch from the picture on the strip to currentEffect. The
+    // whole-strip instance moves to outgoingEffect and keeps rendering into
+    // transitionLeds until the window closes, so even the same effect
+    // restarts with a transition; anything else (startup frame, segment
+    // layout) fades out as a frozen copy of the last frame shown. The new
+    // instance starts on the next render.
+    static void beginTransition(bool frozen) {
+        uint32_t durationMicros = pendingTransitionMs * 1000UL;
+        activeEffect = currentEffect;
+        stopEffect(outgoingEffect);
+        
+        if (transitionLeds == NULL && durationMicros > 0) transitionLeds = allocPixelBuffer<CRGB>();
+        transitionActive = transitionLeds != NULL && durationMicros > 0 &&
+                           (frozen || baseEffect.effect != NO_EFFECT);
+        if (transitionActive) {
+            if (frozen) {
+                memcpy(transitionLeds, outputLeds, sizeof(CRGB) * ledCount);
+            } else {
+                memcpy(transitionLeds, frameLeds, sizeof(CRGB) * ledCount);
+                outgoingEffect = baseEffect;
+                baseEffect.effect = NO_EFFECT;
+                baseEffect.state = NULL;
+            }
+            transitionType = pendingTransition;
+            transitionMicros = durationMicros;
+            transitionStart = micros();
+            transitionProgress = 0;
+        }
+        
+        stopEffect(baseEffect);
+        clearLeds();
+    }
+    
+    // Advance the window on wall time and draw the outgoing instance. It is
+    // destroyed once the window has closed.
+    static void renderTransition(bool force) {
+        uint32_t elapsed = micros() - transitionStart;
+        if (elapsed >= transitionMicros) {
+            transitionActive = false;
+            stopEffect(outgoingEffect);
+            return;
+        }
+        transitionProgress = (uint64_t)elapsed * 255 / transitionMicros;
+        if (outgoingEffect.effect == NO_EFFECT) return;
+        
+        setRenderSpan(transitionLeds, ledCount);
+        runEffect(outgoingEffect, force);
+        resetRenderSpan();
+    }
+    
+    // Order in which pixels switch during a dissolve: a fixed scramble of the index
+    static uint8_t dissolveRank(uint16_t i) {
+        return (uint32_t)(i * 2654435761u) >> 24;
+    }
+    
+    // Put the outgoing picture back over the new frame by progress, in place
+    static void mixTransition() {
+        uint8_t p = transitionProgress;
+        switch (transitionType) {
+            case TRANSITION_WIPE: {
+                uint16_t edge = (uint32_t)ledCount * p / 255;
+                memcpy(outputLeds + edge, transitionLeds + edge, sizeof(CRGB) * (ledCount - edge));
+                break;
+            }
+            case TRANSITION_DISSOLVE:
+                for (uint16_t i = 0; i < ledCount; i++) {
+                    if (dissolveRank(i) >= p) outputLeds[i] = transitionLeds[i];
                 }
-                
-                // Execute current effect into leds[]
-                if (currentEffect < NUM_EFFECTS) {
-                    effects[currentEffect].func();
+                break;
+            default:
+                for (uint16_t i = 0; i < ledCount; i++) {
+                    outputLeds[i] = blend(transitionLeds[i], outputLeds[i], p);
                 }
-                
-                // Apply crossfade if in progress (0-255)
-                if (crossfadeProgress < 256) {
-                    uint8_t blendAmount = (crossfadeProgress > 255) ? 255 : crossfadeProgress;
-                    for (uint16_t i = 0; i < ARGB_NUM_LEDS; i++) {
-                        leds[i] = blend(previousLeds[i], leds[i], blendAmount);
-                    }
-                    crossfadeProgress += 8;  // ~30 frames = 500ms crossfade
+                break;
+        }
+    }
+    
+    // Each layer draws the whole strip into its own buffer with its own
+    // instance. True if any layer rendered.
+    static bool renderLayers(bool force) {
+        bool drew = false;
+        for (uint8_t i = 0; i < numActiveLayers; i++) {
+            setRenderSpan(layerLeds[i], ledCount);
+            drew |= runEffect(layerEffects[i], force);
+        }
+        resetRenderSpan();
+        return drew;
+    }
+    
+    static CRGB blendLayerPixel(const CRGB& base, CRGB top, const Layer& layer) {
+        if (layer.mode == BLEND_ALPHA) {
+            uint8_t coverage = scale8(max(top.r, max(top.g, top.b)), layer.opacity);
+            return blend(base, top, coverage);
+        }
+        if (layer.opacity < 255) top.nscale8(layer.opacity);
+        switch (layer.mode) {
+            case BLEND_SCREEN:
+                return CRGB(base.r + scale8(top.r, 255 - base.r),
+                            base.g + scale8(top.g, 255 - base.g),
+                            base.b + scale8(top.b, 255 - base.b));
+            case BLEND_MAX:
+                return CRGB(max(base.r, top.r), max(base.g, top.g), max(base.b, top.b));
+            default:
+                return base + top;
+        }
+    }
+    
+    // Merge every layer onto the front buffer in one pass, bottom to top
+    static void compositeLayers() {
+        for (uint16_t p = 0; p < ledCount; p++) {
+            CRGB px = outputLeds[p];
+            for (uint8_t l = 0; l < numActiveLayers; l++) {
+                px = blendLayerPixel(px, layerLeds[l][p], activeLayers[l]);
+            }
+            outputLeds[p] = px;
+        }
+    }
+    
+    // Effects keep drawing in their own orientation (they read leds[] back),
+    // so reverse/mirror are applied on the way to the front buffer, followed
+    // by a running transition and the layers. Realtime frames go out as sent.
+    static void copyToOutput() {
+        if (realtimeActive) {
+            memcpy(outputLeds, frameLeds, sizeof(CRGB) * ledCount);
+            return;
+        }
+        if (numActiveSegments == 0) {
+            memcpy(outputLeds, frameLeds, sizeof(CRGB) * ledCount);
+        } else {
+            fill_solid(outputLeds, ledCount, CRGB::Black);
+            for (uint8_t s = 0; s < numActiveSegments; s++) {
+                const Segment& seg = activeSegments[s];
+                const CRGB* src = frameLeds + seg.start;
+                CRGB* dst = outputLeds + seg.start;
+                uint16_t n = segmentRenderLength(seg);
+                for (uint16_t i = 0; i < n; i++) {
+                    uint16_t pos = seg.reverse ? n - 1 - i : i;
+                    dst[pos] = src[i];
+                    if (seg.mirror) dst[seg.length - 1 - pos] = src[i];
                 }
-                
-                // Show LEDs
-                FastLED.show();
-                
-                frameCounter++;
-                lastFrameTime = millis();
             }
-            
-            // Maintain consistent frame rate
-            vTaskDelayUntil(&lastWakeTime, frameDelay);
         }
+        
+        if (transitionActive) {
+            mixTransition();
+        }
+        if (numActiveLayers > 0) {
+            compositeLayers();
+        }
+    }
+    
+    static void lockState() {
+        if (stateLock != NULL) xSemaphoreTake(stateLock, portMAX_DELAY);
+    }
+    
+    static void unlockState() {
+        if (stateLock != NULL) xSemaphoreGive(stateLock);
+    }
+    
+    static void lockFrame() {
+        if (frameLock != NULL) xSemaphoreTake(frameLock, portMAX_DELAY);
+    }
+    
+    static void unlockFrame() {
+        if (frameLock != NULL) xSemaphoreGive(frameLock);
+    }
+    
+    // API side, under the lock: something changed for the next frame
+    static void markPending() {
+        if (!statePending) pendingSince = micros();
+        statePending = true;
+        stateRevision++;
+    }
+    
+    // Frame boundary: take params, brightness and power, then the segment
+    // table, layer stack and effect switch, all under the state lock, so no
+    // frame mixes old and new API state (nor shows part of an update). Scene changes made while the power
+    // is off wait for power on.
+    static void applyPendingState() {
+        static bool firstRun = true;  // Startup frame still on the strip
+        
+        lockState();
+        if (updateDepth > 0) {
+            unlockState();  // Part of an update; the rest follows
+            return;
+        }
+        if (!changeInFlight) {
+            changeInFlight = true;
+            changeStart = pendingSince;
+        }
+        commitStagedParams();
+        frameBrightness = brightness;
+        framePower = powerOn;
+        frameDirty = true;
+        statePending = false;
+        
+        if (!framePower) {
+            statePending = segmentsChanged || layersChanged || effectChanged;
+            unlockState();
+            return;
+        }
+        
+        bool segmentsShown = numActiveSegments > 0;
+        
+        // New segment table
+        if (segmentsChanged) {
+            segmentsChanged = false;
+            for (uint8_t i = 0; i < numActiveSegments; i++) {
+                stopEffect(segmentEffects[i]);
+            }
+            numActiveSegments = numSegments;
+            memcpy(activeSegments, segments, sizeof(Segment) * numActiveSegments);
+            for (uint8_t i = 0; i < numActiveSegments; i++) {
+                setRenderSpan(activeSegments[i].start, segmentRenderLength(activeSegments[i]));
+                startEffect(segmentEffects[i], activeSegments[i].effect);
+            }
+            resetRenderSpan();
+            if (numActiveSegments > 0) stopEffect(baseEffect);
+            clearLeds();
+        }
+        
+        // New layer stack; layer buffers are allocated on first use and kept
+        if (layersChanged) {
+            layersChanged = false;
+            for (uint8_t i = 0; i < numActiveLayers; i++) {
+                stopEffect(layerEffects[i]);
+            }
+            numActiveLayers = 0;
+            for (uint8_t i = 0; i < numLayers; i++) {
+                if (layerLeds[i] == NULL) layerLeds[i] = allocPixelBuffer<CRGB>();
+                if (layerLeds[i] == NULL) {
+                    LOG_PRINTF("WARN ", "No memory for layer %d", i);
+                    break;
+                }
+                fill_solid(layerLeds[i], ledCount, CRGB::Black);
+                activeLayers[i] = layers[i];
+                startEffect(layerEffects[i], layers[i].effect);
+                numActiveLayers++;
+            }
+        }
+        
+        // Effect switch (first run: away from the startup frame)
+        if (effectChanged) {
+            effectChanged = false;
+            beginTransition(firstRun || segmentsShown || numActiveSegments > 0);
+            firstRun = false;
+            frameCounter = 0;
+        }
+        unlockState();
+    }
+    
+    // API call to the end of the first show that reflects it
+    static void recordChangeLatency(uint32_t start) {
+        changeLatencyMicros = micros() - start;
+        changeLatencyMaxMicros = max(changeLatencyMaxMicros, changeLatencyMicros);
+    }
+    
+    // Frame boundary: copy leds[] (or black) into the front buffer and hand it
+    // to the output task. Waits only while the previous frame is still on the
+    // wire. Before the output task exists (startup, host tools) this shows
+    // synchronously.
+    static void presentFrame(bool blank = false) {
+        if (outputTaskHandle == NULL) {
+            if (blank) fill_solid(outputLeds, ledCount, CRGB::Black);
+            else copyToOutput();
+            FastLED.setBrightness(frameBrightness);
+            uint32_t start = micros();
+            FastLED.show();
+            showMicros = micros() - start;
+            if (changeInFlight) recordChangeLatency(changeStart);
+            changeInFlight = false;
+            return;
+        }
+        
+        xSemaphoreTake(outputIdle, portMAX_DELAY);
+        if (blank) fill_solid(outputLeds, ledCount, CRGB::Black);
+        else copyToOutput();
+        FastLED.setBrightness(frameBrightness);
+        outputChangeInFlight = changeInFlight;
+        outputChangeStart = changeStart;
+        changeInFlight = false;
+        xTaskNotifyGive(outputTaskHandle);
     }
     
     // ========================================================================
@@ -911,78 +1464,6 @@ private:
         sprintf(buf, "#%02X%02X%02X", color.r, color.g, color.b);
         return String(buf);
     }
-    
-    static void applySpeedParam(uint8_t speed) {
-        // Apply speed to current effect's params
-        switch (currentEffect) {
-            case 4: rainbowWaveParams.speed = speed; break;
-            case 5: colorWaveParams.speed = speed; break;
-            case 6: oscillateParams.speed = speed; break;
-            case 7: wavyParams.speed = speed; break;
-            case 8: theaterChaseParams.speed = speed; break;
-            case 9: scannerParams.speed = speed; break;
-            case 10: cometParams.speed = speed; break;
-            case 11: runningLightsParams.speed = speed; break;
-            case 12: androidParams.speed = speed; break;
-            case 13: twinkleParams.speed = speed; break;
-            case 14: twinkleFoxParams.speed = speed; break;
-            case 15: sparkleParams.speed = speed; break;
-            case 17: starryNightParams.speed = speed; break;
-            case 19: candleParams.speed = speed; break;
-            case 20: fireFlickerParams.speed = speed; break;
-            case 21: lavaParams.speed = speed; break;
-            case 22: auroraParams.speed = speed; break;
-            case 23: pacificaParams.speed = speed; break;
-            case 24: lakeParams.speed = speed; break;
-            case 25: fairyParams.speed = speed; break;
-            case 26: christmasChaseParams.speed = speed; break;
-            case 29: snowSparkleParams.speed = speed; break;
-            case 31: popcornParams.speed = speed; break;
-            case 33: plasmaParams.speed = speed; break;
-            case 35: matrixParams.speed = speed; break;
-            case 37: breatheParams.speed = speed; break;
-            case 39: fadeParams.speed = speed; break;
-            case 40: policeLightsParams.speed = speed; break;
-            default: break;
-        }
-    }
-    
-    static void applyColorParam(CRGB color) {
-        switch (currentEffect) {
-            case 0: solidParams.color = color; break;
-            case 2: spotsParams.color = color; break;
-            case 8: theaterChaseParams.color = color; break;
-            case 9: scannerParams.colors[0] = color; break;
-            case 10: cometParams.color = color; break;
-            case 11: runningLightsParams.colors[0] = color; break;
-            case 19: candleParams.color = color; break;
-            case 20: fireFlickerParams.color = color; break;
-            case 27: halloweenEyesParams.color = color; break;
-            case 29: snowSparkleParams.color = color; break;
-            case 32: dripParams.color = color; break;
-            case 34: lightningParams.color = color; break;
-            case 35: matrixParams.color = color; break;
-            case 36: heartbeatParams.color = color; break;
-            case 38: dissolveParams.color = color; break;
-            case 41: strobeParams.color = color; break;
-            default: break;
-        }
-    }
-    
-    static void applyIntensityParam(uint8_t intensity) {
-        switch (currentEffect) {
-            case 13: twinkleParams.intensity = intensity; break;
-            case 15: sparkleParams.intensity = intensity; break;
-            case 16: glitterParams.intensity = intensity; break;
-            case 19: candleParams.intensity = intensity; break;
-            case 20: fireFlickerParams.intensity = intensity; break;
-            case 22: auroraParams.intensity = intensity; break;
-            case 31: popcornParams.intensity = intensity; break;
-            case 33: plasmaParams.intensity = intensity; break;
-            case 34: lightningParams.intensity = intensity; break;
-            default: break;
-        }
-    }
 };
 
 // ============================================================================
@@ -990,6 +1471,62 @@ private:
 // ============================================================================
 
 TaskHandle_t LEDController::ledTaskHandle = NULL;
+TaskHandle_t LEDController::outputTaskHandle = NULL;
+SemaphoreHandle_t LEDController::outputIdle = NULL;
+CRGB* LEDController::outputLeds = NULL;
+LEDController::LedOutput LEDController::outputs[LED_MAX_OUTPUTS];
+uint8_t LEDController::numOutputs = 0;
+LEDController::Segment LEDController::segments[LED_MAX_SEGMENTS];
+uint8_t LEDController::numSegments = 0;
+volatile bool LEDController::segmentsChanged = false;
+LEDController::Segment LEDController::activeSegments[LED_MAX_SEGMENTS];
+LEDController::EffectInstance LEDController::segmentEffects[LED_MAX_SEGMENTS];
+uint8_t LEDController::numActiveSegments = 0;
+LEDController::Layer LEDController::layers[LED_MAX_LAYERS];
+uint8_t LEDController::numLayers = 0;
+volatile bool LEDController::layersChanged = false;
+LEDController::Layer LEDController::activeLayers[LED_MAX_LAYERS];
+LEDController::EffectInstance LEDController::layerEffects[LED_MAX_LAYERS];
+CRGB* LEDController::layerLeds[LED_MAX_LAYERS] = {NULL};
+uint8_t LEDController::numActiveLayers = 0;
+volatile uint8_t LEDController::pendingTransition = LEDController::TRANSITION_FADE;
+volatile uint16_t LEDController::pendingTransitionMs = LED_TRANSITION_MS;
+uint8_t LEDController::activeEffect = 0;
+LEDController::EffectInstance LEDController::baseEffect;
+bool LEDController::transitionActive = false;
+uint8_t LEDController::transitionType = LEDController::TRANSITION_FADE;
+LEDController::EffectInstance LEDController::outgoingEffect;
+uint8_t LEDController::transitionProgress = 0;
+uint32_t LEDController::transitionMicros = 0;
+uint32_t LEDController::transitionStart = 0;
+CRGB* LEDController::transitionLeds = NULL;
+bool LEDController::outputBlanked = false;
+SemaphoreHandle_t LEDController::frameLock = NULL;
+volatile bool LEDController::realtimeActive = false;
+volatile uint32_t LEDController::realtimeLastFrame = 0;
+SemaphoreHandle_t LEDController::stateLock = NULL;
+volatile bool LEDController::statePending = false;
+volatile uint32_t LEDController::stateRevision = 0;
+uint8_t LEDController::updateDepth = 0;
+uint32_t LEDController::pendingSince = 0;
+uint8_t LEDController::frameBrightness = 180;
+bool LEDController::framePower = true;
+bool LEDController::changeInFlight = false;
+uint32_t LEDController::changeStart = 0;
+bool LEDController::outputChangeInFlight = false;
+uint32_t LEDController::outputChangeStart = 0;
+uint32_t LEDController::changeLatencyMicros = 0;
+uint32_t LEDController::changeLatencyMaxMicros = 0;
+bool LEDController::frameDirty = true;
+uint32_t LEDController::skippedFrames = 0;
+uint8_t LEDController::targetFps = LED_TARGET_FPS;
+uint32_t LEDController::framePeriodMicros = LED_FRAME_MICROS;
+uint32_t LEDController::frameCostMicros = 0;
+uint32_t LEDController::fpsWindowStart = 0;
+uint16_t LEDController::fpsWindowFrames = 0;
+uint16_t LEDController::achievedFps = 0;
+uint32_t LEDController::renderMicros = 0;
+uint32_t LEDController::showMicros = 0;
 uint8_t LEDController::currentEffect = 0;
 uint8_t LEDController::brightness = 180;
 bool LEDController::powerOn = true;
@@ -1001,64 +1538,64 @@ uint32_t LEDController::lastFrameTime = 0;
 // Effect function array
 const LEDController::EffectEntry LEDController::effects[] = {
     // Category 1: Static
-    {"Solid", effectSolid, 1},
-    {"Gradient", effectGradient, 1},
-    {"Spots", effectSpots, 1},
-    {"Pattern", effectPattern, 1},
+    {"Solid", EFFECT_TYPE(effectSolid, NoEffectState), 1},
+    {"Gradient", EFFECT_TYPE(effectGradient, NoEffectState), 1},
+    {"Spots", EFFECT_TYPE(effectSpots, NoEffectState), 1},
+    {"Pattern", EFFECT_TYPE(effectPattern, NoEffectState), 1},
     
     // Category 2: Wave/Fale
-    {"Rainbow Wave", effectRainbowWave, 2},
-    {"Color Wave", effectColorWave, 2},
-    {"Oscillate", effectOscillate, 2},
-    {"Wavy", effectWavy, 2},
+    {"Rainbow Wave", EFFECT_TYPE(effectRainbowWave, RainbowWaveState), 2},
+    {"Color Wave", EFFECT_TYPE(effectColorWave, ColorWaveState), 2},
+    {"Oscillate", EFFECT_TYPE(effectOscillate, OscillateState), 2},
+    {"Wavy", EFFECT_TYPE(effectWavy, WavyState), 2},
     
     // Category 3: Chase/Running
-    {"Theater Chase", effectTheaterChase, 3},
-    {"Scanner", effectScanner, 3},
-    {"Comet", effectComet, 3},
-    {"Running Lights", effectRunningLights, 3},
-    {"Android", effectAndroid, 3},
+    {"Theater Chase", EFFECT_TYPE(effectTheaterChase, TheaterChaseState), 3},
+    {"Scanner", EFFECT_TYPE(effectScanner, ScannerState), 3, 60, 120},
+    {"Comet", EFFECT_TYPE(effectComet, CometState), 3},
+    {"Running Lights", EFFECT_TYPE(effectRunningLights, RunningLightsState), 3},
+    {"Android", EFFECT_TYPE(effectAndroid, AndroidState), 3},
     
     // Category 4: Twinkle/Sparkle
-    {"Twinkle", effectTwinkle, 4},
-    {"TwinkleFox", effectTwinkleFox, 4},
-    {"Sparkle", effectSparkle, 4},
-    {"Glitter", effectGlitter, 4},
-    {"Starry Night", effectStarryNight, 4},
+    {"Twinkle", EFFECT_TYPE(effectTwinkle, TwinkleState), 4},
+    {"TwinkleFox", EFFECT_TYPE(effectTwinkleFox, TwinkleFoxState), 4},
+    {"Sparkle", EFFECT_TYPE(effectSparkle, SparkleState), 4},
+    {"Glitter", EFFECT_TYPE(effectGlitter, GlitterState), 4},
+    {"Starry Night", EFFECT_TYPE(effectStarryNight, StarryNightState), 4},
     
     // Category 5: Fire/Organic
-    {"Fire", effectFire, 5},
-    {"Candle", effectCandle, 5},
-    {"Fire Flicker", effectFireFlicker, 5},
-    {"Lava", effectLava, 5},
-    {"Aurora", effectAurora, 5},
-    {"Pacifica", effectPacifica, 5},
-    {"Lake", effectLake, 5},
+    {"Fire", EFFECT_TYPE(effectFire, FireState), 5},
+    {"Candle", EFFECT_TYPE(effectCandle, CandleState), 5},
+    {"Fire Flicker", EFFECT_TYPE(effectFireFlicker, NoEffectState), 5},
+    {"Lava", EFFECT_TYPE(effectLava, LavaState), 5},
+    {"Aurora", EFFECT_TYPE(effectAurora, AuroraState), 5},
+    {"Pacifica", EFFECT_TYPE(effectPacifica, PacificaState), 5},
+    {"Lake", EFFECT_TYPE(effectLake, LakeState), 5, 15, 30},
     
     // Category 6: Christmas/Seasonal
-    {"Fairy Lights", effectFairy, 6},
-    {"Christmas Chase", effectChristmasChase, 6},
-    {"Halloween Eyes", effectHalloweenEyes, 6},
-    {"Fireworks", effectFireworks, 6},
-    {"Snow Sparkle", effectSnowSparkle, 6},
+    {"Fairy Lights", EFFECT_TYPE(effectFairy, FairyState), 6},
+    {"Christmas Chase", EFFECT_TYPE(effectChristmasChase, ChristmasChaseState), 6},
+    {"Halloween Eyes", EFFECT_TYPE(effectHalloweenEyes, HalloweenEyesState), 6},
+    {"Fireworks", EFFECT_TYPE(effectFireworks, FireworksState), 6},
+    {"Snow Sparkle", EFFECT_TYPE(effectSnowSparkle, SnowSparkleState), 6},
     
     // Category 7: Special
-    {"Bouncing Balls", effectBouncingBalls, 7},
-    {"Popcorn", effectPopcorn, 7},
-    {"Drip", effectDrip, 7},
-    {"Plasma", effectPlasma, 7},
-    {"Lightning", effectLightning, 7},
-    {"Matrix", effectMatrix, 7},
-    {"Heartbeat", effectHeartbeat, 7},
+    {"Bouncing Balls", EFFECT_TYPE(effectBouncingBalls, BouncingBallsState), 7},
+    {"Popcorn", EFFECT_TYPE(effectPopcorn, PopcornState), 7},
+    {"Drip", EFFECT_TYPE(effectDrip, DripState), 7},
+    {"Plasma", EFFECT_TYPE(effectPlasma, PlasmaState), 7},
+    {"Lightning", EFFECT_TYPE(effectLightning, LightningState), 7},
+    {"Matrix", EFFECT_TYPE(effectMatrix, MatrixState), 7},
+    {"Heartbeat", EFFECT_TYPE(effectHeartbeat, HeartbeatState), 7},
     
     // Category 8: Breathing/Fade
-    {"Breathe", effectBreathe, 8},
-    {"Dissolve", effectDissolve, 8},
-    {"Fade", effectFade, 8},
+    {"Breathe", EFFECT_TYPE(effectBreathe, BreatheState), 8, 15, 30},
+    {"Dissolve", EFFECT_TYPE(effectDissolve, DissolveState), 8},
+    {"Fade", EFFECT_TYPE(effectFade, FadeState), 8},
     
     // Category 9: Alarm
-    {"Police Lights", effectPolice, 9},
-    {"Strobe", effectStrobe, 9}
+    {"Police Lights", EFFECT_TYPE(effectPolice, PoliceState), 9},
+    {"Strobe", EFFECT_TYPE(effectStrobe, StrobeState), 9, 60, 120}
 };
 
 const uint8_t LEDController::NUM_EFFECTS = sizeof(LEDController::effects) / sizeof(LEDController::effects[0]);
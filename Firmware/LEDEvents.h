@@ -0,0 +1,76 @@
+/*
+ * LEDEvents.h - Server-Sent Events push of the LED state
+ *
+ * Lets the app follow changes made elsewhere (another phone, a WebSocket
+ * client) without polling /api/led/status and /api/led/params.
+ */
+
+#ifndef LED_EVENTS_H
+#define LED_EVENTS_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "LEDStateDiff.h"
+
+// ============================================================================
+// LEDEvents - GET /api/led/events (text/event-stream)
+// ============================================================================
+// On connect:  event "state", the full state (LEDStateDiff.h)
+// On changes:  event "diff", what changed since the previous diff, at most
+//              once per SSE_MIN_INTERVAL_MS for all clients together
+// The event id is the state revision, so the browser's Last-Event-ID on
+// reconnect tells which revision the client held.
+// ============================================================================
+
+class LEDEvents {
+public:
+    static void begin(AsyncWebServer* server) {
+        tracker.begin();
+        events.onConnect(onConnect);
+        server->addHandler(&events);
+        LOG_INFO("  SSE  /api/led/events");
+    }
+
+    // Push the coalesced diff when one is due (loop()). Tracked with no
+    // client as well, so a client joining later only gets newer diffs.
+    static void loop() {
+        StaticJsonDocument<SSE_MAX_EVENT> doc;
+        if (!tracker.takeDiff(doc.to<JsonObject>())) return;
+        if (events.count() > 0) send(NULL, doc, "diff");
+    }
+
+    static uint32_t getClientCount() { return events.count(); }
+    static uint32_t getEventCount() { return tracker.getReports(); }
+
+private:
+    static AsyncEventSource events;
+    static LEDStateDiff tracker;
+
+    static void onConnect(AsyncEventSourceClient* client) {
+        StaticJsonDocument<SSE_MAX_EVENT> doc;
+        LEDStateDiff::writeState(doc.to<JsonObject>());
+        send(client, doc, "state");
+    }
+
+    // To one client, or to all with client == NULL
+    static void send(AsyncEventSourceClient* client, JsonDocument& doc, const char* event) {
+        char buf[SSE_MAX_EVENT];
+        size_t len = measureJson(doc);
+        if (len >= sizeof(buf)) {
+            LOG_PRINTF("WARN ", "SSE event of %u bytes dropped", (unsigned)len);
+            return;
+        }
+        serializeJson(doc, buf, sizeof(buf));
+        uint32_t id = doc["rev"].as<uint32_t>();
+        if (client) client->send(buf, event, id);
+        else events.send(buf, event, id);
+    }
+};
+
+AsyncEventSource LEDEvents::events("/api/led/events");
+LEDStateDiff LEDEvents::tracker;
+
+#endif // LED_EVENTS_H
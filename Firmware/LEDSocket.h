@@ -0,0 +1,140 @@
+/*
+ * LEDSocket.h - WebSocket control channel
+ *
+ * Persistent connection for live control (sliders, color pickers): one text
+ * frame per control message instead of an HTTP request per change.
+ */
+
+#ifndef LED_SOCKET_H
+#define LED_SOCKET_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "LEDController.h"
+#include "LEDCommands.h"
+#include "LEDStateDiff.h"
+
+// ============================================================================
+// LEDSocket - /api/led/ws
+// ============================================================================
+// Client -> device, one LEDCommands message per text frame plus an optional
+// sequence number:
+//   {"seq": 17, "params": {"speed": 120}}
+// Device -> sender:   {"ack": 17, "ok": true, "rejected": [...]}
+//                     {"ack": 17, "ok": false, "error": "..."}
+// Device -> everyone: {"state": {...}} with what the message changed (the
+//                     sender included, so it sees clamped values)
+// On connect the client gets {"state": {...}} with the revision, power,
+// brightness, effect and its params (LEDStateDiff::writeState).
+// Messages are parsed and answered from stack buffers; the only heap
+// allocation per message is the library's send buffer, shared by all
+// clients for a push.
+// ============================================================================
+
+class LEDSocket {
+public:
+    static void begin(AsyncWebServer* server) {
+        ws.onEvent(onEvent);
+        server->addHandler(&ws);
+        LOG_INFO("  WS   /api/led/ws");
+    }
+
+    // Release closed clients and drop the oldest over the limit (loop())
+    static void loop() {
+        ws.cleanupClients(WS_MAX_CLIENTS);
+    }
+
+    static uint32_t getClientCount() { return ws.count(); }
+    static uint32_t getMessageCount() { return messages; }
+
+private:
+    static AsyncWebSocket ws;
+    static uint32_t messages;
+
+    static void onEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                        void* arg, uint8_t* data, size_t len) {
+        switch (type) {
+            case WS_EVT_CONNECT:
+                LOG_PRINTF("INFO ", "WS client #%u connected", client->id());
+                sendState(client);
+                break;
+            case WS_EVT_DISCONNECT:
+                LOG_PRINTF("INFO ", "WS client #%u disconnected", client->id());
+                break;
+            case WS_EVT_DATA: {
+                // Control messages are small: whole single-frame text only
+                AwsFrameInfo* info = (AwsFrameInfo*)arg;
+                if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT ||
+                    len >= WS_MAX_MESSAGE) {
+                    sendError(client, 0, "Unsupported frame");
+                    break;
+                }
+                handleMessage(client, (const char*)data, len);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    static void handleMessage(AsyncWebSocketClient* client, const char* data, size_t len) {
+        messages++;
+
+        StaticJsonDocument<WS_MAX_MESSAGE> msg;
+        if (deserializeJson(msg, data, len) || !msg.is<JsonObject>()) {
+            sendError(client, 0, "Invalid JSON");
+            return;
+        }
+        uint32_t seq = msg["seq"] | 0;
+
+        StaticJsonDocument<WS_MAX_MESSAGE> state;
+        StaticJsonDocument<256> ack;
+        const char* error = NULL;
+        JsonArray rejected = ack["rejected"].to<JsonArray>();
+        if (!LEDCommands::apply(msg.as<JsonObject>(), state["state"].to<JsonObject>(), rejected, &error)) {
+            sendError(client, seq, error);
+            return;
+        }
+
+        ack["ack"] = seq;
+        ack["ok"] = true;
+        send(client, ack);
+        send(NULL, state);
+    }
+
+    // Current state to one client, so it starts in sync
+    static void sendState(AsyncWebSocketClient* client) {
+        StaticJsonDocument<WS_MAX_MESSAGE> doc;
+        LEDStateDiff::writeState(doc["state"].to<JsonObject>());
+        send(client, doc);
+    }
+
+    static void sendError(AsyncWebSocketClient* client, uint32_t seq, const char* error) {
+        StaticJsonDocument<128> doc;
+        doc["ack"] = seq;
+        doc["ok"] = false;
+        doc["error"] = error;
+        send(client, doc);
+    }
+
+    // To one client, or to all with client == NULL
+    static void send(AsyncWebSocketClient* client, JsonDocument& doc) {
+        char buf[WS_MAX_MESSAGE];
+        size_t len = measureJson(doc);
+        if (len >= sizeof(buf)) {
+            LOG_PRINTF("WARN ", "WS message of %u bytes dropped", (unsigned)len);
+            return;
+        }
+        serializeJson(doc, buf, sizeof(buf));
+        if (client) client->text(buf, len);
+        else ws.textAll(buf, len);
+    }
+};
+
+AsyncWebSocket LEDSocket::ws("/api/led/ws");
+uint32_t LEDSocket::messages = 0;
+
+#endif // LED_SOCKET_H
@@ -0,0 +1,117 @@
+/*
+ * LEDStateDiff.h - Change tracking of the user-facing LED state
+ *
+ * Remembers the last reported power, brightness, effect and params and
+ * writes what differs from it, at most once per SSE_MIN_INTERVAL_MS.
+ * No AsyncWebServer types, so it also builds on the host.
+ */
+
+#ifndef LED_STATE_DIFF_H
+#define LED_STATE_DIFF_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "LEDController.h"
+
+// ============================================================================
+// LEDStateDiff
+// ============================================================================
+// Full state: {"rev": 42, "power": true, "brightness": 128, "effect": 5,
+//              "params": {...}}
+// Diff:       {"rev": 57, "base": 42, "brightness": 90,
+//              "params": {"speed": 120}}
+// "rev" is LEDController's state revision when the state was read, "base"
+// the revision the diff is relative to. Diffs carry final values, so one
+// whose base is at or below the revision a client holds applies cleanly; a
+// base above it means a diff was missed and the client should resync.
+// Changes made within one interval are reported together; an effect switch
+// reports all params of the new effect.
+// ============================================================================
+
+class LEDStateDiff {
+public:
+    // Start tracking from the current state
+    void begin() {
+        snapshot();
+    }
+
+    // Current state in full (to a client joining), revision first
+    static void writeState(JsonObject state) {
+        state["rev"] = LEDController::getStateRevision();
+        state["power"] = LEDController::isPoweredOn();
+        state["brightness"] = LEDController::getBrightness();
+        uint8_t effect = LEDController::getCurrentEffect();
+        state["effect"] = effect;
+        LEDController::copyParamsJson(state["params"].to<JsonObject>(), effect);
+    }
+
+    // Changes since the last report into `diff`. False if there is nothing
+    // to report yet: no change, a change that is not part of this state
+    // (segments, layers), or the last report is younger than the interval.
+    bool takeDiff(JsonObject diff) {
+        uint32_t now = millis();
+        if (LEDController::getStateRevision() == revision) return false;
+        if (reported && now - lastReport < SSE_MIN_INTERVAL_MS) return false;
+
+        uint32_t base = revision;
+        bool oldPower = power;
+        uint8_t oldBrightness = brightness;
+        uint8_t oldEffect = effect;
+        uint8_t oldParams[NVS_PARAMS_MAX_BYTES];
+        memcpy(oldParams, params, sizeof(oldParams));
+        snapshot();
+
+        bool changed = false;
+        if (power != oldPower) {
+            diff["power"] = power;
+            changed = true;
+        }
+        if (brightness != oldBrightness) {
+            diff["brightness"] = brightness;
+            changed = true;
+        }
+        JsonObject changedParams = diff["params"].to<JsonObject>();
+        if (effect != oldEffect) {
+            diff["effect"] = effect;
+            LEDController::copyParamsJson(changedParams, effect);
+            changed = true;
+        } else if (LEDController::getParamsDiffJson(changedParams, effect, oldParams) > 0) {
+            changed = true;
+        }
+        if (changedParams.size() == 0) diff.remove("params");
+        if (!changed) return false;
+
+        diff["rev"] = revision;
+        diff["base"] = base;
+        reported = true;
+        lastReport = now;
+        reports++;
+        return true;
+    }
+
+    uint32_t getRevision() const { return revision; }
+    uint32_t getReports() const { return reports; }
+
+private:
+    uint32_t revision = 0;
+    bool power = false;
+    uint8_t brightness = 0;
+    uint8_t effect = 0;
+    uint8_t params[NVS_PARAMS_MAX_BYTES] = {0};
+    bool reported = false;
+    uint32_t lastReport = 0;
+    uint32_t reports = 0;
+
+    // Revision first: a change racing the reads shows up in the next diff
+    void snapshot() {
+        uint32_t layout;
+        revision = LEDController::getStateRevision();
+        power = LEDController::isPoweredOn();
+        brightness = LEDController::getBrightness();
+        effect = LEDController::getCurrentEffect();
+        LEDController::copyParams(effect, params, layout);
+    }
+};
+
+#endif // LED_STATE_DIFF_H
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <stddef.h>
 #include "Config.h"
 #include "SerialLogger.h"
 
@@ -14,10 +15,29 @@
 // - DEV_MODE auto-clear on boot
 // - Factory reset capability
 // - Provisioning state tracking
+// - Write-behind LED state: saves are staged in RAM, coalesced and written
+//   once changes settle (see service())
+// - Effect, brightness and params in one versioned, CRC-checked blob
 // ============================================================================
 
+#define LED_STATE_VERSION   1
+
 class NVSManager {
 public:
+    // Stored under NVS_KEY_LED_STATE as the header and paramsLen bytes of
+    // params, followed by a CRC-32 of both. params is the raw params struct
+    // of paramsEffect (LEDController::copyParams), only valid under the same
+    // paramsLayout.
+    struct LedState {
+        uint8_t version;            // LED_STATE_VERSION
+        uint8_t effect;             // 0xFF = not set
+        uint8_t brightness;         // 0xFF = not set
+        uint8_t paramsEffect;       // 0xFF = no params
+        uint32_t paramsLayout;
+        uint8_t paramsLen;
+        uint8_t params[NVS_PARAMS_MAX_BYTES];
+    };
+    
     // Initialize NVS and handle dev mode
     static bool begin() {
         LOG_INFO("Initializing NVS Manager...");
@@ -28,6 +48,9 @@ public:
             return false;
         }
         
+        pendingLock = xSemaphoreCreateMutex();
+        esp_register_shutdown_handler(flush);  // ESP.restart() writes what is staged
+        
         // DEV MODE: Clear credentials on boot
         #if DEV_MODE
         LOG_WARN("DEV_MODE enabled - clearing credentials on boot!");
@@ -113,50 +136,181 @@ public:
         prefs.remove(NVS_KEY_SSID);
         prefs.remove(NVS_KEY_PASSWORD);
         prefs.remove(NVS_KEY_PROVISIONED);
-        prefs.remove(NVS_KEY_LED_EFFECT);
-        prefs.remove("led_bright");
-        prefs.remove("led_params");
+        lockPending();
+        dirtyKeys = 0;  // Staged LED state must not be written back after the reset
+        pendingState = emptyLedState();
+        prefs.remove(NVS_KEY_LED_STATE);
+        removeLegacyState();
+        prefs.remove(NVS_KEY_LED_SEGMENTS);
+        prefs.remove(NVS_KEY_LED_LAYERS);
+        unlockPending();
+        // LED count/pin describe the wiring and survive a factory reset
         
         LOG_INFO("Credentials cleared - device reset to factory state");
     }
     
-    // Save LED effect to NVS
+    // Load effect, brightness and params. Returns false when there is no
+    // valid blob: effect and brightness then come from the keys of older
+    // firmware (if any), and their params from loadLegacyParams(). The
+    // result is also what later saves update.
+    static bool loadLedState(LedState& state) {
+        const size_t header = offsetof(LedState, params);
+        uint8_t buf[sizeof(LedState) + sizeof(uint32_t)];
+        size_t len = prefs.getBytesLength(NVS_KEY_LED_STATE);
+        bool valid = len >= header + sizeof(uint32_t) && len <= header + NVS_PARAMS_MAX_BYTES + sizeof(uint32_t) &&
+                     prefs.getBytes(NVS_KEY_LED_STATE, buf, len) == len;
+        if (valid) {
+            len -= sizeof(uint32_t);
+            uint32_t crc;
+            memcpy(&crc, buf + len, sizeof(crc));
+            state = emptyLedState();
+            memcpy(&state, buf, len);
+            valid = crc == crc32(buf, len) && state.version == LED_STATE_VERSION && header + state.paramsLen == len;
+            if (!valid) LOG_WARN("Stored LED state is corrupt or from another version - ignored");
+        }
+        
+        if (!valid) {
+            state = emptyLedState();
+            state.effect = prefs.getUChar(NVS_KEY_LED_EFFECT, 0xFF);
+            state.brightness = prefs.getUChar(NVS_KEY_LED_BRIGHTNESS, 0xFF);
+        }
+        if (state.effect != 0xFF) {
+            LOG_PRINTF("INFO ", "LED effect loaded from NVS: %d", state.effect);
+        }
+        
+        lockPending();
+        pendingState = state;
+        unlockPending();
+        return valid;
+    }
+    
+    // Params JSON written by older firmware (empty if none)
+    static String loadLegacyParams() {
+        return prefs.getString(NVS_KEY_LED_PARAMS, "");
+    }
+    
+    // Whether older firmware left LED state to migrate
+    static bool hasLegacyState() {
+        return prefs.isKey(NVS_KEY_LED_EFFECT) || prefs.isKey(NVS_KEY_LED_BRIGHTNESS) ||
+               prefs.isKey(NVS_KEY_LED_PARAMS);
+    }
+    
+    // Stage LED effect for NVS
     static void saveEffect(uint8_t effectId) {
-        prefs.putUChar(NVS_KEY_LED_EFFECT, effectId);
-        LOG_PRINTF("DEBUG", "LED effect saved to NVS: %d", effectId);
+        lockPending();
+        pendingState.effect = effectId;
+        markDirty(DIRTY_STATE);
+        unlockPending();
+    }
+    
+    // Stage brightness for NVS
+    static void saveBrightness(uint8_t brightness) {
+        lockPending();
+        pendingState.brightness = brightness;
+        markDirty(DIRTY_STATE);
+        unlockPending();
+    }
+    
+    // Save LED hardware config (applied on next boot)
+    static void saveLedConfig(uint16_t numLeds, const uint8_t* dataPins, uint8_t numPins) {
+        prefs.putUShort(NVS_KEY_LED_COUNT, numLeds);
+        prefs.putBytes(NVS_KEY_LED_PINS, dataPins, numPins);
+        prefs.remove(NVS_KEY_LED_PIN);
+        LOG_PRINTF("DEBUG", "LED config saved to NVS: %d LEDs on %d output(s)", numLeds, numPins);
+    }
+    
+    // Load LED count from NVS (returns Config.h default if not set)
+    static uint16_t loadLedCount() {
+        return prefs.getUShort(NVS_KEY_LED_COUNT, ARGB_NUM_LEDS);
     }
     
-    // Load LED effect from NVS (returns 0xFF if not set)
-    static uint8_t loadEffect() {
-        uint8_t effect = prefs.getUChar(NVS_KEY_LED_EFFECT, 0xFF);
-        if (effect != 0xFF) {
-            LOG_PRINTF("INFO ", "LED effect loaded from NVS: %d", effect);
+    // Load LED data pins from NVS into pins[maxPins], returns the count
+    // (single-pin config from older firmware, else the Config.h default)
+    static uint8_t loadLedPins(uint8_t* pins, uint8_t maxPins) {
+        size_t len = prefs.getBytesLength(NVS_KEY_LED_PINS);
+        if (len > 0 && len <= maxPins) {
+            return prefs.getBytes(NVS_KEY_LED_PINS, pins, len);
         }
-        return effect;
+        pins[0] = prefs.getUChar(NVS_KEY_LED_PIN, ARGB_DATA_PIN);
+        return 1;
     }
     
-    // Save brightness to NVS
-    static void saveBrightness(uint8_t brightness) {
-        prefs.putUChar("led_bright", brightness);
-        LOG_PRINTF("DEBUG", "Brightness saved to NVS: %d", brightness);
+    // Stage an effect's params struct for NVS (from LEDController::copyParams)
+    static void saveParams(uint8_t effect, const uint8_t* params, uint8_t len, uint32_t layout) {
+        if (len > NVS_PARAMS_MAX_BYTES) return;
+        lockPending();
+        pendingState.paramsEffect = effect;
+        pendingState.paramsLayout = layout;
+        pendingState.paramsLen = len;
+        memcpy(pendingState.params, params, len);
+        markDirty(DIRTY_STATE);
+        unlockPending();
+    }
+    
+    // Stage segment table for NVS as JSON string (empty removes it)
+    static void saveSegments(const String& segmentsJson) {
+        lockPending();
+        pendingSegments = segmentsJson;
+        markDirty(DIRTY_SEGMENTS);
+        unlockPending();
     }
     
-    // Load brightness from NVS (returns 0xFF if not set)
-    static uint8_t loadBrightness() {
-        return prefs.getUChar("led_bright", 0xFF);
+    // Load segment table from NVS
+    static String loadSegments() {
+        return prefs.getString(NVS_KEY_LED_SEGMENTS, "");
     }
     
-    // Save effect parameters to NVS as JSON string
-    static void saveParams(const String& paramsJson) {
-        prefs.putString("led_params", paramsJson);
-        LOG_DEBUG("Effect params saved to NVS");
+    // Stage layer stack for NVS as JSON string (empty removes it)
+    static void saveLayers(const String& layersJson) {
+        lockPending();
+        pendingLayers = layersJson;
+        markDirty(DIRTY_LAYERS);
+        unlockPending();
     }
     
-    // Load effect parameters from NVS
-    static String loadParams() {
-        return prefs.getString("led_params", "");
+    // Load layer stack from NVS
+    static String loadLayers() {
+        return prefs.getString(NVS_KEY_LED_LAYERS, "");
+    }
+    
+    // Write staged LED state once changes have settled: NVS_FLUSH_IDLE_MS
+    // without a save, or NVS_FLUSH_MAX_MS after the first unwritten one
+    // (called from loop())
+    static void service() {
+        if (!dirtyKeys) return;
+        unsigned long now = millis();
+        if (now - lastDirtyMs >= NVS_FLUSH_IDLE_MS || now - firstDirtyMs >= NVS_FLUSH_MAX_MS) {
+            flush();
+        }
     }
     
+    // Write every staged LED key now (power off, restart)
+    static void flush() {
+        lockPending();
+        uint8_t keys = dirtyKeys;
+        dirtyKeys = 0;
+        if (keys & DIRTY_STATE) {
+            writeLedState();
+            writesIssued++;
+        }
+        if (keys & DIRTY_SEGMENTS) {
+            writeOrRemove(NVS_KEY_LED_SEGMENTS, pendingSegments);
+            writesIssued++;
+        }
+        if (keys & DIRTY_LAYERS) {
+            writeOrRemove(NVS_KEY_LED_LAYERS, pendingLayers);
+            writesIssued++;
+        }
+        unlockPending();
+        if (keys) LOG_PRINTF("DEBUG", "LED state written to NVS (keys 0x%02x)", keys);
+    }
+    
+    // Write-behind counters: flash writes made, and saves absorbed by a
+    // later save of the same key before it was written
+    static uint32_t getWritesIssued() { return writesIssued; }
+    static uint32_t getWritesCoalesced() { return writesCoalesced; }
+    static bool hasPendingWrites() { return dirtyKeys != 0; }
+    
     // Get stored SSID (for display purposes)
     static String getSSID() {
         return prefs.getString(NVS_KEY_SSID, "");
@@ -170,6 +324,86 @@ public:
 private:
     static Preferences prefs;
     
+    enum DirtyKey : uint8_t {
+        DIRTY_STATE      = 0x01,    // Effect, brightness, params
+        DIRTY_SEGMENTS   = 0x02,
+        DIRTY_LAYERS     = 0x04
+    };
+    
+    // Staged LED state, guarded by pendingLock (HTTP handlers stage, loop()
+    // flushes)
+    static SemaphoreHandle_t pendingLock;
+    static volatile uint8_t dirtyKeys;
+    static unsigned long firstDirtyMs;
+    static unsigned long lastDirtyMs;
+    static LedState pendingState;
+    static String pendingSegments;
+    static String pendingLayers;
+    static uint32_t writesIssued;
+    static uint32_t writesCoalesced;
+    
+    static void lockPending() {
+        if (pendingLock) xSemaphoreTake(pendingLock, portMAX_DELAY);
+    }
+    
+    static void unlockPending() {
+        if (pendingLock) xSemaphoreGive(pendingLock);
+    }
+    
+    // Caller holds pendingLock
+    static void markDirty(uint8_t key) {
+        unsigned long now = millis();
+        if (dirtyKeys & key) writesCoalesced++;
+        if (!dirtyKeys) firstDirtyMs = now;
+        dirtyKeys |= key;
+        lastDirtyMs = now;
+    }
+    
+    static LedState emptyLedState() {
+        LedState state = {};
+        state.version = LED_STATE_VERSION;
+        state.effect = 0xFF;
+        state.brightness = 0xFF;
+        state.paramsEffect = 0xFF;
+        return state;
+    }
+    
+    // Caller holds pendingLock. The first blob replaces what older firmware
+    // stored.
+    static void writeLedState() {
+        const size_t len = offsetof(LedState, params) + pendingState.paramsLen;
+        uint8_t buf[sizeof(LedState) + sizeof(uint32_t)];
+        pendingState.version = LED_STATE_VERSION;
+        memcpy(buf, &pendingState, len);
+        uint32_t crc = crc32(buf, len);
+        memcpy(buf + len, &crc, sizeof(crc));
+        if (prefs.putBytes(NVS_KEY_LED_STATE, buf, len + sizeof(crc)) == len + sizeof(crc) && hasLegacyState()) {
+            removeLegacyState();
+            LOG_INFO("LED state migrated to binary format");
+        }
+    }
+    
+    static void removeLegacyState() {
+        prefs.remove(NVS_KEY_LED_EFFECT);
+        prefs.remove(NVS_KEY_LED_BRIGHTNESS);
+        prefs.remove(NVS_KEY_LED_PARAMS);
+    }
+    
+    // CRC-32 (IEEE 802.3, reflected), bitwise: the blob is a few dozen bytes
+    static uint32_t crc32(const uint8_t* data, size_t len) {
+        uint32_t crc = 0xFFFFFFFF;
+        while (len--) {
+            crc ^= *data++;
+            for (uint8_t bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+        return ~crc;
+    }
+    
+    static void writeOrRemove(const char* key, const String& value) {
+        if (value.isEmpty()) prefs.remove(key);
+        else prefs.putString(key, value);
+    }
+    
     // Log stored credentials (for debugging)
     static void logStoredCredentials() {
         String ssid = prefs.getString(NVS_KEY_SSID, "");
@@ -181,5 +415,14 @@ private:
 
 // Static member initialization
 Preferences NVSManager::prefs;
+SemaphoreHandle_t NVSManager::pendingLock = NULL;
+volatile uint8_t NVSManager::dirtyKeys = 0;
+unsigned long NVSManager::firstDirtyMs = 0;
+unsigned long NVSManager::lastDirtyMs = 0;
+NVSManager::LedState NVSManager::pendingState = NVSManager::emptyLedState();
+String NVSManager::pendingSegments;
+String NVSManager::pendingLayers;
+uint32_t NVSManager::writesIssued = 0;
+uint32_t NVSManager::writesCoalesced = 0;
 
 #endif // NVS_MANAGER_H
@@ -130,6 +130,80 @@ CRGBPalette16 getPalette(PaletteType type) {
     }
 }
 
+// ============== PALETTE LOOKUP TABLES ==============
+// Each palette expanded to 256 LINEARBLEND entries, so a per-pixel color lookup
+// is a single indexed load instead of building a CRGBPalette16 and blending.
+// Tables are built on first use and kept in a small round-robin cache keyed by
+// PaletteType; palettes are compile-time constants, so changing the palette
+// param only selects (or builds) another slot.
+
+#ifndef PALETTE_CACHE_SLOTS
+#define PALETTE_CACHE_SLOTS 4
+#endif
+
+struct PaletteLUT {
+    PaletteType type;
+    bool valid;
+    CRGB entries[256];
+};
+
+const CRGB* getPaletteLUT(PaletteType type) {
+    static PaletteLUT cache[PALETTE_CACHE_SLOTS];
+    static uint8_t lastUsed = 0;
+    static uint8_t nextVictim = 0;
+
+    if (cache[lastUsed].valid && cache[lastUsed].type == type) {
+        return cache[lastUsed].entries;
+    }
+    for (uint8_t s = 0; s < PALETTE_CACHE_SLOTS; s++) {
+        if (cache[s].valid && cache[s].type == type) {
+            lastUsed = s;
+            return cache[s].entries;
+        }
+    }
+
+    PaletteLUT& slot = cache[nextVictim];
+    CRGBPalette16 pal = getPalette(type);
+    for (uint16_t i = 0; i < 256; i++) {
+        slot.entries[i] = ColorFromPalette(pal, i, 255, LINEARBLEND);
+    }
+    slot.type = type;
+    slot.valid = true;
+
+    lastUsed = nextVictim;
+    nextVictim = (nextVictim + 1) % PALETTE_CACHE_SLOTS;
+    return slot.entries;
+}
+
+// Same result as ColorFromPalette(getPalette(type), index, brightness, LINEARBLEND)
+inline CRGB paletteLookup(const CRGB* lut, uint8_t index, uint8_t brightness = 255) {
+    CRGB c = lut[index];
+    if (brightness != 255) {
+        if (brightness) {
+            ++brightness;   // Same rounding as ColorFromPalette
+            c.r = scale8(c.r, brightness);
+            c.g = scale8(c.g, brightness);
+            c.b = scale8(c.b, brightness);
+        } else {
+            c = CRGB::Black;
+        }
+    }
+    return c;
+}
+
+// Full saturation/value rainbow: CHSV(hue, 255, 255) for every hue
+const CRGB* getRainbowLUT() {
+    static CRGB table[256];
+    static bool built = false;
+    if (!built) {
+        for (uint16_t h = 0; h < 256; h++) {
+            hsv2rgb_rainbow(CHSV(h, 255, 255), table[h]);
+        }
+        built = true;
+    }
+    return table;
+}
+
 // Palette name (for debugging)
 const char* getPaletteName(PaletteType type) {
     static const char* names[] = {
@@ -0,0 +1,530 @@
+/*
+ * ParamRegistry.h - Effect parameter descriptors
+ *
+ * One row per parameter: its JSON key, the effect that owns it, where it
+ * lives in the effect's params struct, its type and accepted range.
+ * setParam, getParamsJson and the NVS restore are all driven by this table.
+ *
+ * The API side never touches the params structs the effects read: it works
+ * on a staged copy of each, which the LED task copies over the live one at a
+ * frame boundary (commitStagedParams).
+ */
+
+#ifndef PARAM_REGISTRY_H
+#define PARAM_REGISTRY_H
+
+#include <stddef.h>
+#include "EffectParams.h"
+
+// ============================================================================
+// Descriptors
+// ============================================================================
+
+enum ParamType : uint8_t {
+    PARAM_UINT8,    // uint8_t field, clamped to min..max
+    PARAM_UINT16,   // uint16_t field holding the JSON value * scale
+    PARAM_BOOL,
+    PARAM_COLOR,    // CRGB field, "#RRGGBB" in JSON
+    PARAM_ENUM      // int-sized enum field, 0..max
+};
+
+#define PARAM_ALIAS     0x01    // Accepted on input, not reported
+
+struct ParamDesc {
+    const char* key;
+    uint8_t effect;
+    uint8_t type;
+    uint16_t offset;        // Into the effect's params struct
+    uint8_t min;            // Accepted JSON values
+    uint8_t max;
+    uint8_t scale;
+    uint8_t flags;
+};
+
+// Params struct of each effect, by effect id
+struct EffectParamBlock {
+    void* params;           // Live copy, read by the effects
+    uint16_t size;
+};
+
+constexpr size_t paramTypeSize(uint8_t type) {
+    return type == PARAM_UINT16 ? sizeof(uint16_t) :
+           type == PARAM_BOOL ? sizeof(bool) :
+           type == PARAM_COLOR ? sizeof(CRGB) :
+           type == PARAM_ENUM ? sizeof(int) : sizeof(uint8_t);
+}
+
+// Field offset, rejected at compile time when the field does not match the type
+constexpr uint16_t paramOffset(size_t offset, size_t fieldSize, uint8_t type) {
+    return fieldSize == paramTypeSize(type) ? (uint16_t)offset : throw "param type does not match its field";
+}
+
+#define PARAM_ROW(key, effect, S, field, type, lo, hi, scale, flags) \
+    {key, effect, type, paramOffset(offsetof(S, field), sizeof(((S*)0)->field), type), lo, hi, scale, flags}
+
+#define UINT8_PARAM(key, effect, S, field)              PARAM_ROW(key, effect, S, field, PARAM_UINT8, 0, 255, 1, 0)
+#define RANGE_PARAM(key, effect, S, field, lo, hi)      PARAM_ROW(key, effect, S, field, PARAM_UINT8, lo, hi, 1, 0)
+#define SCALED_PARAM(key, effect, S, field, lo, hi, scale) \
+    PARAM_ROW(key, effect, S, field, PARAM_UINT16, lo, hi, scale, 0)
+#define BOOL_PARAM(key, effect, S, field)               PARAM_ROW(key, effect, S, field, PARAM_BOOL, 0, 1, 1, 0)
+#define COLOR_PARAM(key, effect, S, field)              PARAM_ROW(key, effect, S, field, PARAM_COLOR, 0, 0, 1, 0)
+#define COLOR_ALIAS(key, effect, S, field)              PARAM_ROW(key, effect, S, field, PARAM_COLOR, 0, 0, 1, PARAM_ALIAS)
+#define ENUM_PARAM(key, effect, S, field, last)         PARAM_ROW(key, effect, S, field, PARAM_ENUM, 0, last, 1, 0)
+
+// ============================================================================
+// Tables
+// ============================================================================
+
+constexpr EffectParamBlock effectParamBlocks[] = {
+    {&solidParams, sizeof(SolidParams)},                        // 0 Solid
+    {&gradientParams, sizeof(GradientParams)},                  // 1 Gradient
+    {&spotsParams, sizeof(SpotsParams)},                        // 2 Spots
+    {&patternParams, sizeof(PatternParams)},                    // 3 Pattern
+    {&rainbowWaveParams, sizeof(RainbowWaveParams)},            // 4 Rainbow Wave
+    {&colorWaveParams, sizeof(ColorWaveParams)},                // 5 Color Wave
+    {&oscillateParams, sizeof(OscillateParams)},                // 6 Oscillate
+    {&wavyParams, sizeof(WavyParams)},                          // 7 Wavy
+    {&theaterChaseParams, sizeof(TheaterChaseParams)},          // 8 Theater Chase
+    {&scannerParams, sizeof(ScannerParams)},                    // 9 Scanner
+    {&cometParams, sizeof(CometParams)},                        // 10 Comet
+    {&runningLightsParams, sizeof(RunningLightsParams)},        // 11 Running Lights
+    {&androidParams, sizeof(AndroidParams)},                    // 12 Android
+    {&twinkleParams, sizeof(TwinkleParams)},                    // 13 Twinkle
+    {&twinkleFoxParams, sizeof(TwinkleFoxParams)},              // 14 TwinkleFox
+    {&sparkleParams, sizeof(SparkleParams)},                    // 15 Sparkle
+    {&glitterParams, sizeof(GlitterParams)},                    // 16 Glitter
+    {&starryNightParams, sizeof(StarryNightParams)},            // 17 Starry Night
+    {&fireParams, sizeof(FireParams)},                          // 18 Fire
+    {&candleParams, sizeof(CandleParams)},                      // 19 Candle
+    {&fireFlickerParams, sizeof(FireFlickerParams)},            // 20 FireFlicker
+    {&lavaParams, sizeof(LavaParams)},                          // 21 Lava
+    {&auroraParams, sizeof(AuroraParams)},                      // 22 Aurora
+    {&pacificaParams, sizeof(PacificaParams)},                  // 23 Pacifica
+    {&lakeParams, sizeof(LakeParams)},                          // 24 Lake
+    {&fairyParams, sizeof(FairyParams)},                        // 25 Fairy
+    {&christmasChaseParams, sizeof(ChristmasChaseParams)},      // 26 ChristmasChase
+    {&halloweenEyesParams, sizeof(HalloweenEyesParams)},        // 27 HalloweenEyes
+    {&fireworksParams, sizeof(FireworksParams)},                // 28 Fireworks
+    {&snowSparkleParams, sizeof(SnowSparkleParams)},            // 29 SnowSparkle
+    {&bouncingBallsParams, sizeof(BouncingBallsParams)},        // 30 BouncingBalls
+    {&popcornParams, sizeof(PopcornParams)},                    // 31 Popcorn
+    {&dripParams, sizeof(DripParams)},                          // 32 Drip
+    {&plasmaParams, sizeof(PlasmaParams)},                      // 33 Plasma
+    {&lightningParams, sizeof(LightningParams)},                // 34 Lightning
+    {&matrixParams, sizeof(MatrixParams)},                      // 35 Matrix
+    {&heartbeatParams, sizeof(HeartbeatParams)},                // 36 Heartbeat
+    {&breatheParams, sizeof(BreatheParams)},                    // 37 Breathe
+    {&dissolveParams, sizeof(DissolveParams)},                  // 38 Dissolve
+    {&fadeParams, sizeof(FadeParams)},                          // 39 Fade
+    {&policeLightsParams, sizeof(PoliceLightsParams)},          // 40 Police
+    {&strobeParams, sizeof(StrobeParams)},                      // 41 Strobe
+};
+
+#define NUM_PARAM_BLOCKS (sizeof(effectParamBlocks) / sizeof(effectParamBlocks[0]))
+
+static_assert(NUM_PARAM_BLOCKS <= 64, "paramsStaged has one bit per effect");
+
+// Grouped by effect, in the order getParamsJson reports them. Ranges match
+// the mobile app's sliders.
+constexpr ParamDesc paramTable[] = {
+    // 0 Solid
+    COLOR_PARAM("color", 0, SolidParams, color),
+    // 1 Gradient
+    COLOR_PARAM("colorStart", 1, GradientParams, colorStart),
+    COLOR_PARAM("colorMiddle", 1, GradientParams, colorMiddle),
+    COLOR_PARAM("colorEnd", 1, GradientParams, colorEnd),
+    ENUM_PARAM("style", 1, GradientParams, style, GRADIENT_SCATTERED),
+    BOOL_PARAM("threePoint", 1, GradientParams, threePoint),
+    // 2 Spots
+    COLOR_PARAM("color", 2, SpotsParams, color),
+    RANGE_PARAM("spread", 2, SpotsParams, spread, 1, 30),
+    RANGE_PARAM("width", 2, SpotsParams, width, 1, 10),
+    BOOL_PARAM("fade", 2, SpotsParams, fade),
+    // 3 Pattern
+    COLOR_PARAM("colorFg", 3, PatternParams, colorFg),
+    COLOR_PARAM("colorBg", 3, PatternParams, colorBg),
+    RANGE_PARAM("fgSize", 3, PatternParams, fgSize, 1, 20),
+    RANGE_PARAM("bgSize", 3, PatternParams, bgSize, 1, 20),
+    // 4 Rainbow Wave
+    UINT8_PARAM("speed", 4, RainbowWaveParams, speed),
+    RANGE_PARAM("size", 4, RainbowWaveParams, size, 1, 50),
+    UINT8_PARAM("saturation", 4, RainbowWaveParams, saturation),
+    // 5 Color Wave
+    COLOR_PARAM("color1", 5, ColorWaveParams, colors[0]),
+    COLOR_PARAM("color2", 5, ColorWaveParams, colors[1]),
+    COLOR_PARAM("color3", 5, ColorWaveParams, colors[2]),
+    COLOR_PARAM("color4", 5, ColorWaveParams, colors[3]),
+    COLOR_PARAM("color5", 5, ColorWaveParams, colors[4]),
+    COLOR_PARAM("color6", 5, ColorWaveParams, colors[5]),
+    COLOR_PARAM("color7", 5, ColorWaveParams, colors[6]),
+    COLOR_PARAM("color8", 5, ColorWaveParams, colors[7]),
+    RANGE_PARAM("numColors", 5, ColorWaveParams, numColors, 2, 8),
+    ENUM_PARAM("direction", 5, ColorWaveParams, direction, DIR_CCW),
+    UINT8_PARAM("speed", 5, ColorWaveParams, speed),
+    // 6 Oscillate
+    COLOR_PARAM("colorPrimary", 6, OscillateParams, colorPrimary),
+    COLOR_PARAM("colorSecondary", 6, OscillateParams, colorSecondary),
+    UINT8_PARAM("speed", 6, OscillateParams, speed),
+    RANGE_PARAM("pointSize", 6, OscillateParams, pointSize, 1, 20),
+    // 7 Wavy
+    ENUM_PARAM("palette", 7, WavyParams, palette, PALETTE_CYBER),
+    UINT8_PARAM("speed", 7, WavyParams, speed),
+    RANGE_PARAM("amplitude", 7, WavyParams, amplitude, 1, 255),
+    RANGE_PARAM("frequency", 7, WavyParams, frequency, 1, 10),
+    // 8 Theater Chase
+    COLOR_PARAM("color", 8, TheaterChaseParams, color),
+    UINT8_PARAM("speed", 8, TheaterChaseParams, speed),
+    RANGE_PARAM("gapSize", 8, TheaterChaseParams, gapSize, 1, 10),
+    BOOL_PARAM("rainbowMode", 8, TheaterChaseParams, rainbowMode),
+    // 9 Scanner
+    COLOR_PARAM("color1", 9, ScannerParams, colors[0]),
+    COLOR_PARAM("color2", 9, ScannerParams, colors[1]),
+    COLOR_PARAM("color3", 9, ScannerParams, colors[2]),
+    COLOR_PARAM("color4", 9, ScannerParams, colors[3]),
+    COLOR_PARAM("color5", 9, ScannerParams, colors[4]),
+    COLOR_PARAM("color6", 9, ScannerParams, colors[5]),
+    COLOR_PARAM("color7", 9, ScannerParams, colors[6]),
+    COLOR_PARAM("color8", 9, ScannerParams, colors[7]),
+    UINT8_PARAM("speed", 9, ScannerParams, speed),
+    RANGE_PARAM("numDots", 9, ScannerParams, numDots, 1, 8),
+    RANGE_PARAM("trailLength", 9, ScannerParams, trailLength, 1, 50),
+    BOOL_PARAM("dualMode", 9, ScannerParams, dualMode),
+    COLOR_ALIAS("color", 9, ScannerParams, colors[0]),
+    // 10 Comet
+    COLOR_PARAM("color", 10, CometParams, color),
+    COLOR_PARAM("sparkleColor", 10, CometParams, sparkleColor),
+    UINT8_PARAM("speed", 10, CometParams, speed),
+    RANGE_PARAM("trailLength", 10, CometParams, trailLength, 1, 50),
+    BOOL_PARAM("sparkleEnabled", 10, CometParams, sparkleEnabled),
+    ENUM_PARAM("direction", 10, CometParams, direction, DIR_CCW),
+    // 11 Running Lights
+    COLOR_PARAM("color1", 11, RunningLightsParams, colors[0]),
+    COLOR_PARAM("color2", 11, RunningLightsParams, colors[1]),
+    COLOR_PARAM("color3", 11, RunningLightsParams, colors[2]),
+    COLOR_PARAM("color4", 11, RunningLightsParams, colors[3]),
+    RANGE_PARAM("numColors", 11, RunningLightsParams, numColors, 1, 4),
+    UINT8_PARAM("speed", 11, RunningLightsParams, speed),
+    RANGE_PARAM("waveWidth", 11, RunningLightsParams, waveWidth, 1, 50),
+    ENUM_PARAM("shape", 11, RunningLightsParams, shape, SHAPE_TRIANGLE),
+    BOOL_PARAM("dualMode", 11, RunningLightsParams, dualMode),
+    COLOR_ALIAS("color", 11, RunningLightsParams, colors[0]),
+    // 12 Android
+    COLOR_PARAM("colorPrimary", 12, AndroidParams, colorPrimary),
+    COLOR_PARAM("colorSecondary", 12, AndroidParams, colorSecondary),
+    UINT8_PARAM("speed", 12, AndroidParams, speed),
+    RANGE_PARAM("sectionWidth", 12, AndroidParams, sectionWidth, 1, 50),
+    // 13 Twinkle
+    ENUM_PARAM("palette", 13, TwinkleParams, palette, PALETTE_CYBER),
+    COLOR_PARAM("twinkleColor", 13, TwinkleParams, twinkleColor),
+    UINT8_PARAM("speed", 13, TwinkleParams, speed),
+    UINT8_PARAM("intensity", 13, TwinkleParams, intensity),
+    UINT8_PARAM("fadeSpeed", 13, TwinkleParams, fadeSpeed),
+    ENUM_PARAM("colorMode", 13, TwinkleParams, colorMode, TWINKLE_RANDOM),
+    // 14 TwinkleFox
+    ENUM_PARAM("palette", 14, TwinkleFoxParams, palette, PALETTE_CYBER),
+    UINT8_PARAM("speed", 14, TwinkleFoxParams, speed),
+    UINT8_PARAM("twinkleRate", 14, TwinkleFoxParams, twinkleRate),
+    // 15 Sparkle
+    COLOR_PARAM("colorSpark", 15, SparkleParams, colorSpark),
+    COLOR_PARAM("colorBg", 15, SparkleParams, colorBg),
+    UINT8_PARAM("speed", 15, SparkleParams, speed),
+    UINT8_PARAM("intensity", 15, SparkleParams, intensity),
+    BOOL_PARAM("darkMode", 15, SparkleParams, darkMode),
+    // 16 Glitter
+    UINT8_PARAM("intensity", 16, GlitterParams, intensity),
+    BOOL_PARAM("rainbowBg", 16, GlitterParams, rainbowBg),
+    COLOR_PARAM("colorBg", 16, GlitterParams, bgColor),
+    // 17 Starry Night
+    UINT8_PARAM("speed", 17, StarryNightParams, speed),
+    UINT8_PARAM("density", 17, StarryNightParams, density),
+    COLOR_PARAM("colorStars", 17, StarryNightParams, colorStars),
+    BOOL_PARAM("shootingStars", 17, StarryNightParams, shootingStars),
+    // 18 Fire
+    RANGE_PARAM("cooling", 18, FireParams, cooling, 20, 100),
+    RANGE_PARAM("sparking", 18, FireParams, sparking, 50, 200),
+    BOOL_PARAM("boost", 18, FireParams, boost),
+    ENUM_PARAM("palette", 18, FireParams, palette, PALETTE_CYBER),
+    // 19 Candle
+    UINT8_PARAM("speed", 19, CandleParams, speed),
+    UINT8_PARAM("intensity", 19, CandleParams, intensity),
+    BOOL_PARAM("multiMode", 19, CandleParams, multiMode),
+    COLOR_PARAM("color", 19, CandleParams, color),
+    RANGE_PARAM("colorShift", 19, CandleParams, colorShift, 0, 100),
+    // 20 FireFlicker
+    UINT8_PARAM("speed", 20, FireFlickerParams, speed),
+    UINT8_PARAM("intensity", 20, FireFlickerParams, intensity),
+    COLOR_PARAM("color", 20, FireFlickerParams, color),
+    // 21 Lava
+    RANGE_PARAM("speed", 21, LavaParams, speed, 20, 80),
+    RANGE_PARAM("blobSize", 21, LavaParams, blobSize, 5, 40),
+    RANGE_PARAM("smoothness", 21, LavaParams, smoothness, 100, 255),
+    // 22 Aurora
+    UINT8_PARAM("speed", 22, AuroraParams, speed),
+    UINT8_PARAM("intensity", 22, AuroraParams, intensity),
+    ENUM_PARAM("palette", 22, AuroraParams, palette, PALETTE_CYBER),
+    // 23 Pacifica
+    UINT8_PARAM("speed", 23, PacificaParams, speed),
+    ENUM_PARAM("palette", 23, PacificaParams, palette, PALETTE_CYBER),
+    // 24 Lake
+    UINT8_PARAM("speed", 24, LakeParams, speed),
+    ENUM_PARAM("palette", 24, LakeParams, palette, PALETTE_CYBER),
+    // 25 Fairy
+    UINT8_PARAM("speed", 25, FairyParams, speed),
+    RANGE_PARAM("numFlashers", 25, FairyParams, numFlashers, 1, 255),
+    ENUM_PARAM("colorMode", 25, FairyParams, colorMode, FAIRY_PALETTE),
+    ENUM_PARAM("palette", 25, FairyParams, palette, PALETTE_CYBER),
+    // 26 ChristmasChase
+    UINT8_PARAM("speed", 26, ChristmasChaseParams, speed),
+    COLOR_PARAM("color1", 26, ChristmasChaseParams, color1),
+    COLOR_PARAM("color2", 26, ChristmasChaseParams, color2),
+    ENUM_PARAM("pattern", 26, ChristmasChaseParams, pattern, XMAS_SPARKLE),
+    // 27 HalloweenEyes
+    SCALED_PARAM("duration", 27, HalloweenEyesParams, duration, 10, 255, 10),
+    SCALED_PARAM("fadeTime", 27, HalloweenEyesParams, fadeTime, 10, 255, 5),
+    COLOR_PARAM("color", 27, HalloweenEyesParams, color),
+    // 28 Fireworks
+    UINT8_PARAM("chance", 28, FireworksParams, chance),
+    RANGE_PARAM("fragments", 28, FireworksParams, fragments, 4, 16),
+    UINT8_PARAM("gravity", 28, FireworksParams, gravity),
+    // 29 SnowSparkle
+    UINT8_PARAM("speed", 29, SnowSparkleParams, speed),
+    UINT8_PARAM("density", 29, SnowSparkleParams, density),
+    COLOR_PARAM("color", 29, SnowSparkleParams, color),
+    ENUM_PARAM("direction", 29, SnowSparkleParams, direction, DIR_CCW),
+    // 30 BouncingBalls
+    RANGE_PARAM("gravity", 30, BouncingBallsParams, gravity, 100, 255),
+    RANGE_PARAM("numBalls", 30, BouncingBallsParams, numBalls, 1, 8),
+    RANGE_PARAM("trail", 30, BouncingBallsParams, trail, 0, 20),
+    ENUM_PARAM("palette", 30, BouncingBallsParams, palette, PALETTE_CYBER),
+    // 31 Popcorn
+    UINT8_PARAM("speed", 31, PopcornParams, speed),
+    UINT8_PARAM("intensity", 31, PopcornParams, intensity),
+    ENUM_PARAM("palette", 31, PopcornParams, palette, PALETTE_CYBER),
+    // 32 Drip
+    RANGE_PARAM("gravity", 32, DripParams, gravity, 100, 255),
+    RANGE_PARAM("numDrips", 32, DripParams, numDrips, 1, 8),
+    COLOR_PARAM("color", 32, DripParams, color),
+    // 33 Plasma
+    UINT8_PARAM("phase", 33, PlasmaParams, phase),
+    UINT8_PARAM("intensity", 33, PlasmaParams, intensity),
+    UINT8_PARAM("speed", 33, PlasmaParams, speed),
+    // 34 Lightning
+    UINT8_PARAM("frequency", 34, LightningParams, frequency),
+    UINT8_PARAM("intensity", 34, LightningParams, intensity),
+    COLOR_PARAM("color", 34, LightningParams, color),
+    // 35 Matrix
+    UINT8_PARAM("speed", 35, MatrixParams, speed),
+    UINT8_PARAM("spawningRate", 35, MatrixParams, spawningRate),
+    RANGE_PARAM("trailLength", 35, MatrixParams, trailLength, 3, 30),
+    COLOR_PARAM("color", 35, MatrixParams, color),
+    // 36 Heartbeat
+    RANGE_PARAM("bpm", 36, HeartbeatParams, bpm, 40, 180),
+    COLOR_PARAM("color", 36, HeartbeatParams, color),
+    // 37 Breathe
+    RANGE_PARAM("speed", 37, BreatheParams, speed, 20, 200),
+    COLOR_PARAM("colorPrimary", 37, BreatheParams, colorPrimary),
+    COLOR_PARAM("colorSecondary", 37, BreatheParams, colorSecondary),
+    BOOL_PARAM("twoColor", 37, BreatheParams, twoColor),
+    // 38 Dissolve
+    RANGE_PARAM("repeatSpeed", 38, DissolveParams, repeatSpeed, 50, 200),
+    RANGE_PARAM("dissolveSpeed", 38, DissolveParams, dissolveSpeed, 50, 200),
+    BOOL_PARAM("randomColors", 38, DissolveParams, randomColors),
+    COLOR_PARAM("color", 38, DissolveParams, color),
+    // 39 Fade
+    UINT8_PARAM("speed", 39, FadeParams, speed),
+    COLOR_PARAM("color1", 39, FadeParams, colors[0]),
+    COLOR_PARAM("color2", 39, FadeParams, colors[1]),
+    COLOR_PARAM("color3", 39, FadeParams, colors[2]),
+    COLOR_PARAM("color4", 39, FadeParams, colors[3]),
+    COLOR_PARAM("color5", 39, FadeParams, colors[4]),
+    COLOR_PARAM("color6", 39, FadeParams, colors[5]),
+    COLOR_PARAM("color7", 39, FadeParams, colors[6]),
+    COLOR_PARAM("color8", 39, FadeParams, colors[7]),
+    RANGE_PARAM("numColors", 39, FadeParams, numColors, 2, 8),
+    BOOL_PARAM("loop", 39, FadeParams, loop),
+    // 40 Police
+    UINT8_PARAM("speed", 40, PoliceLightsParams, speed),
+    COLOR_PARAM("color1", 40, PoliceLightsParams, color1),
+    COLOR_PARAM("color2", 40, PoliceLightsParams, color2),
+    ENUM_PARAM("style", 40, PoliceLightsParams, style, POLICE_ALTERNATING),
+    // 41 Strobe
+    RANGE_PARAM("frequency", 41, StrobeParams, frequency, 50, 255),
+    COLOR_PARAM("color", 41, StrobeParams, color),
+    ENUM_PARAM("mode", 41, StrobeParams, mode, STROBE_RAINBOW),
+};
+
+#define NUM_PARAMS (sizeof(paramTable) / sizeof(paramTable[0]))
+
+static_assert(NUM_PARAMS < 255, "paramIndex stores row + 1 in a byte");
+
+// ============================================================================
+// Staging
+// ============================================================================
+// One staged copy per params struct, 4-byte aligned in a single buffer.
+// Writers set the effect's bit in paramsStaged; both sides hold
+// LEDController's state lock while touching the staged copies.
+
+constexpr size_t paramStagingSize(size_t i = 0) {
+    return i == NUM_PARAM_BLOCKS ? 0 : ((effectParamBlocks[i].size + 3) & ~3) + paramStagingSize(i + 1);
+}
+
+alignas(4) uint8_t paramStaging[paramStagingSize()];
+uint8_t* stagedParams[NUM_PARAM_BLOCKS];
+uint64_t paramsStaged = 0;
+
+// Start every staged copy from the live defaults
+inline void initParamStaging() {
+    uint8_t* next = paramStaging;
+    for (uint8_t i = 0; i < NUM_PARAM_BLOCKS; i++) {
+        stagedParams[i] = next;
+        memcpy(next, effectParamBlocks[i].params, effectParamBlocks[i].size);
+        next += (effectParamBlocks[i].size + 3) & ~3;
+    }
+}
+
+// LED task, frame boundary: staged -> live for every effect written since
+// the last commit. Returns true if anything was copied.
+inline bool commitStagedParams() {
+    if (paramsStaged == 0) return false;
+    for (uint8_t i = 0; i < NUM_PARAM_BLOCKS; i++) {
+        if (paramsStaged & (1ULL << i)) {
+            memcpy(effectParamBlocks[i].params, stagedParams[i], effectParamBlocks[i].size);
+        }
+    }
+    paramsStaged = 0;
+    return true;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+// Open-addressed hash of (key, effect) -> row, built once from the table
+// along with the staged copies. paramRange gives each effect's rows for
+// reporting.
+
+#define PARAM_INDEX_SIZE    512     // Power of two, about 40% full
+
+uint8_t paramIndex[PARAM_INDEX_SIZE];   // Row + 1, 0 = empty
+struct ParamRange { uint8_t first; uint8_t count; };
+ParamRange paramRange[NUM_PARAM_BLOCKS];
+bool paramIndexBuilt = false;
+
+// FNV-1a over the key, then the effect
+inline uint16_t paramHash(const char* key, uint8_t effect) {
+    uint32_t h = 2166136261UL;
+    while (*key) {
+        h = (h ^ (uint8_t)*key++) * 16777619UL;
+    }
+    h = (h ^ effect) * 16777619UL;
+    return (h ^ (h >> 16)) & (PARAM_INDEX_SIZE - 1);
+}
+
+inline void buildParamIndex() {
+    if (paramIndexBuilt) return;
+    memset(paramIndex, 0, sizeof(paramIndex));
+    memset(paramRange, 0, sizeof(paramRange));
+    for (uint8_t i = 0; i < NUM_PARAMS; i++) {
+        const ParamDesc& p = paramTable[i];
+        uint16_t slot = paramHash(p.key, p.effect);
+        while (paramIndex[slot] != 0) slot = (slot + 1) & (PARAM_INDEX_SIZE - 1);
+        paramIndex[slot] = i + 1;
+
+        if (paramRange[p.effect].count == 0) paramRange[p.effect].first = i;
+        paramRange[p.effect].count++;
+    }
+    initParamStaging();
+    paramIndexBuilt = true;
+}
+
+// Descriptor of `key` on `effect`, NULL if the effect has no such parameter
+inline const ParamDesc* findParam(const char* key, uint8_t effect) {
+    if (effect >= NUM_PARAM_BLOCKS) return NULL;
+    buildParamIndex();
+    uint16_t slot = paramHash(key, effect);
+    while (paramIndex[slot] != 0) {
+        const ParamDesc& p = paramTable[paramIndex[slot] - 1];
+        if (p.effect == effect && strcmp(p.key, key) == 0) return &p;
+        slot = (slot + 1) & (PARAM_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// Access
+// ============================================================================
+// Reads and writes go to the staged copy.
+
+inline void* paramField(const ParamDesc& p) {
+    return stagedParams[p.effect] + p.offset;
+}
+
+// Stored value in JSON units (colors excluded)
+inline int readParam(const ParamDesc& p) {
+    void* field = paramField(p);
+    switch (p.type) {
+        case PARAM_UINT16: return *(uint16_t*)field / p.scale;
+        case PARAM_BOOL: return *(bool*)field;
+        case PARAM_ENUM: {
+            int v;
+            memcpy(&v, field, sizeof(v));
+            return v;
+        }
+        default: return *(uint8_t*)field;
+    }
+}
+
+// Store a JSON value, clamped to the descriptor's range (colors excluded)
+inline void writeParam(const ParamDesc& p, int value) {
+    void* field = paramField(p);
+    int v = constrain(value, (int)p.min, (int)p.max);
+    switch (p.type) {
+        case PARAM_UINT16: *(uint16_t*)field = v * p.scale; break;
+        case PARAM_BOOL: *(bool*)field = v != 0; break;
+        case PARAM_ENUM: memcpy(field, &v, sizeof(v)); break;
+        default: *(uint8_t*)field = v; break;
+    }
+    paramsStaged |= 1ULL << p.effect;
+}
+
+inline CRGB readParamColor(const ParamDesc& p) {
+    return *(CRGB*)paramField(p);
+}
+
+inline void writeParamColor(const ParamDesc& p, CRGB color) {
+    *(CRGB*)paramField(p) = color;
+    paramsStaged |= 1ULL << p.effect;
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+// Params are stored as the raw struct bytes. A stored copy is only taken back
+// under the same layout fingerprint: any change to the struct size or to a
+// row's key, type, offset or range makes it stale.
+
+constexpr size_t paramBlockMaxSize(size_t i = 0, size_t largest = 0) {
+    return i == NUM_PARAM_BLOCKS ? largest :
+           paramBlockMaxSize(i + 1, effectParamBlocks[i].size > largest ? effectParamBlocks[i].size : largest);
+}
+
+// FNV-1a over the block size and the effect's rows
+inline uint32_t paramLayout(uint8_t effect) {
+    uint32_t h = 2166136261UL;
+    auto mix = [&h](uint32_t v, uint8_t bytes) {
+        for (uint8_t i = 0; i < bytes; i++, v >>= 8) h = (h ^ (v & 0xFF)) * 16777619UL;
+    };
+    mix(effectParamBlocks[effect].size, 2);
+    for (uint8_t i = 0; i < NUM_PARAMS; i++) {
+        const ParamDesc& p = paramTable[i];
+        if (p.effect != effect) continue;
+        for (const char* c = p.key; *c; c++) mix((uint8_t)*c, 1);
+        mix(p.type, 1);
+        mix(p.offset, 2);
+        mix(p.min, 1);
+        mix(p.max, 1);
+        mix(p.scale, 1);
+    }
+    return h;
+}
+
+#endif // PARAM_REGISTRY_H
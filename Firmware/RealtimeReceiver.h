@@ -0,0 +1,342 @@
+/*
+ * RealtimeReceiver.h - DDP / E1.31 / Art-Net pixel input over UDP
+ *
+ * Lets a sequencer (xLights, Vixen, ...) drive the strip at its own frame
+ * rate. Pixel data goes from the received packet straight into the render
+ * buffer; LEDController suspends the effects while frames keep coming.
+ */
+
+#ifndef REALTIME_RECEIVER_H
+#define REALTIME_RECEIVER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <lwip/sockets.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "LEDController.h"
+
+// ============================================================================
+// RealtimeReceiver
+// ============================================================================
+// - DDP (4048): RGB data at a byte offset, frame shown on the push flag
+// - E1.31/sACN (5568, unicast) and Art-Net (6454): 170 pixels per universe,
+//   pixel 0 in REALTIME_E131_UNIVERSE / REALTIME_ARTNET_UNIVERSE. A frame is
+//   shown when the universe holding the last pixel arrives (with Art-Net,
+//   on ArtSync once the sender uses it); a universe arriving twice first
+//   shows what came so far, counted as incomplete
+// - Late or repeated packets (by sequence number) are dropped, gaps are
+//   counted as packets lost
+// ============================================================================
+
+#define DDP_HEADER_LEN          10
+#define DDP_FLAG_PUSH           0x01
+#define DDP_FLAG_QUERY          0x02
+#define DDP_FLAG_REPLY          0x04
+#define DDP_FLAG_TIMECODE       0x10      // 4 more header bytes
+#define DDP_VERSION_MASK        0xC0
+#define DDP_VERSION_1           0x40
+#define DDP_TYPE_RGB8           0x0B
+#define DDP_ID_DISPLAY          1
+
+#define E131_DATA_OFFSET        126       // First slot after the start code
+#define E131_VECTOR_ROOT_DATA   0x00000004
+#define E131_VECTOR_FRAME_DATA  0x00000002
+#define E131_OPT_PREVIEW        0x80
+
+#define ARTNET_HEADER_LEN       18
+#define ARTNET_OP_DMX           0x5000
+#define ARTNET_OP_SYNC          0x5200
+
+#define REALTIME_MAX_UNIVERSES  32        // One bit each in a frame's mask
+
+class RealtimeReceiver {
+public:
+    enum Protocol : uint8_t { PROTO_DDP, PROTO_E131, PROTO_ARTNET, NUM_PROTOCOLS };
+
+    // Open the three UDP ports and start the receive task (Station mode)
+    static bool begin() {
+        LOG_SECTION("Initializing Realtime Receiver");
+
+        static const uint16_t ports[NUM_PROTOCOLS] = {REALTIME_DDP_PORT, REALTIME_E131_PORT, REALTIME_ARTNET_PORT};
+        for (uint8_t i = 0; i < NUM_PROTOCOLS; i++) {
+            sockets[i] = openSocket(ports[i]);
+            if (sockets[i] < 0) {
+                LOG_PRINTF("ERROR", "Cannot open UDP port %d", ports[i]);
+                end();
+                return false;
+            }
+        }
+        resetSequences();
+
+        xTaskCreatePinnedToCore(receiveTask, "Realtime", TASK_STACK_SIZE_REALTIME, NULL,
+                                TASK_PRIORITY_REALTIME, &taskHandle, 1);
+        LOG_PRINTF("INFO ", "DDP on UDP %d, E1.31 on %d, Art-Net on %d", REALTIME_DDP_PORT,
+                   REALTIME_E131_PORT, REALTIME_ARTNET_PORT);
+        return true;
+    }
+
+    static void end() {
+        for (uint8_t i = 0; i < NUM_PROTOCOLS; i++) {
+            if (sockets[i] >= 0) close(sockets[i]);
+            sockets[i] = -1;
+        }
+    }
+
+    // Wait up to timeoutMs for packets and handle all that are queued.
+    // Returns the number read. The receive task's loop; public so host
+    // tools can drive it.
+    static uint16_t poll(uint32_t timeoutMs) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        int maxFd = -1;
+        for (uint8_t i = 0; i < NUM_PROTOCOLS; i++) {
+            if (sockets[i] < 0) continue;
+            FD_SET(sockets[i], &readable);
+            if (sockets[i] > maxFd) maxFd = sockets[i];
+        }
+        if (maxFd < 0) return 0;
+
+        struct timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        if (select(maxFd + 1, &readable, NULL, NULL, &timeout) <= 0) return 0;
+
+        uint16_t count = 0;
+        for (uint8_t i = 0; i < NUM_PROTOCOLS; i++) {
+            if (sockets[i] < 0 || !FD_ISSET(sockets[i], &readable)) continue;
+            int len;
+            while ((len = recvfrom(sockets[i], packet, sizeof(packet), MSG_DONTWAIT, NULL, NULL)) > 0) {
+                handlePacket((Protocol)i, packet, len);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // One datagram. Returns false (and counts it) if it is malformed or of
+    // a kind this receiver does not take.
+    static bool handlePacket(Protocol protocol, const uint8_t* data, size_t len) {
+        // A new stream starts without history
+        if (!LEDController::isRealtimeActive()) resetSequences();
+
+        bool ok;
+        switch (protocol) {
+            case PROTO_DDP:    ok = handleDdp(data, len); break;
+            case PROTO_E131:   ok = handleE131(data, len); break;
+            case PROTO_ARTNET: ok = handleArtNet(data, len); break;
+            default:           ok = false; break;
+        }
+        if (ok) packets++;
+        else invalidPackets++;
+        return ok;
+    }
+
+    static uint32_t getPackets() { return packets; }
+    static uint32_t getInvalidPackets() { return invalidPackets; }
+    static uint32_t getPacketsLost() { return packetsLost; }
+    static uint32_t getFrames() { return frames; }
+    static uint32_t getFramesIncomplete() { return framesIncomplete; }
+
+    static void getStatusJson(JsonObject status) {
+        status["packets"] = packets;
+        status["invalid"] = invalidPackets;
+        status["lost"] = packetsLost;
+        status["frames"] = frames;
+        status["incomplete"] = framesIncomplete;
+    }
+
+private:
+    static int sockets[NUM_PROTOCOLS];
+    static TaskHandle_t taskHandle;
+    static uint8_t packet[REALTIME_MAX_PACKET];
+    static int16_t ddpSeq;                               // -1: none seen yet
+    static int16_t universeSeq[NUM_PROTOCOLS][REALTIME_MAX_UNIVERSES];
+    static uint32_t universesReceived;                  // Of the frame being assembled
+    static bool syncSeen;                               // Art-Net sender uses ArtSync
+    static uint32_t lastSync;
+    static uint32_t packets;
+    static uint32_t invalidPackets;
+    static uint32_t packetsLost;
+    static uint32_t frames;
+    static uint32_t framesIncomplete;
+
+    static void receiveTask(void* param) {
+        while (true) poll(1000);
+    }
+
+    static int openSocket(uint16_t port) {
+        int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (fd < 0) return -1;
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static void resetSequences() {
+        ddpSeq = -1;
+        for (uint8_t p = 0; p < NUM_PROTOCOLS; p++) {
+            for (uint8_t i = 0; i < REALTIME_MAX_UNIVERSES; i++) universeSeq[p][i] = -1;
+        }
+        universesReceived = 0;
+        syncSeen = false;
+    }
+
+    static uint16_t be16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+    static uint32_t be32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | (p[2] << 8) | p[3]; }
+
+    // Universes needed for the strip at REALTIME_UNIVERSE_CHANNELS each
+    static uint8_t numUniverses() {
+        uint16_t n = (LEDController::getNumLeds() * 3 + REALTIME_UNIVERSE_CHANNELS - 1) / REALTIME_UNIVERSE_CHANNELS;
+        return n < REALTIME_MAX_UNIVERSES ? n : REALTIME_MAX_UNIVERSES;
+    }
+
+    // Track a sequence number cycling through `modulus` values. False for a
+    // repeated or late packet; a gap is counted as packets lost.
+    static bool checkSequence(int16_t& last, uint8_t seq, uint16_t modulus) {
+        if (last >= 0) {
+            uint16_t step = (seq + modulus - last) % modulus;
+            if (step == 0 || step > modulus / 2) return false;
+            packetsLost += step - 1;
+        }
+        last = seq;
+        return true;
+    }
+
+    // Copy RGB bytes to the render buffer at a byte offset, clipped to the
+    // strip; show the frame if it is complete
+    static void writePixels(uint32_t offset, const uint8_t* data, size_t len, bool show) {
+        uint32_t total = (uint32_t)LEDController::getNumLeds() * 3;
+        uint8_t* leds = (uint8_t*)LEDController::beginRealtimeFrame();
+        if (offset < total) memcpy(leds + offset, data, min((uint32_t)len, total - offset));
+        LEDController::endRealtimeFrame(show);
+        if (show) frames++;
+    }
+
+    // Show what the render buffer holds now
+    static void showFrame() {
+        LEDController::beginRealtimeFrame();
+        LEDController::endRealtimeFrame(true);
+        frames++;
+    }
+
+    // Header: flags (version, push, timecode), sequence (low nibble, 0 =
+    // unused), data type, destination, offset (BE32), length (BE16)
+    static bool handleDdp(const uint8_t* p, size_t len) {
+        if (len < DDP_HEADER_LEN || (p[0] & DDP_VERSION_MASK) != DDP_VERSION_1) return false;
+        // Status and config queries go unanswered: not discoverable
+        if (p[0] & (DDP_FLAG_QUERY | DDP_FLAG_REPLY)) return false;
+        if (p[3] != DDP_ID_DISPLAY || (p[2] != 0 && p[2] != DDP_TYPE_RGB8)) return false;
+
+        size_t header = (p[0] & DDP_FLAG_TIMECODE) ? DDP_HEADER_LEN + 4 : DDP_HEADER_LEN;
+        uint16_t dataLen = be16(p + 8);
+        if (len < header + dataLen) return false;
+
+        uint8_t seq = p[1] & 0x0F;
+        if (seq != 0 && !checkSequence(ddpSeq, seq - 1, 15)) return true;
+
+        writePixels(be32(p + 4), p + header, dataLen, p[0] & DDP_FLAG_PUSH);
+        return true;
+    }
+
+    // ANSI E1.31 data packet: root, framing and DMP layers at fixed offsets
+    static bool handleE131(const uint8_t* p, size_t len) {
+        static const uint8_t packetId[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+        if (len < E131_DATA_OFFSET || memcmp(p + 4, packetId, sizeof(packetId)) != 0) return false;
+        if (be32(p + 18) != E131_VECTOR_ROOT_DATA || be32(p + 40) != E131_VECTOR_FRAME_DATA) return false;
+        if (p[117] != 0x02 || p[118] != 0xA1) return false;
+
+        uint16_t slots = be16(p + 123);          // Start code included
+        if (slots < 1 || len < (size_t)E131_DATA_OFFSET - 1 + slots) return false;
+        // Preview data and non-dimmer start codes are not for the strip
+        if ((p[112] & E131_OPT_PREVIEW) || p[125] != 0) return true;
+
+        return handleUniverse(PROTO_E131, be16(p + 113) - REALTIME_E131_UNIVERSE, p[111], 256,
+                              p + E131_DATA_OFFSET, slots - 1, false);
+    }
+
+    // "Art-Net\0", opcode (LE16), version, sequence (0 = unused), physical,
+    // port-address (LE15), length (BE16)
+    static bool handleArtNet(const uint8_t* p, size_t len) {
+        if (len < 10 || memcmp(p, "Art-Net", 8) != 0) return false;
+        uint16_t opcode = p[8] | (p[9] << 8);
+
+        if (opcode == ARTNET_OP_SYNC) {
+            syncSeen = true;
+            lastSync = millis();
+            if (universesReceived != 0) {
+                if (universesReceived != fullMask()) framesIncomplete++;
+                universesReceived = 0;
+                showFrame();
+            }
+            return true;
+        }
+        if (opcode != ARTNET_OP_DMX || len < ARTNET_HEADER_LEN) return false;
+
+        uint16_t dataLen = be16(p + 16);
+        if (len < (size_t)ARTNET_HEADER_LEN + dataLen) return false;
+
+        // Without ArtSync for a while the sender has stopped using it
+        bool synced = syncSeen && millis() - lastSync < LED_REALTIME_TIMEOUT_MS;
+        uint16_t portAddress = p[14] | ((p[15] & 0x7F) << 8);
+        uint8_t seq = p[12];
+        return handleUniverse(PROTO_ARTNET, portAddress - REALTIME_ARTNET_UNIVERSE, seq == 0 ? -1 : seq - 1, 255,
+                              p + ARTNET_HEADER_LEN, dataLen, synced);
+    }
+
+    static uint32_t fullMask() {
+        uint8_t n = numUniverses();
+        return n >= 32 ? 0xFFFFFFFF : (1UL << n) - 1;
+    }
+
+    // One universe of channel data. index: universe relative to pixel 0,
+    // seq: -1 if the sender does not number packets
+    static bool handleUniverse(Protocol protocol, int index, int seq, uint16_t modulus, const uint8_t* data, size_t len,
+                               bool synced) {
+        // Another device's universe
+        if (index < 0 || index >= numUniverses()) return true;
+        if (seq >= 0 && !checkSequence(universeSeq[protocol][index], seq, modulus)) return true;
+
+        uint32_t bit = 1UL << index;
+        if (universesReceived & bit) {
+            // The next frame has begun before this one completed
+            framesIncomplete++;
+            universesReceived = 0;
+            showFrame();
+        }
+        universesReceived |= bit;
+
+        bool last = index == numUniverses() - 1 && !synced;
+        if (last) {
+            if (universesReceived != fullMask()) framesIncomplete++;
+            universesReceived = 0;
+        }
+        writePixels((uint32_t)index * REALTIME_UNIVERSE_CHANNELS, data,
+                    min(len, (size_t)REALTIME_UNIVERSE_CHANNELS), last);
+        return true;
+    }
+};
+
+int RealtimeReceiver::sockets[RealtimeReceiver::NUM_PROTOCOLS] = {-1, -1, -1};
+TaskHandle_t RealtimeReceiver::taskHandle = NULL;
+uint8_t RealtimeReceiver::packet[REALTIME_MAX_PACKET];
+int16_t RealtimeReceiver::ddpSeq = -1;
+int16_t RealtimeReceiver::universeSeq[RealtimeReceiver::NUM_PROTOCOLS][REALTIME_MAX_UNIVERSES];
+uint32_t RealtimeReceiver::universesReceived = 0;
+bool RealtimeReceiver::syncSeen = false;
+uint32_t RealtimeReceiver::lastSync = 0;
+uint32_t RealtimeReceiver::packets = 0;
+uint32_t RealtimeReceiver::invalidPackets = 0;
+uint32_t RealtimeReceiver::packetsLost = 0;
+uint32_t RealtimeReceiver::frames = 0;
+uint32_t RealtimeReceiver::framesIncomplete = 0;
+
+#endif // REALTIME_RECEIVER_H
@@ -0,0 +1,129 @@
+/*
+ * StaticPayloads.h - API responses that never change at runtime
+ *
+ * The effect list, palette list and parameter schema are fixed by the
+ * firmware, so they are serialized once at boot and served from the same
+ * buffer on every request, with a content hash as ETag. No AsyncWebServer
+ * types, so it also builds on the host.
+ */
+
+#ifndef STATIC_PAYLOADS_H
+#define STATIC_PAYLOADS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "LEDController.h"
+
+// ============================================================================
+// StaticPayloads
+// ============================================================================
+// - EFFECTS:  [{"id": 0, "name": "Solid", "category": 0}, ...]
+// - PALETTES: [{"id": 0, "name": "Rainbow"}, ...]
+// - SCHEMA:   [{"id": 0, "params": [{"key": "color", "type": "color"},
+//               {"key": "speed", "type": "int", "min": 1, "max": 255}, ...]}]
+//   types: int (min/max), bool, color ("#RRGGBB"), enum (0..max)
+// Buffers go to PSRAM when the board has it.
+// ============================================================================
+
+struct StaticPayload {
+    const char* data;       // JSON, NUL-terminated; NULL if not built
+    size_t len;
+    char etag[11];          // Quoted FNV-1a of the bytes: "\"1a2b3c4d\""
+};
+
+class StaticPayloads {
+public:
+    enum Id : uint8_t { EFFECTS, PALETTES, SCHEMA, NUM_PAYLOADS };
+
+    // Serialize every payload (boot; later calls do nothing)
+    static bool begin() {
+        if (built) return true;
+        bool ok = true;
+        for (uint8_t i = 0; i < NUM_PAYLOADS; i++) {
+            StaticJsonDocument<8192> doc;
+            if (i == EFFECTS) LEDController::getEffectsJson(doc);
+            else if (i == PALETTES) writePalettes(doc.to<JsonArray>());
+            else writeSchema(doc.to<JsonArray>());
+            ok &= store(payloads[i], doc);
+        }
+        built = true;
+        LOG_PRINTF("INFO ", "Static payloads: effects %u B, palettes %u B, schema %u B",
+                   (unsigned)payloads[EFFECTS].len, (unsigned)payloads[PALETTES].len,
+                   (unsigned)payloads[SCHEMA].len);
+        return ok;
+    }
+
+    static const StaticPayload& get(Id id) {
+        return payloads[id < NUM_PAYLOADS ? id : EFFECTS];
+    }
+
+    // Whether an If-None-Match header value names the payload's ETag
+    // (a list of tags, weak tags or "*")
+    static bool matches(Id id, const char* ifNoneMatch) {
+        const StaticPayload& payload = get(id);
+        if (payload.data == NULL || ifNoneMatch == NULL) return false;
+        if (strcmp(ifNoneMatch, "*") == 0) return true;
+        return strstr(ifNoneMatch, payload.etag) != NULL;
+    }
+
+private:
+    static StaticPayload payloads[NUM_PAYLOADS];
+    static bool built;
+
+    static void writePalettes(JsonArray arr) {
+        for (uint8_t i = 0; i <= PALETTE_CYBER; i++) {
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = i;
+            obj["name"] = getPaletteName((PaletteType)i);
+        }
+    }
+
+    static void writeSchema(JsonArray arr) {
+        static const char* const typeNames[] = {"int", "int", "bool", "color", "enum"};
+        buildParamIndex();
+        for (uint8_t i = 0; i < NUM_PARAM_BLOCKS; i++) {
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = i;
+            JsonArray params = obj["params"].to<JsonArray>();
+            const ParamRange& range = paramRange[i];
+            for (uint8_t r = range.first; r < range.first + range.count; r++) {
+                const ParamDesc& p = paramTable[r];
+                if (p.flags & PARAM_ALIAS) continue;
+                JsonObject param = params.add<JsonObject>();
+                param["key"] = p.key;
+                param["type"] = typeNames[p.type];
+                if (p.type == PARAM_UINT8 || p.type == PARAM_UINT16 || p.type == PARAM_ENUM) {
+                    param["min"] = p.min;
+                    param["max"] = p.max;
+                }
+            }
+        }
+    }
+
+    // Serialize into a buffer of its own and tag it
+    static bool store(StaticPayload& payload, JsonDocument& doc) {
+        size_t len = measureJson(doc);
+        char* buf = NULL;
+        if (psramFound()) buf = (char*)heap_caps_calloc(len + 1, 1, MALLOC_CAP_SPIRAM);
+        if (buf == NULL) buf = (char*)heap_caps_calloc(len + 1, 1, MALLOC_CAP_8BIT);
+        if (buf == NULL) {
+            LOG_PRINTF("ERROR", "No memory for a %u byte payload", (unsigned)len);
+            return false;
+        }
+        serializeJson(doc, buf, len + 1);
+
+        uint32_t h = 2166136261UL;
+        for (size_t i = 0; i < len; i++) h = (h ^ (uint8_t)buf[i]) * 16777619UL;
+        snprintf(payload.etag, sizeof(payload.etag), "\"%08lx\"", (unsigned long)h);
+        payload.data = buf;
+        payload.len = len;
+        return true;
+    }
+};
+
+StaticPayload StaticPayloads::payloads[StaticPayloads::NUM_PAYLOADS] = {};
+bool StaticPayloads::built = false;
+
+#endif // STATIC_PAYLOADS_H
@@ -0,0 +1,158 @@
+/*
+ * effect_bench.cpp - Per-effect frame-time benchmark
+ *
+ * Drives every EffectEntry::func in LEDController's effect table for N frames
+ * of virtual time and reports min / median / p99 ns per frame and ns per pixel.
+ * Built once per chain length (effect_bench_<leds>, ARGB_NUM_LEDS set by CMake);
+ * run_bench.sh runs them all and merges the output.
+ *
+ * Usage: effect_bench_<leds> [--frames N] [--warmup N] [--preset NAME|all]
+ *                            [--format csv|jsonl] [--no-header]
+ */
+
+#include <chrono>
+#include <vector>
+#include "LEDController.h"
+
+// ============================================================================
+// Parameter Presets (same keys as POST /api/led/params)
+// ============================================================================
+
+struct BenchPreset {
+    const char* name;
+    const char* paramsJson;
+};
+
+static const BenchPreset presets[] = {
+    // Firmware defaults from EffectDefs.h
+    {"default", "{}"},
+    // Worst case: every density/count/speed knob at its maximum
+    {"max", "{\"speed\":255,\"intensity\":255,\"density\":255,\"numDots\":8,\"trailLength\":50,"
+            "\"dualMode\":true,\"numColors\":8,\"numBalls\":8,\"trail\":20,\"numDrips\":8,"
+            "\"numFlashers\":255,\"fragments\":16,\"chance\":255,\"sparking\":200,\"boost\":true,"
+            "\"spawningRate\":255,\"frequency\":255,\"twinkleRate\":255,\"multiMode\":true,"
+            "\"colorShift\":100,\"shootingStars\":true,\"sparkleEnabled\":true,\"blobSize\":40,"
+            "\"dissolveSpeed\":255,\"repeatSpeed\":255,\"colorMode\":3,\"pattern\":2}"},
+};
+
+static void applyPreset(const BenchPreset& preset) {
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, preset.paramsJson)) return;
+    for (JsonPair kv : doc.as<JsonObject>()) {
+        LEDController::setParam(kv.key().c_str(), kv.value());
+    }
+    commitStagedParams();  // measure() renders outside renderFrame's frame boundary
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+struct BenchResult {
+    uint32_t minNs;
+    uint32_t medianNs;
+    uint32_t p99Ns;
+    uint32_t maxNs;
+    double meanNs;
+};
+
+static BenchResult measure(uint8_t id, uint32_t warmup, uint32_t frames) {
+    const uint32_t frameMicros = LED_FRAME_MICROS;
+    std::vector<uint32_t> samples;
+    samples.reserve(frames);
+
+    LEDController::EffectInstance effect;
+    LEDController::startEffect(effect, id);
+    for (uint32_t f = 0; f < warmup + frames; f++) {
+        auto start = std::chrono::steady_clock::now();
+        LEDController::renderEffect(effect);
+        auto end = std::chrono::steady_clock::now();
+        HostClock::advanceMicros(frameMicros);
+
+        if (f >= warmup) {
+            samples.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+    LEDController::stopEffect(effect);
+
+    std::vector<uint32_t> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (uint32_t s : sorted) sum += s;
+
+    BenchResult r;
+    r.minNs = sorted.front();
+    r.medianNs = sorted[sorted.size() / 2];
+    r.p99Ns = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+    r.maxNs = sorted.back();
+    r.meanNs = sum / sorted.size();
+    return r;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint32_t frames = 1000;
+    uint32_t warmup = 60;
+    const char* presetName = "all";
+    bool jsonl = false;
+    bool header = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) warmup = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--preset") && i + 1 < argc) presetName = argv[++i];
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc) jsonl = !strcmp(argv[++i], "jsonl");
+        else if (!strcmp(argv[i], "--no-header")) header = false;
+        else {
+            fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--preset default|max|all] "
+                            "[--format csv|jsonl] [--no-header]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames == 0) frames = 1;
+
+    LEDController::begin();
+
+    if (header && !jsonl) {
+        printf("effect_id,effect,category,leds,preset,frames,min_ns,median_ns,p99_ns,max_ns,mean_ns,"
+               "ns_per_pixel,budget_pct\n");
+    }
+
+    const double budgetNs = 1e9 / LED_TARGET_FPS;
+
+    for (const BenchPreset& preset : presets) {
+        if (strcmp(presetName, "all") != 0 && strcmp(presetName, preset.name) != 0) continue;
+
+        for (uint8_t id = 0; id < LEDController::getNumEffects(); id++) {
+            const LEDController::EffectEntry& effect = LEDController::getEffect(id);
+
+            // Same seed and clock for every run so results are comparable between commits
+            random16_set_seed(1337);
+            HostClock::setMicros(0);
+            LEDController::setEffect(id);
+            applyPreset(preset);
+            clearLeds();
+
+            BenchResult r = measure(id, warmup, frames);
+            double nsPerPixel = (double)r.medianNs / ARGB_NUM_LEDS;
+            double budgetPct = 100.0 * r.p99Ns / budgetNs;
+
+            if (jsonl) {
+                printf("{\"effect_id\":%u,\"effect\":\"%s\",\"category\":%u,\"leds\":%u,\"preset\":\"%s\","
+                       "\"frames\":%u,\"min_ns\":%u,\"median_ns\":%u,\"p99_ns\":%u,\"max_ns\":%u,"
+                       "\"mean_ns\":%.1f,\"ns_per_pixel\":%.2f,\"budget_pct\":%.3f}\n",
+                       id, effect.name, effect.category, ARGB_NUM_LEDS, preset.name, frames,
+                       r.minNs, r.medianNs, r.p99Ns, r.maxNs, r.meanNs, nsPerPixel, budgetPct);
+            } else {
+                printf("%u,%s,%u,%u,%s,%u,%u,%u,%u,%u,%.1f,%.2f,%.3f\n",
+                       id, effect.name, effect.category, ARGB_NUM_LEDS, preset.name, frames,
+                       r.minNs, r.medianNs, r.p99Ns, r.maxNs, r.meanNs, nsPerPixel, budgetPct);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * effect_golden.cpp - Golden-frame regression check for effect output
+ *
+ * Renders every effect from a pinned state (random16 seed, virtual clock,
+ * default params, cleared strip) and compares leds[] at fixed checkpoint
+ * frames against golden/effects_<leds>.golden. A checkpoint passes when its
+ * FNV-1a hash matches (bit-exact) or, with --tolerance N, when no channel of
+ * any pixel differs by more than N.
+ *
+ * Usage: effect_golden <golden-file> [--update] [--tolerance N] [--effect ID]
+ *
+ * --update rewrites the golden file from the current build. Only do that when
+ * a change of look is intended, and say so in the commit.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include "LEDController.h"
+
+#define GOLDEN_SEED         1337
+#define GOLDEN_FRAMES       300     // 5 s at LED_TARGET_FPS
+
+// Frames (1-based) at which leds[] is captured
+static const uint16_t checkpoints[] = {1, 10, 60, 150, 300};
+
+// ============================================================================
+// Frame Capture
+// ============================================================================
+
+struct GoldenFrame {
+    uint64_t hash;
+    std::vector<uint8_t> rgb;
+};
+
+// Key: effect id << 16 | frame
+typedef std::map<uint32_t, GoldenFrame> GoldenSet;
+
+static uint64_t fnv1a(const uint8_t* data, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static void renderEffect(uint8_t id, GoldenSet& out) {
+    const uint32_t frameMicros = LED_FRAME_MICROS;
+    const uint8_t* raw = (const uint8_t*)leds;
+    const size_t rawLen = sizeof(CRGB) * ARGB_NUM_LEDS;
+
+    random16_set_seed(GOLDEN_SEED);
+    HostClock::setMicros(0);
+    LEDController::setEffect(id);
+    clearLeds();
+    LEDController::EffectInstance effect;
+    LEDController::startEffect(effect, id);
+
+    size_t next = 0;
+    for (uint16_t frame = 1; frame <= GOLDEN_FRAMES; frame++) {
+        LEDController::renderEffect(effect);
+        HostClock::advanceMicros(frameMicros);
+
+        if (next < sizeof(checkpoints) / sizeof(checkpoints[0]) && frame == checkpoints[next]) {
+            GoldenFrame& g = out[((uint32_t)id << 16) | frame];
+            g.rgb.assign(raw, raw + rawLen);
+            g.hash = fnv1a(raw, rawLen);
+            next++;
+        }
+    }
+    LEDController::stopEffect(effect);
+}
+
+// ============================================================================
+// Golden File I/O
+// ============================================================================
+// One checkpoint per line: "<effect id> <frame> <hash> <rgb hex>"
+
+static bool loadGolden(const char* path, GoldenSet& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char line[ARGB_NUM_LEDS * 6 + 128];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        unsigned id, frame;
+        unsigned long long hash;
+        int consumed = 0;
+        if (sscanf(line, "%u %u %llx %n", &id, &frame, &hash, &consumed) != 3) continue;
+
+        GoldenFrame& g = out[(id << 16) | frame];
+        g.hash = hash;
+        const char* hex = line + consumed;
+        for (size_t i = 0; i < sizeof(CRGB) * ARGB_NUM_LEDS && hex[0] && hex[1]; i++, hex += 2) {
+            unsigned byte;
+            if (sscanf(hex, "%2x", &byte) != 1) break;
+            g.rgb.push_back((uint8_t)byte);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool saveGolden(const char* path, const GoldenSet& set) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "# PixelTree golden frames: leds=%u seed=%u fps=%u frames=%u\n",
+            ARGB_NUM_LEDS, GOLDEN_SEED, LED_TARGET_FPS, GOLDEN_FRAMES);
+    fprintf(f, "# <effect id> <frame> <fnv1a-64> <rgb hex>\n");
+    for (const auto& kv : set) {
+        fprintf(f, "%u %u %016llx ", kv.first >> 16, kv.first & 0xFFFF, (unsigned long long)kv.second.hash);
+        for (uint8_t b : kv.second.rgb) fprintf(f, "%02x", b);
+        fputc('\n', f);
+    }
+    fclose(f);
+    return true;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    bool update = false;
+    int tolerance = 0;
+    int onlyEffect = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--update")) update = true;
+        else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc) tolerance = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--effect") && i + 1 < argc) onlyEffect = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else path = NULL, i = argc;
+    }
+    if (!path) {
+        fprintf(stderr, "Usage: %s <golden-file> [--update] [--tolerance N] [--effect ID]\n", argv[0]);
+        return 2;
+    }
+
+    LEDController::begin();
+
+    GoldenSet current;
+    for (uint8_t id = 0; id < LEDController::getNumEffects(); id++) {
+        if (onlyEffect >= 0 && id != onlyEffect) continue;
+        renderEffect(id, current);
+    }
+
+    if (update) {
+        if (onlyEffect >= 0) {
+            fprintf(stderr, "--update needs the full effect set (drop --effect)\n");
+            return 2;
+        }
+        if (!saveGolden(path, current)) {
+            fprintf(stderr, "Cannot write %s\n", path);
+            return 1;
+        }
+        printf("Wrote %zu golden frames to %s\n", current.size(), path);
+        return 0;
+    }
+
+    GoldenSet golden;
+    if (!loadGolden(path, golden)) {
+        fprintf(stderr, "Cannot read %s (run with --update to create it)\n", path);
+        return 1;
+    }
+
+    // Per effect: exact / within tolerance / failed, with the worst channel delta
+    int failures = 0;
+    printf("%-3s %-20s %-8s %s\n", "ID", "Effect", "Result", "Max delta (frame)");
+    for (uint8_t id = 0; id < LEDController::getNumEffects(); id++) {
+        if (onlyEffect >= 0 && id != onlyEffect) continue;
+
+        int maxDelta = 0;
+        uint16_t worstFrame = 0;
+        bool missing = false;
+        for (uint16_t frame : checkpoints) {
+            uint32_t key = ((uint32_t)id << 16) | frame;
+            auto g = golden.find(key);
+            const GoldenFrame& c = current[key];
+            if (g == golden.end() || g->second.rgb.size() != c.rgb.size()) {
+                missing = true;
+                continue;
+            }
+            if (g->second.hash == c.hash) continue;
+
+            for (size_t i = 0; i < c.rgb.size(); i++) {
+                int d = abs((int)c.rgb[i] - (int)g->second.rgb[i]);
+                if (d > maxDelta) {
+                    maxDelta = d;
+                    worstFrame = frame;
+                }
+            }
+        }
+
+        const char* result = "exact";
+        if (missing) result = "MISSING";
+        else if (maxDelta > tolerance) result = "FAIL";
+        else if (maxDelta > 0) result = "within";
+        if (missing || maxDelta > tolerance) failures++;
+
+        printf("%-3u %-20s %-8s %d (%u)\n", id, LEDController::getEffect(id).name, result, maxDelta, worstFrame);
+    }
+
+    printf("\n%d effect(s) failed (tolerance %d)\n", failures, tolerance);
+    return failures == 0 ? 0 : 1;
+}
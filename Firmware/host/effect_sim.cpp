@@ -0,0 +1,284 @@
+/*
+ * effect_sim.cpp - Headless effect simulator
+ *
+ * Runs one effect through LEDController's render loop with a param set in the
+ * same JSON format as POST /api/led/params and writes the leds[] timeline to a
+ * file: one image row per frame (PPM or PNG strip), or a raw RGB frame dump.
+ * Prints the achieved host frame rate so effect cost can be judged next to
+ * the LED_TARGET_FPS budget.
+ *
+ * Usage: effect_sim --effect <id|name> [--params JSON|@file] [--frames N]
+ *                   [--every K] [--scale S] [--seed N] [--leds N]
+ *                   [--out file.ppm|.png|.raw]
+ *        effect_sim --list
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "LEDController.h"
+
+// ============================================================================
+// Image Writers
+// ============================================================================
+
+struct Timeline {
+    uint32_t width;             // LEDs
+    uint32_t height;            // Recorded frames
+    std::vector<uint8_t> rgb;   // height rows of width RGB triplets
+};
+
+static bool writePpm(const char* path, const Timeline& t, uint8_t scale) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%u %u\n255\n", t.width * scale, t.height * scale);
+    std::vector<uint8_t> row(t.width * scale * 3);
+    for (uint32_t y = 0; y < t.height; y++) {
+        for (uint32_t x = 0; x < t.width * scale; x++) {
+            memcpy(&row[x * 3], &t.rgb[(y * t.width + x / scale) * 3], 3);
+        }
+        for (uint8_t s = 0; s < scale; s++) fwrite(row.data(), 1, row.size(), f);
+    }
+    fclose(f);
+    return true;
+}
+
+static uint32_t pngCrc(const uint8_t* data, size_t len, uint32_t crc = 0xFFFFFFFF) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+    for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v >> 24); out.push_back(v >> 16); out.push_back(v >> 8); out.push_back(v);
+}
+
+static void writePngChunk(FILE* f, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> chunk;
+    putBE32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    uint32_t crc = pngCrc(chunk.data() + 4, chunk.size() - 4) ^ 0xFFFFFFFF;
+    putBE32(chunk, crc);
+    fwrite(chunk.data(), 1, chunk.size(), f);
+}
+
+// Uncompressed (stored deflate blocks) PNG - no zlib dependency
+static bool writePng(const char* path, const Timeline& t, uint8_t scale) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    const uint32_t w = t.width * scale;
+    const uint32_t h = t.height * scale;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, w);
+    putBE32(ihdr, h);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});   // 8-bit RGB, no interlace
+    writePngChunk(f, "IHDR", ihdr);
+
+    // Scanlines with filter type 0
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)h * (w * 3 + 1));
+    for (uint32_t y = 0; y < h; y++) {
+        raw.push_back(0);
+        for (uint32_t x = 0; x < w; x++) {
+            const uint8_t* px = &t.rgb[((y / scale) * t.width + x / scale) * 3];
+            raw.insert(raw.end(), px, px + 3);
+        }
+    }
+
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (size_t pos = 0; pos < raw.size() || pos == 0; ) {
+        size_t len = std::min((size_t)65535, raw.size() - pos);
+        bool last = pos + len >= raw.size();
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(len & 0xFF); idat.push_back(len >> 8);
+        idat.push_back(~len & 0xFF); idat.push_back((~len >> 8) & 0xFF);
+        for (size_t i = 0; i < len; i++) {
+            uint8_t v = raw[pos + i];
+            idat.push_back(v);
+            a = (a + v) % 65521;
+            b = (b + a) % 65521;
+        }
+        pos += len;
+        if (last) break;
+    }
+    putBE32(idat, (b << 16) | a);
+    writePngChunk(f, "IDAT", idat);
+    writePngChunk(f, "IEND", {});
+
+    fclose(f);
+    return true;
+}
+
+static bool endsWith(const char* s, const char* suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcasecmp(s + n - m, suffix) == 0;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static int findEffect(const char* arg) {
+    char* end;
+    long id = strtol(arg, &end, 10);
+    if (*end == '\0') return (id >= 0 && id < LEDController::getNumEffects()) ? (int)id : -1;
+
+    for (uint8_t i = 0; i < LEDController::getNumEffects(); i++) {
+        if (strcasecmp(LEDController::getEffect(i).name, arg) == 0) return i;
+    }
+    return -1;
+}
+
+static bool readParams(const char* arg, std::string& out) {
+    if (arg[0] != '@') {
+        out = arg;
+        return true;
+    }
+    FILE* f = fopen(arg + 1, "r");
+    if (!f) return false;
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s --effect <id|name> [--params JSON|@file] [--frames N] [--every K]\n"
+                    "       %*s [--scale S] [--seed N] [--leds N] [--out file.ppm|.png|.raw]\n"
+                    "       %s --list\n", prog, (int)strlen(prog), "", prog);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const char* effectArg = NULL;
+    const char* paramsArg = NULL;
+    const char* outPath = NULL;
+    uint32_t frames = LED_TARGET_FPS * 10;
+    uint32_t every = 1;
+    uint8_t scale = 1;
+    uint16_t seed = 1337;
+    uint32_t numLeds = ARGB_NUM_LEDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--list")) {
+            for (uint8_t id = 0; id < LEDController::getNumEffects(); id++) {
+                printf("%2u  %s\n", id, LEDController::getEffect(id).name);
+            }
+            return 0;
+        }
+        else if (!strcmp(argv[i], "--effect") && i + 1 < argc) effectArg = argv[++i];
+        else if (!strcmp(argv[i], "--params") && i + 1 < argc) paramsArg = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--every") && i + 1 < argc) every = max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--scale") && i + 1 < argc) scale = (uint8_t)std::clamp(atoi(argv[++i]), 1, 16);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--leds") && i + 1 < argc) numLeds = strtoul(argv[++i], NULL, 10);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    int effectId = effectArg ? findEffect(effectArg) : -1;
+    if (effectId < 0) {
+        if (effectArg) fprintf(stderr, "Unknown effect: %s (see --list)\n", effectArg);
+        else usage(argv[0]);
+        return 2;
+    }
+
+    if (!LEDController::isValidLedCount(numLeds)) {
+        fprintf(stderr, "--leds must be 1-%u\n", LED_MAX_LEDS);
+        return 2;
+    }
+    LEDController::begin(numLeds);
+
+    random16_set_seed(seed);
+    HostClock::setMicros(0);
+    LEDController::setEffect(effectId);
+
+    // Same path as POST /api/led/params
+    if (paramsArg) {
+        std::string json;
+        StaticJsonDocument<1024> doc;
+        if (!readParams(paramsArg, json) || deserializeJson(doc, json.c_str()) || !doc.is<JsonObject>()) {
+            fprintf(stderr, "Invalid params: %s\n", paramsArg);
+            return 2;
+        }
+        for (JsonPair kv : doc.as<JsonObject>()) {
+            LEDController::setParam(kv.key().c_str(), kv.value());
+        }
+    }
+
+    Timeline timeline;
+    timeline.width = NUM_LEDS;
+    timeline.height = 0;
+    timeline.rgb.reserve((size_t)(frames / every + 1) * NUM_LEDS * 3);
+
+    const uint32_t frameMicros = LED_FRAME_MICROS;
+    double totalNs = 0;
+    double peakNs = 0;
+
+    for (uint32_t f = 0; f < frames; f++) {
+        auto start = std::chrono::steady_clock::now();
+        LEDController::renderFrame();
+        auto end = std::chrono::steady_clock::now();
+        HostClock::advanceMicros(frameMicros);
+
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        totalNs += ns;
+        peakNs = max(peakNs, ns);
+
+        if (f % every == 0) {
+            const uint8_t* raw = (const uint8_t*)leds;
+            timeline.rgb.insert(timeline.rgb.end(), raw, raw + NUM_LEDS * 3);
+            timeline.height++;
+        }
+    }
+
+    if (outPath) {
+        bool ok;
+        if (endsWith(outPath, ".png")) ok = writePng(outPath, timeline, scale);
+        else if (endsWith(outPath, ".ppm")) ok = writePpm(outPath, timeline, scale);
+        else {
+            FILE* f = fopen(outPath, "wb");
+            ok = f && fwrite(timeline.rgb.data(), 1, timeline.rgb.size(), f) == timeline.rgb.size();
+            if (f) fclose(f);
+        }
+        if (!ok) {
+            fprintf(stderr, "Cannot write %s\n", outPath);
+            return 1;
+        }
+    }
+
+    double avgNs = totalNs / max(frames, (uint32_t)1);
+    printf("Effect:       %u %s\n", effectId, LEDController::getEffect(effectId).name);
+    printf("LEDs:         %u\n", (unsigned)NUM_LEDS);
+    printf("Frames:       %u (%.2f s simulated, %u recorded)\n",
+           frames, (double)frames / LED_TARGET_FPS, timeline.height);
+    printf("Frame time:   avg %.1f us, peak %.1f us\n", avgNs / 1000.0, peakNs / 1000.0);
+    printf("Achieved FPS: %.0f (target %u)\n", avgNs > 0 ? 1e9 / avgNs : 0.0, LED_TARGET_FPS);
+    if (outPath) {
+        printf("Output:       %s (%u x %u%s)\n", outPath, timeline.width * scale, timeline.height * scale,
+               (endsWith(outPath, ".png") || endsWith(outPath, ".ppm")) ? "" : " raw RGB, 1 row per frame");
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * effect_timebase.cpp - Frame-rate independence check
+ *
+ * Renders deterministic effects for the same stretch of virtual time at
+ * 30, 60, 125 and 250 FPS and checks that the final frame matches the one
+ * rendered at the nominal frame period. Each run happens in a fresh forked
+ * process, since begin() registers the strip with FastLED once per process.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include "LEDController.h"
+
+#define TIMEBASE_SPAN_MICROS  1920000UL   // Multiple of every frame period below
+
+static const uint32_t framePeriods[] = {32000, LED_FRAME_MICROS, 8000, 4000};
+
+// Phase-accumulator and fixed-interval effects whose output depends only on time
+static const char* const effectNames[] = {
+    "Rainbow Wave", "Wavy", "Theater Chase", "Running Lights",
+    "Android", "Aurora", "Pacifica", "Lake", "Plasma", "Breathe", "Fade",
+};
+
+static uint64_t renderHash(uint8_t id, uint32_t frameMicros) {
+    int fds[2];
+    if (pipe(fds) != 0) return 0;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        random16_set_seed(1337);
+        HostClock::setMicros(0);
+        LEDController::begin();
+        LEDController::setEffect(id);
+        clearLeds();
+        LEDController::EffectInstance effect;
+        LEDController::startEffect(effect, id);
+
+        for (uint32_t t = 0; t <= TIMEBASE_SPAN_MICROS; t += frameMicros) {
+            LEDController::renderEffect(effect);
+            HostClock::advanceMicros(frameMicros);
+        }
+
+        uint64_t h = 0xcbf29ce484222325ULL;
+        const uint8_t* raw = (const uint8_t*)leds;
+        for (size_t i = 0; i < sizeof(CRGB) * ARGB_NUM_LEDS; i++) {
+            h = (h ^ raw[i]) * 0x100000001b3ULL;
+        }
+        ssize_t written = write(fds[1], &h, sizeof(h));
+        _exit(written == sizeof(h) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    uint64_t h = 0;
+    if (read(fds[0], &h, sizeof(h)) != sizeof(h)) h = 0;
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return h;
+}
+
+int main() {
+    int failures = 0;
+
+    for (const char* name : effectNames) {
+        int id = -1;
+        for (uint8_t i = 0; i < LEDController::getNumEffects(); i++) {
+            if (!strcmp(LEDController::getEffect(i).name, name)) id = i;
+        }
+        if (id < 0) {
+            printf("%-16s not found\n", name);
+            failures++;
+            continue;
+        }
+
+        uint64_t reference = renderHash(id, LED_FRAME_MICROS);
+        printf("%-16s", name);
+        for (uint32_t period : framePeriods) {
+            bool match = renderHash(id, period) == reference;
+            printf("  %3lu fps %s", 1000000UL / period, match ? "ok  " : "DIFF");
+            if (!match) failures++;
+        }
+        printf("\n");
+    }
+
+    printf("%d mismatch(es)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/*
+ * led_commands.cpp - Control message check
+ *
+ * A message may combine effect, params, brightness and power: params must
+ * land on the effect it switches to, the reported values must be what the
+ * controller holds (clamped), and an invalid message must change nothing.
+ * Persistence follows the REST routes: effect and params are staged for NVS,
+ * brightness only with "save", and power off writes what is staged.
+ */
+
+#include "LEDCommands.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static StaticJsonDocument<WS_MAX_MESSAGE> applied;
+static StaticJsonDocument<256> rejected;
+static const char* error;
+
+static bool apply(const char* json) {
+    StaticJsonDocument<WS_MAX_MESSAGE> msg;
+    deserializeJson(msg, json);
+    applied.clear();
+    rejected.clear();
+    error = NULL;
+    return LEDCommands::apply(msg.as<JsonObject>(), applied.to<JsonObject>(), rejected.to<JsonArray>(), &error);
+}
+
+static NVSManager::LedState stored() {
+    NVSManager::LedState state;
+    NVSManager::loadLedState(state);
+    return state;
+}
+
+int main() {
+    const uint8_t solid = 0;
+    const uint8_t heartbeat = 36;
+
+    HostClock::setMicros(0);
+    NVSManager::begin();
+    LEDController::begin();
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+
+    // Effect switch with its params in one message
+    CHECK(apply("{\"effect\":36,\"duration\":0,\"params\":{\"bpm\":20,\"fadeOut\":3},\"brightness\":90}"),
+          "combined message refused: %s", error);
+    CHECK(LEDController::getCurrentEffect() == heartbeat, "effect not switched");
+    CHECK(applied["effect"].as<int>() == heartbeat, "effect not reported");
+    CHECK(applied["params"]["bpm"].as<int>() == 40, "bpm reported as %d, not clamped to 40",
+          applied["params"]["bpm"].as<int>());
+    CHECK(rejected.size() == 1 && strcmp(rejected[0].as<const char*>(), "fadeOut") == 0, "unknown key not rejected");
+    CHECK(applied["brightness"].as<int>() == 90 && LEDController::getBrightness() == 90, "brightness not applied");
+    LEDController::renderFrame();
+    CHECK(heartbeatParams.bpm == 40, "param did not reach the new effect");
+
+    // Persistence: effect and params staged, brightness only with "save"
+    CHECK(NVSManager::hasPendingWrites(), "effect/params not staged for NVS");
+    NVSManager::flush();
+    NVSManager::LedState state = stored();
+    CHECK(state.effect == heartbeat && state.paramsEffect == heartbeat, "effect %u / params of %u stored", state.effect,
+          state.paramsEffect);
+    CHECK(state.brightness == 0xFF, "brightness stored without save");
+    CHECK(apply("{\"brightness\":60,\"save\":true}"), "brightness refused: %s", error);
+    NVSManager::flush();
+    CHECK(stored().brightness == 60, "saved brightness not stored");
+
+    // Invalid messages apply nothing
+    const char* invalid[] = {
+        "{}",
+        "{\"effect\":200}",
+        "{\"effect\":\"2\"}",
+        "{\"effect\":2,\"transition\":\"slide\"}",
+        "{\"effect\":2,\"duration\":999999}",
+        "{\"effect\":2,\"params\":[1]}",
+        "{\"effect\":2,\"brightness\":300}",
+        "{\"effect\":2,\"power\":1}",
+    };
+    for (const char* json : invalid) {
+        CHECK(!apply(json) && error != NULL, "accepted %s", json);
+    }
+    CHECK(LEDController::getCurrentEffect() == heartbeat && LEDController::getBrightness() == 60,
+          "invalid message changed state");
+
+    // Power off writes what is staged
+    CHECK(apply("{\"params\":{\"bpm\":90}}"), "params refused: %s", error);
+    CHECK(NVSManager::hasPendingWrites(), "params not staged");
+    CHECK(apply("{\"power\":false}") && !applied["power"].as<bool>(), "power off refused: %s", error);
+    CHECK(!LEDController::isPoweredOn(), "power not switched");
+    CHECK(!NVSManager::hasPendingWrites(), "power off did not write the staged state");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * led_fps.cpp - Frame-rate governor check
+ *
+ * The governor runs at the fastest rate the drawn effects declare, backs off
+ * when the measured frame cost would eat more than LED_FPS_LOAD_PCT of the
+ * period, and only goes below an effect's minimum when even the full period
+ * is not enough. Transmission time is simulated through the shim's onShow.
+ */
+
+#include "LEDController.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static uint32_t showCostMicros = 0;
+
+static void slowShow() {
+    HostClock::advanceMicros(showCostMicros);
+}
+
+// Run at the governor's own pace, as ledTask does
+static void runFrames(uint16_t n) {
+    for (uint16_t f = 0; f < n; f++) {
+        LEDController::renderFrame();
+        HostClock::advanceMicros(LEDController::getFramePeriodMicros());
+    }
+}
+
+static uint8_t settle(uint8_t effect) {
+    LEDController::setEffect(effect, LEDController::TRANSITION_FADE, 0);
+    runFrames(60);
+    return LEDController::getTargetFps();
+}
+
+int main() {
+    const uint8_t rainbowWave = 4;
+    const uint8_t scanner = 9;
+    const uint8_t lake = 24;
+    const uint8_t strobe = 41;
+
+    HostClock::setMicros(0);
+    LEDController::begin();
+    FastLED.onShow = slowShow;
+
+    // Declared ranges with free frames
+    CHECK(settle(lake) == 30, "Lake: %u fps", LEDController::getTargetFps());
+    CHECK(settle(rainbowWave) == LED_TARGET_FPS, "Rainbow Wave: %u fps", LEDController::getTargetFps());
+    CHECK(settle(strobe) == LED_MAX_FPS, "Strobe: %u fps", LEDController::getTargetFps());
+
+    // A fast layer over a slow base lifts the whole frame
+    const char* error = NULL;
+    LEDController::Layer fastLayer[] = {{scanner, LEDController::BLEND_ADD, 255}};
+    LEDController::setLayers(fastLayer, 1, &error);
+    CHECK(settle(lake) == LED_MAX_FPS, "Lake + Scanner layer: %u fps", LEDController::getTargetFps());
+    LEDController::clearLayers();
+
+    // Achieved rate follows the target
+    settle(rainbowWave);
+    runFrames(3 * LED_TARGET_FPS);
+    StaticJsonDocument<512> doc;
+    LEDController::getStatusJson(doc);
+    int fps = doc["fps"].as<int>();
+    CHECK(abs(fps - doc["fpsTarget"].as<int>()) <= 1, "achieved %d fps, target %d", fps, doc["fpsTarget"].as<int>());
+
+    // 12 ms shows: 75% load allows 62 fps, still above Strobe's minimum
+    showCostMicros = 12000;
+    uint8_t loaded = settle(strobe);
+    CHECK(loaded >= 60 && loaded <= 63, "Strobe with 12 ms shows: %u fps", loaded);
+
+    // 20 ms shows: 75% load would be 37 fps, so the whole period is spent
+    showCostMicros = 20000;
+    CHECK(settle(strobe) == 50, "Strobe with 20 ms shows: %u fps", LEDController::getTargetFps());
+    CHECK(settle(lake) == 30, "Lake with 20 ms shows: %u fps", LEDController::getTargetFps());
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * led_handoff.cpp - API-to-frame handoff check
+ *
+ * Params, brightness, power and effect switches made through the API must
+ * not reach the effects or the strip until the next frame boundary, must all
+ * land in that same frame, and the time from the call to the end of the show
+ * that carries it is reported. Transmission time is simulated through the
+ * shim's onShow.
+ */
+
+#include "LEDController.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+#define SHOW_MICROS     1000
+
+static void slowShow() {
+    HostClock::advanceMicros(SHOW_MICROS);
+}
+
+static uint32_t statusValue(const char* key) {
+    StaticJsonDocument<512> doc;
+    LEDController::getStatusJson(doc);
+    return doc[key].as<uint32_t>();
+}
+
+static void setColor(const char* json) {
+    StaticJsonDocument<64> doc;
+    deserializeJson(doc, json);
+    LEDController::setParam("color", doc.as<JsonVariant>());
+}
+
+int main() {
+    const uint8_t solid = 0;
+    const uint8_t strobe = 41;
+
+    HostClock::setMicros(0);
+    LEDController::begin();
+    FastLED.onShow = slowShow;
+    const CRGB* out = FastLED[0].leds;
+
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+    LEDController::renderFrame();
+    CHECK(out[0] == CRGB::White, "Solid not drawn");
+
+    // Staged until the frame boundary: neither the effect nor the strip sees it
+    setColor("\"#FF0000\"");
+    LEDController::setBrightness(50);
+    CHECK(solidParams.color == CRGB::White, "param reached the effect before the frame boundary");
+    CHECK(FastLED.getBrightness() != 50, "brightness reached the strip before the frame boundary");
+    StaticJsonDocument<256> params;
+    LEDController::getParamsJson(params);
+    CHECK(strcmp(params["params"]["color"].as<const char*>(), "#FF0000") == 0, "API does not read back the staged value");
+
+    // Both land in the next frame; latency runs from the first call to the
+    // end of that frame's show
+    HostClock::advanceMicros(3000);
+    LEDController::renderFrame();
+    CHECK(out[0] == CRGB::Red, "param change not rendered");
+    CHECK(FastLED.getBrightness() == 50, "brightness not applied with the frame");
+    CHECK(statusValue("changeLatencyUs") == 3000 + SHOW_MICROS, "latency %u us, expected %u",
+          statusValue("changeLatencyUs"), 3000 + SHOW_MICROS);
+
+    // An effect switch and its params arrive together
+    LEDController::setEffect(strobe, LEDController::TRANSITION_FADE, 0);
+    LEDController::setParam("color", params["params"]["color"]);  // Applies to the requested effect
+    HostClock::advanceMicros(2000);
+    LEDController::renderFrame();
+    CHECK(strobeParams.color == CRGB::Red, "Strobe param not taken with the switch");
+
+    // Power off: the blank frame carries the change
+    LEDController::setPower(false);
+    HostClock::advanceMicros(500);
+    FastLED.resetShowCount();
+    LEDController::renderFrame();
+    CHECK(FastLED.getShowCount() == 1 && !out[0], "power off not shown");
+    CHECK(statusValue("changeLatencyUs") == 500 + SHOW_MICROS, "power-off latency %u us",
+          statusValue("changeLatencyUs"));
+
+    // Changes made while off are never shown, so they are not measured
+    setColor("\"#0000FF\"");
+    HostClock::advanceMicros(100000);
+    LEDController::renderFrame();
+    LEDController::setPower(true);
+    HostClock::advanceMicros(200);
+    LEDController::renderFrame();
+    CHECK(statusValue("changeLatencyUs") == 200 + SHOW_MICROS, "power-on latency %u us",
+          statusValue("changeLatencyUs"));
+    CHECK(statusValue("changeLatencyMaxUs") == 3000 + SHOW_MICROS, "max latency %u us",
+          statusValue("changeLatencyMaxUs"));
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
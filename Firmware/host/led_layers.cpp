@@ -0,0 +1,133 @@
+/*
+ * led_layers.cpp - Layer compositor check
+ *
+ * A layer must draw exactly what its effect draws on the whole strip, merged
+ * onto the base by its blend mode and opacity. Gradient (static) is the base
+ * and Rainbow Wave the layer; every scenario runs in a forked process because
+ * begin() registers the strip with FastLED once per process.
+ */
+
+#include <functional>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "LEDController.h"
+
+#define LAYER_LEDS      75
+#define LAYER_FRAMES    120
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+typedef LEDController::Layer Layer;
+
+// Output pixels after LAYER_FRAMES frames of `setup`, rendered in a child
+static std::vector<CRGB> render(const std::function<void()>& setup) {
+    std::vector<CRGB> out(LAYER_LEDS);
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        random16_set_seed(1337);
+        HostClock::setMicros(0);
+        LEDController::begin(LAYER_LEDS);
+        setup();
+        for (uint16_t f = 0; f < LAYER_FRAMES; f++) {
+            LEDController::renderFrame();
+            HostClock::advanceMicros(LED_FRAME_MICROS);
+        }
+        ssize_t len = sizeof(CRGB) * LAYER_LEDS;
+        _exit(write(fds[1], FastLED[0].leds, len) == len ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t len = sizeof(CRGB) * LAYER_LEDS;
+    if (read(fds[0], out.data(), len) != len) out.assign(LAYER_LEDS, CRGB(1, 2, 3));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return out;
+}
+
+static std::vector<CRGB> renderLayered(uint8_t base, const Layer* stack, uint8_t n) {
+    return render([=]() {
+        const char* error = NULL;
+        LEDController::setEffect(base);
+        if (!LEDController::setLayers(stack, n, &error)) printf("setLayers: %s\n", error);
+    });
+}
+
+int main() {
+    const uint8_t gradient = 1;
+    const uint8_t rainbowWave = 4;
+
+    std::vector<CRGB> base = render([=]() { LEDController::setEffect(gradient); });
+    std::vector<CRGB> top = render([=]() { LEDController::setEffect(rainbowWave); });
+
+    // Per-mode results at full opacity
+    Layer add[] = {{rainbowWave, LEDController::BLEND_ADD, 255}};
+    Layer screen[] = {{rainbowWave, LEDController::BLEND_SCREEN, 255}};
+    Layer alpha[] = {{rainbowWave, LEDController::BLEND_ALPHA, 255}};
+    Layer maxed[] = {{rainbowWave, LEDController::BLEND_MAX, 255}};
+    std::vector<CRGB> outAdd = renderLayered(gradient, add, 1);
+    std::vector<CRGB> outScreen = renderLayered(gradient, screen, 1);
+    std::vector<CRGB> outAlpha = renderLayered(gradient, alpha, 1);
+    std::vector<CRGB> outMax = renderLayered(gradient, maxed, 1);
+
+    uint16_t diffAdd = 0, diffScreen = 0, diffAlpha = 0, diffMax = 0;
+    for (uint16_t i = 0; i < LAYER_LEDS; i++) {
+        const CRGB& b = base[i];
+        const CRGB& t = top[i];
+        diffAdd += outAdd[i] != CRGB(qadd8(b.r, t.r), qadd8(b.g, t.g), qadd8(b.b, t.b));
+        diffMax += outMax[i] != CRGB(max(b.r, t.r), max(b.g, t.g), max(b.b, t.b));
+        // Rainbow pixels are fully saturated: one channel at 255 means full coverage
+        if (max(t.r, max(t.g, t.b)) == 255) diffAlpha += outAlpha[i] != t;
+        // Screen never darkens either input and never exceeds add
+        for (uint8_t c = 0; c < 3; c++) {
+            uint8_t s = outScreen[i].raw[c];
+            if (s < max(b.raw[c], t.raw[c]) || s > outAdd[i].raw[c]) {
+                diffScreen++;
+                break;
+            }
+        }
+    }
+    CHECK(diffAdd == 0, "add: %u pixels differ from the saturating sum", diffAdd);
+    CHECK(diffScreen == 0, "screen: %u pixels outside [max, add]", diffScreen);
+    CHECK(diffAlpha == 0, "alpha: %u fully covered pixels differ from the layer", diffAlpha);
+    CHECK(diffMax == 0, "max: %u pixels differ from the per-channel maximum", diffMax);
+
+    // Zero opacity leaves the base untouched
+    Layer clear[] = {{rainbowWave, LEDController::BLEND_SCREEN, 0}};
+    CHECK(renderLayered(gradient, clear, 1) == base, "opacity 0 changed the base");
+
+    // A layer running the base effect has its own instance, started with the base
+    Layer shared[] = {{rainbowWave, LEDController::BLEND_ADD, 255}};
+    std::vector<CRGB> outShared = renderLayered(rainbowWave, shared, 1);
+    uint16_t diffShared = 0;
+    for (uint16_t i = 0; i < LAYER_LEDS; i++) {
+        const CRGB& t = top[i];
+        diffShared += outShared[i] != CRGB(qadd8(t.r, t.r), qadd8(t.g, t.g), qadd8(t.b, t.b));
+    }
+    CHECK(diffShared == 0, "layer sharing the base effect: %u pixels differ from the effect added to itself",
+          diffShared);
+
+    // Validation
+    const char* error = NULL;
+    Layer sameEffect[] = {{rainbowWave, LEDController::BLEND_ADD, 255}, {rainbowWave, LEDController::BLEND_MAX, 255}};
+    Layer badMode[] = {{rainbowWave, LEDController::NUM_BLEND_MODES, 255}};
+    Layer badEffect[] = {{200, LEDController::BLEND_ADD, 255}};
+    Layer tooMany[LED_MAX_LAYERS + 1];
+    for (uint8_t i = 0; i <= LED_MAX_LAYERS; i++) tooMany[i] = {i, LEDController::BLEND_ADD, 255};
+    CHECK(LEDController::setLayers(sameEffect, 2, &error), "effect in two layers rejected: %s", error);
+    CHECK(!LEDController::setLayers(badMode, 1, &error), "invalid blend mode accepted");
+    CHECK(!LEDController::setLayers(badEffect, 1, &error), "invalid effect accepted");
+    CHECK(!LEDController::setLayers(tooMany, LED_MAX_LAYERS + 1, &error), "more than LED_MAX_LAYERS accepted");
+    CHECK(LEDController::parseBlendMode("screen") == LEDController::BLEND_SCREEN, "blend mode name not parsed");
+    CHECK(LEDController::parseBlendMode("multiply") == LEDController::NUM_BLEND_MODES, "unknown blend mode parsed");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
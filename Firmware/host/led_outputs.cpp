@@ -0,0 +1,86 @@
+/*
+ * led_outputs.cpp - Pixel-to-channel mapping for parallel LED outputs
+ *
+ * Checks how planOutputs() splits the logical strip across data pins, which
+ * pin sets begin() accepts, and that after a rendered frame every FastLED
+ * controller holds exactly its run of leds[].
+ */
+
+#include "LEDController.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static void checkPlan(uint16_t numLeds, uint8_t numPins, const uint16_t* expectedCounts) {
+    static const uint8_t pins[LED_MAX_OUTPUTS] = {1, 2, 43, 44};
+    LEDController::LedOutput out[LED_MAX_OUTPUTS];
+    uint8_t n = LEDController::planOutputs(numLeds, pins, numPins, out);
+
+    CHECK(n == numPins, "%u LEDs / %u pins: %u outputs", numLeds, numPins, n);
+    uint16_t start = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        CHECK(out[i].pin == pins[i], "%u LEDs output %u: pin %u", numLeds, i, out[i].pin);
+        CHECK(out[i].start == start, "%u LEDs output %u: start %u, expected %u", numLeds, i, out[i].start, start);
+        CHECK(out[i].count == expectedCounts[i], "%u LEDs output %u: count %u, expected %u",
+              numLeds, i, out[i].count, expectedCounts[i]);
+        start += out[i].count;
+    }
+    CHECK(start == numLeds, "%u LEDs / %u pins: runs cover %u LEDs", numLeds, numPins, start);
+}
+
+int main() {
+    // Even and uneven splits; the remainder goes to the first runs
+    const uint16_t single[] = {75};
+    const uint16_t even[] = {500, 500, 500, 500};
+    const uint16_t uneven[] = {334, 334, 333};
+    const uint16_t tiny[] = {2, 1, 1, 1};
+    checkPlan(75, 1, single);
+    checkPlan(2000, 4, even);
+    checkPlan(1001, 3, uneven);
+    checkPlan(5, 4, tiny);
+
+    // Pin set validation
+    const uint8_t ok[] = {1, 2, 43, 44};
+    const uint8_t duplicate[] = {1, 2, 1};
+    const uint8_t reserved[] = {1, RESET_BUTTON_PIN};
+    const uint8_t tooMany[] = {1, 2, 3, 4, 5};
+    CHECK(LEDController::isValidPinSet(ok, 4, 2000), "4 distinct pins rejected");
+    CHECK(!LEDController::isValidPinSet(duplicate, 3, 2000), "duplicate pin accepted");
+    CHECK(!LEDController::isValidPinSet(reserved, 2, 2000), "reset button pin accepted");
+    CHECK(!LEDController::isValidPinSet(tooMany, 5, 2000), "more than LED_MAX_OUTPUTS pins accepted");
+    CHECK(!LEDController::isValidPinSet(ok, 4, 3), "more pins than LEDs accepted");
+    CHECK(!LEDController::isValidPinSet(ok, 0, 75), "empty pin set accepted");
+
+    // Registered controllers and the pixels they receive
+    LEDController::begin(2000, ok, 4);
+    CHECK(LEDController::getNumOutputs() == 4, "begin() set up %u outputs", LEDController::getNumOutputs());
+    CHECK(FastLED.count() == 4, "%zu FastLED controllers", FastLED.count());
+
+    // Rainbow Wave (every pixel differs from its neighbours), cut in so the
+    // front buffer holds leds[] unmixed
+    LEDController::setEffect(4, LEDController::TRANSITION_FADE, 0);
+    for (uint8_t f = 0; f < 3; f++) {
+        LEDController::renderFrame();
+        HostClock::advanceMicros(LED_FRAME_MICROS);
+    }
+
+    for (uint8_t c = 0; c < FastLED.count() && c < LEDController::getNumOutputs(); c++) {
+        const LEDController::LedOutput& o = LEDController::getOutput(c);
+        CLEDController& ctl = FastLED[c];
+        CHECK(ctl.pin == o.pin, "controller %u on GPIO%u, expected GPIO%u", c, ctl.pin, o.pin);
+        CHECK(ctl.numLeds == o.count, "controller %u drives %d LEDs, expected %u", c, ctl.numLeds, o.count);
+        CHECK(ctl.leds == FastLED[0].leds + o.start, "controller %u does not start at pixel %u", c, o.start);
+
+        uint16_t mismatches = 0;
+        for (uint16_t j = 0; j < ctl.numLeds; j++) {
+            if (ctl.leds[j] != leds[o.start + j]) mismatches++;
+        }
+        CHECK(mismatches == 0, "controller %u: %u pixels differ from leds[%u..]", c, mismatches, o.start);
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/*
+ * led_params.cpp - Parameter registry check
+ *
+ * Every descriptor must point at a default inside its range, report what was
+ * set, clamp what is out of range and reject the wrong JSON type; keys only
+ * reach the effect that owns them. Values are staged and reach the effects'
+ * structs only on commit. getParamsJson output fed back through setParam must
+ * change nothing.
+ */
+
+#include "LEDController.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static JsonVariant paramsOf(JsonDocument& doc, uint8_t effect) {
+    doc.clear();
+    LEDController::getParamsJson(doc, effect);
+    return doc["params"];
+}
+
+static bool setFromJson(const char* key, const char* json, uint8_t effect) {
+    StaticJsonDocument<64> doc;
+    deserializeJson(doc, json);
+    return LEDController::setParam(key, doc.as<JsonVariant>(), effect);
+}
+
+int main() {
+    const uint8_t scanner = 9;
+    const uint8_t halloweenEyes = 27;
+    const uint8_t heartbeat = 36;
+
+    // Table layout: a params block per effect, rows grouped by effect, every
+    // row found through the hash
+    CHECK(NUM_PARAM_BLOCKS == LEDController::getNumEffects(), "%u param blocks for %u effects",
+          (unsigned)NUM_PARAM_BLOCKS, LEDController::getNumEffects());
+    for (uint8_t i = 1; i < NUM_PARAMS; i++) {
+        CHECK(paramTable[i].effect >= paramTable[i - 1].effect, "row %u (%s) out of effect order", i,
+              paramTable[i].key);
+    }
+    for (uint8_t i = 0; i < NUM_PARAMS; i++) {
+        const ParamDesc& p = paramTable[i];
+        CHECK(findParam(p.key, p.effect) == &p, "%s on effect %u not found", p.key, p.effect);
+        CHECK(p.offset + paramTypeSize(p.type) <= effectParamBlocks[p.effect].size, "%s on effect %u outside its struct",
+              p.key, p.effect);
+        if (p.type != PARAM_COLOR) {
+            int v = readParam(p);
+            CHECK(v >= p.min && v <= p.max, "%s on effect %u: default %d outside %u..%u", p.key, p.effect, v, p.min,
+                  p.max);
+        }
+    }
+
+    // Every non-color param: the middle of the range reads back, past the
+    // end clamps to it
+    StaticJsonDocument<2048> doc;
+    for (uint8_t i = 0; i < NUM_PARAMS; i++) {
+        const ParamDesc& p = paramTable[i];
+        if (p.type == PARAM_COLOR || p.type == PARAM_BOOL) continue;
+        char json[8];
+        int mid = (p.min + p.max) / 2;
+        snprintf(json, sizeof(json), "%d", mid);
+        CHECK(setFromJson(p.key, json, p.effect), "%s on effect %u rejected %d", p.key, p.effect, mid);
+        CHECK(paramsOf(doc, p.effect)[p.key].as<int>() == mid, "%s on effect %u: set %d, read %d", p.key, p.effect,
+              mid, doc["params"][p.key].as<int>());
+        if (p.max < 255) {
+            snprintf(json, sizeof(json), "%d", p.max + 1);
+            setFromJson(p.key, json, p.effect);
+            CHECK(readParam(p) == p.max, "%s on effect %u: %d not clamped to %u", p.key, p.effect, p.max + 1, p.max);
+        }
+    }
+
+    // Colors, booleans and scaled fields; the effects' structs only change
+    // when the staged values are committed
+    commitStagedParams();
+    CHECK(setFromJson("color3", "\"#102030\"", scanner), "Scanner color3 rejected");
+    CHECK(setFromJson("dualMode", "true", scanner), "Scanner dualMode rejected");
+    CHECK(setFromJson("duration", "100", halloweenEyes), "Halloween Eyes duration rejected");
+    CHECK(setFromJson("bpm", "20", heartbeat), "bpm rejected");
+    CHECK(scannerParams.colors[2] != CRGB(0x10, 0x20, 0x30), "live params written before the commit");
+    CHECK(commitStagedParams(), "nothing staged");
+    CHECK(scannerParams.colors[2] == CRGB(0x10, 0x20, 0x30), "Scanner color3 not stored");
+    CHECK(scannerParams.dualMode, "Scanner dualMode not stored");
+    CHECK(halloweenEyesParams.duration == 1000, "Halloween Eyes duration stored as %u", halloweenEyesParams.duration);
+    CHECK(heartbeatParams.bpm == 40, "bpm not clamped: %u", heartbeatParams.bpm);
+
+    // "color" on Scanner is color1, and is not reported twice
+    CHECK(setFromJson("color", "\"#00FF00\"", scanner), "Scanner color alias rejected");
+    CHECK(strcmp(paramsOf(doc, scanner)["color1"].as<const char*>(), "#00FF00") == 0, "Scanner color alias not applied to color1");
+    CHECK(!doc["params"]["color"].is<const char*>(), "alias reported");
+
+    CHECK(setFromJson("numDots", "-3", scanner) && readParam(*findParam("numDots", scanner)) == 1,
+          "negative numDots not clamped");
+
+    // Rejections: wrong JSON type, unknown key, key of another effect
+    int numDots = readParam(*findParam("numDots", scanner));
+    CHECK(!setFromJson("numDots", "\"4\"", scanner), "string accepted for a number");
+    CHECK(!setFromJson("dualMode", "1", scanner), "number accepted for a bool");
+    CHECK(!setFromJson("color1", "42", scanner), "number accepted for a color");
+    CHECK(!setFromJson("fadeOut", "10", scanner), "unknown key accepted");
+    CHECK(!setFromJson("numBalls", "4", scanner), "another effect's key accepted");
+    CHECK(!setFromJson("speed", "10", 200), "invalid effect accepted");
+    CHECK(readParam(*findParam("numDots", scanner)) == numDots, "rejected value changed numDots");
+
+    // Round trip: what getParamsJson reports sets the same values back
+    for (uint8_t effect = 0; effect < LEDController::getNumEffects(); effect++) {
+        StaticJsonDocument<2048> before;
+        LEDController::getParamsJson(before, effect);
+        for (JsonPair kv : before["params"].as<JsonObject>()) {
+            CHECK(LEDController::setParam(kv.key().c_str(), kv.value(), effect), "%s on effect %u: own value rejected",
+                  kv.key().c_str(), effect);
+        }
+        String a, b;
+        serializeJson(before["params"], a);
+        serializeJson(paramsOf(doc, effect), b);
+        CHECK(a == b, "effect %u changed on round trip: %s -> %s", effect, a.c_str(), b.c_str());
+    }
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/*
+ * led_scene.cpp - Atomic scene update check
+ *
+ * Changes staged between beginUpdate() and endUpdate() must not reach a
+ * frame before endUpdate(), then all reach the same one. A scene (effect,
+ * params, brightness, power) must land in one frame and one flash write,
+ * with brightness kept unless "save": false, and a refused scene must leave
+ * the frame boundary open.
+ */
+
+#include "LEDCommands.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static StaticJsonDocument<WS_MAX_MESSAGE> applied;
+static StaticJsonDocument<256> rejected;
+static const char* error;
+
+static bool scene(const char* json) {
+    StaticJsonDocument<WS_MAX_MESSAGE> msg;
+    deserializeJson(msg, json);
+    applied.clear();
+    rejected.clear();
+    error = NULL;
+    return LEDCommands::applyScene(msg.as<JsonObject>(), applied.to<JsonObject>(), rejected.to<JsonArray>(), &error);
+}
+
+static NVSManager::LedState stored() {
+    NVSManager::LedState state;
+    NVSManager::loadLedState(state);
+    return state;
+}
+
+int main() {
+    const uint8_t solid = 0;
+    const uint8_t heartbeat = 36;
+
+    HostClock::setMicros(0);
+    NVSManager::begin();
+    LEDController::begin();
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+    LEDController::renderFrame();
+    NVSManager::flush();
+
+    // Held back until the update ends, then taken together
+    LEDController::beginUpdate();
+    LEDController::setBrightness(40);
+    LEDController::renderFrame();
+    LEDController::setPower(false);
+    LEDController::renderFrame();
+    CHECK(FastLED.getBrightness() != 40 && FastLED[0].leds[0] != CRGB::Black, "part of an update reached the strip");
+    LEDController::setPower(true);
+    LEDController::endUpdate();
+    LEDController::renderFrame();
+    CHECK(FastLED.getBrightness() == 40, "update not applied after endUpdate()");
+
+    // A scene: one frame, one flash write, brightness kept
+    Preferences::resetWriteCount();
+    CHECK(scene("{\"effect\":36,\"duration\":0,\"params\":{\"bpm\":50},\"brightness\":80,\"power\":true}"),
+          "scene refused: %s", error);
+    CHECK(FastLED.getBrightness() == 40 && heartbeatParams.bpm != 50, "scene reached the strip before the frame");
+    LEDController::renderFrame();
+    CHECK(FastLED.getBrightness() == 80 && heartbeatParams.bpm == 50, "scene not applied in one frame");
+    CHECK(applied["effect"].as<int>() == heartbeat && applied["params"]["bpm"].as<int>() == 50, "scene not reported");
+    CHECK(Preferences::getWriteCount() == 1, "%u flash writes for one scene", Preferences::getWriteCount());
+    CHECK(!NVSManager::hasPendingWrites(), "scene left staged writes");
+    NVSManager::LedState state = stored();
+    CHECK(state.effect == heartbeat && state.brightness == 80 && state.paramsEffect == heartbeat,
+          "scene not stored: effect %u brightness %u", state.effect, state.brightness);
+
+    // Brightness left out of flash on request
+    CHECK(scene("{\"brightness\":20,\"save\":false}"), "scene refused: %s", error);
+    CHECK(stored().brightness == 80, "brightness stored despite save: false");
+
+    // A refused scene changes nothing and leaves frames flowing
+    Preferences::resetWriteCount();
+    CHECK(!scene("{\"effect\":2,\"brightness\":300}") && error != NULL, "invalid scene accepted");
+    CHECK(Preferences::getWriteCount() == 0, "refused scene wrote to flash");
+    LEDController::setBrightness(120);
+    LEDController::renderFrame();
+    CHECK(FastLED.getBrightness() == 120 && LEDController::getCurrentEffect() == heartbeat,
+          "frame boundary blocked after a refused scene");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
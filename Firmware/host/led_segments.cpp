@@ -0,0 +1,136 @@
+/*
+ * led_segments.cpp - Segment engine check
+ *
+ * An effect running in a segment must draw exactly what it draws on a strip
+ * of the segment's length, only inside its slice; reverse and mirror are
+ * applied on the way to the output buffer. One effect may run in several
+ * segments, each with its own instance. begin() registers the strip with
+ * FastLED once per process, so reference renders run in forked processes.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include "LEDController.h"
+
+#define SEGMENT_FRAMES  120
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static void startController(uint16_t numLeds) {
+    random16_set_seed(1337);
+    HostClock::setMicros(0);
+    LEDController::begin(numLeds);
+}
+
+static void runFrames() {
+    for (uint16_t f = 0; f < SEGMENT_FRAMES; f++) {
+        LEDController::renderFrame();
+        HostClock::advanceMicros(LED_FRAME_MICROS);
+    }
+}
+
+// Output pixels of effect `id` on a strip of `numLeds`, rendered in a child
+static std::vector<CRGB> referenceRender(uint8_t id, uint16_t numLeds) {
+    std::vector<CRGB> out(numLeds);
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        startController(numLeds);
+        LEDController::setEffect(id);
+        runFrames();
+        ssize_t len = sizeof(CRGB) * numLeds;
+        _exit(write(fds[1], FastLED[0].leds, len) == len ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t len = sizeof(CRGB) * numLeds;
+    if (read(fds[0], out.data(), len) != len) out.assign(numLeds, CRGB(1, 2, 3));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return out;
+}
+
+int main() {
+    const uint8_t rainbowWave = 4;
+    const uint8_t wavy = 7;
+    const uint8_t plasma = 33;
+
+    std::vector<CRGB> refRainbow = referenceRender(rainbowWave, 40);
+    std::vector<CRGB> refRainbowShort = referenceRender(rainbowWave, 20);
+    std::vector<CRGB> refWavy = referenceRender(wavy, 20);
+    std::vector<CRGB> refPlasma = referenceRender(plasma, 8);  // Mirror: first half of 15
+
+    startController(75);
+
+    // Validation
+    const char* error = NULL;
+    LEDController::Segment overlap[] = {{0, 20, 0, false, false}, {10, 20, 1, false, false}};
+    LEDController::Segment outside[] = {{70, 10, 0, false, false}};
+    LEDController::Segment badEffect[] = {{0, 10, 200, false, false}};
+    CHECK(!LEDController::setSegments(overlap, 2, &error), "overlapping segments accepted");
+    CHECK(!LEDController::setSegments(outside, 1, &error), "segment past the strip accepted");
+    CHECK(!LEDController::setSegments(badEffect, 1, &error), "invalid effect accepted");
+
+    LEDController::Segment table[] = {
+        {0, 40, rainbowWave, false, false},   // Plain
+        {40, 20, wavy, true, false},          // Reversed
+        {60, 15, plasma, false, true},        // Mirrored
+    };
+    LEDController::Segment withGap[] = {          // Gaps at 40-44 and 65-74
+        {0, 40, rainbowWave, false, false},
+        {45, 20, wavy, true, false},
+    };
+
+    CHECK(LEDController::setSegments(table, 3, &error), "valid table rejected: %s", error);
+    LEDController::setEffect(0);
+    runFrames();
+
+    const CRGB* out = FastLED[0].leds;
+    uint16_t diff = 0;
+    for (uint16_t i = 0; i < 40; i++) diff += out[i] != refRainbow[i];
+    CHECK(diff == 0, "plain segment: %u pixels differ from a 40-LED strip", diff);
+
+    diff = 0;
+    for (uint16_t i = 0; i < 20; i++) diff += out[40 + i] != refWavy[19 - i];
+    CHECK(diff == 0, "reversed segment: %u pixels differ from a reversed 20-LED strip", diff);
+
+    diff = 0;
+    for (uint16_t i = 0; i < 8; i++) {
+        diff += out[60 + i] != refPlasma[i];
+        diff += out[60 + 14 - i] != refPlasma[i];
+    }
+    CHECK(diff == 0, "mirrored segment: %u pixels differ from a mirrored 8-LED strip", diff);
+
+    // Pixels outside every segment stay dark
+    CHECK(LEDController::setSegments(withGap, 2, &error), "table with gap rejected: %s", error);
+    runFrames();
+    uint16_t lit = 0;
+    for (uint16_t i = 40; i < 45; i++) lit += (bool)out[i];
+    for (uint16_t i = 65; i < 75; i++) lit += (bool)out[i];
+    CHECK(lit == 0, "%u pixels lit outside the segments", lit);
+
+    // One effect in two segments: each slice runs its own instance
+    LEDController::Segment sameEffect[] = {{0, 40, rainbowWave, false, false}, {40, 20, rainbowWave, false, false}};
+    CHECK(LEDController::setSegments(sameEffect, 2, &error), "effect in two segments rejected: %s", error);
+    runFrames();
+    diff = 0;
+    for (uint16_t i = 0; i < 40; i++) diff += out[i] != refRainbow[i];
+    for (uint16_t i = 0; i < 20; i++) diff += out[40 + i] != refRainbowShort[i];
+    CHECK(diff == 0, "shared effect: %u pixels differ from 40- and 20-LED strips", diff);
+    
+    // Back to whole-strip mode
+    LEDController::clearSegments();
+    runFrames();
+    CHECK(LEDController::getNumSegments() == 0, "segments not cleared");
+    CHECK(out[70], "whole-strip effect not drawn after clearing segments");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
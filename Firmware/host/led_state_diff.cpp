@@ -0,0 +1,98 @@
+/*
+ * led_state_diff.cpp - State event coalescing check
+ *
+ * A slider streaming brightness every 10 ms must produce at most one diff
+ * per SSE_MIN_INTERVAL_MS, the last one carrying the final value, with each
+ * diff's base the revision of the one before. Diffs hold only what changed
+ * (an effect switch: all params of the new effect), and a change undone
+ * within the interval produces none.
+ */
+
+#include "LEDStateDiff.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static LEDStateDiff tracker;
+static StaticJsonDocument<SSE_MAX_EVENT> diff;
+
+static bool take() {
+    diff.clear();
+    return tracker.takeDiff(diff.to<JsonObject>());
+}
+
+static void setParam(const char* key, const char* json) {
+    StaticJsonDocument<64> doc;
+    deserializeJson(doc, json);
+    LEDController::setParam(key, doc.as<JsonVariant>());
+}
+
+int main() {
+    const uint8_t solid = 0;
+    const uint8_t gradient = 1;
+
+    HostClock::setMicros(0);
+    LEDController::begin();
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+    LEDController::renderFrame();
+    tracker.begin();
+    CHECK(!take(), "diff without a change");
+
+    // Full state for a joining client
+    StaticJsonDocument<SSE_MAX_EVENT> state;
+    LEDStateDiff::writeState(state.to<JsonObject>());
+    CHECK(state["rev"].as<uint32_t>() == LEDController::getStateRevision(), "state without the current revision");
+    CHECK(state["effect"].as<int>() == solid && strcmp(state["params"]["color"].as<const char*>(), "#FFFFFF") == 0,
+          "state without effect and params");
+
+    // A 1 s slider drag: a handful of diffs, chained by revision
+    const uint32_t dragMs = 1000;
+    uint32_t diffs = 0;
+    uint32_t lastRev = tracker.getRevision();
+    int lastBrightness = -1;
+    bool chained = true;
+    for (uint32_t t = 0; t < dragMs + SSE_MIN_INTERVAL_MS; t += 10) {
+        if (t < dragMs) LEDController::setBrightness(t / 10);
+        if (take()) {
+            diffs++;
+            chained &= diff["base"].as<uint32_t>() == lastRev;
+            lastRev = diff["rev"].as<uint32_t>();
+            lastBrightness = diff["brightness"].as<int>();
+            CHECK(diff.size() == 3, "brightness diff with other fields");
+        }
+        delay(10);
+    }
+    CHECK(diffs <= dragMs / SSE_MIN_INTERVAL_MS + 1, "%u diffs in a %u ms drag", diffs, dragMs);
+    CHECK(chained, "diff base is not the previous revision");
+    CHECK(lastBrightness == (int)(dragMs / 10 - 1), "last diff brightness %d", lastBrightness);
+    CHECK(lastRev == LEDController::getStateRevision(), "final revision not reported");
+
+    // Only the param that changed
+    delay(SSE_MIN_INTERVAL_MS);
+    setParam("color", "\"#FF0000\"");
+    CHECK(take(), "param change not reported");
+    CHECK(diff["params"].size() == 1 && strcmp(diff["params"]["color"].as<const char*>(), "#FF0000") == 0,
+          "param diff not just the color");
+    CHECK(!diff.containsKey("brightness") && !diff.containsKey("effect"), "unchanged fields in the diff");
+
+    // Changed and changed back within the interval: nothing to report
+    delay(SSE_MIN_INTERVAL_MS);
+    LEDController::setPower(false);
+    LEDController::setPower(true);
+    CHECK(!take(), "undone change reported");
+
+    // An effect switch brings all params of the new effect
+    delay(SSE_MIN_INTERVAL_MS);
+    LEDController::setEffect(gradient, LEDController::TRANSITION_FADE, 0);
+    CHECK(take(), "effect switch not reported");
+    StaticJsonDocument<SSE_MAX_EVENT> params;
+    LEDController::getParamsJson(params, gradient);
+    CHECK(diff["effect"].as<int>() == gradient && diff["params"].size() == params["params"].size(),
+          "effect diff with %u of %u params", (unsigned)diff["params"].size(), (unsigned)params["params"].size());
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
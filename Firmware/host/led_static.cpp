@@ -0,0 +1,88 @@
+/*
+ * led_static.cpp - Effect scheduling check
+ *
+ * A static effect is rendered and sent once, then only on param, brightness
+ * or power changes and on the periodic refresh. Animated effects and
+ * transitions keep every frame; an effect that holds its frame (Fire Flicker)
+ * is shown only when its wake time comes and never stalls the render loop.
+ * Counts FastLED.show() calls on the shim.
+ */
+
+#include "LEDController.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+// FastLED.show() calls over `n` frames
+static uint32_t showsOver(uint16_t n) {
+    FastLED.resetShowCount();
+    for (uint16_t f = 0; f < n; f++) {
+        LEDController::renderFrame();
+        HostClock::advanceMicros(LED_FRAME_MICROS);
+    }
+    return FastLED.getShowCount();
+}
+
+static uint32_t framesSkipped() {
+    StaticJsonDocument<512> doc;
+    LEDController::getStatusJson(doc);
+    return doc["framesSkipped"].as<uint32_t>();
+}
+
+int main() {
+    const uint16_t second = 1000000UL / LED_FRAME_MICROS;
+    const uint8_t solid = 0;
+    const uint8_t rainbowWave = 4;
+    const uint8_t fireFlicker = 20;
+
+    HostClock::setMicros(0);
+    LEDController::begin();
+    const CRGB* out = FastLED[0].leds;
+
+    // Cut to Solid: one frame, then nothing but the refresh
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+    CHECK(showsOver(1) == 1, "first static frame not shown");
+    CHECK(out[0] == CRGB::White, "static frame not drawn");
+
+    uint32_t skippedBefore = framesSkipped();
+    uint32_t shows = showsOver(5 * second);
+    uint32_t refreshes = 5000 / LED_STATIC_REFRESH_MS;
+    CHECK(shows >= refreshes - 1 && shows <= refreshes + 1, "%u shows in 5 s of a static scene", shows);
+    CHECK(framesSkipped() - skippedBefore == 5 * second - shows, "framesSkipped off: %u skipped, %u shown",
+          framesSkipped() - skippedBefore, shows);
+
+    // A param change is shown on the next frame
+    LEDController::loadParamsFromJson("{\"color\":\"#FF0000\"}");
+    CHECK(showsOver(1) == 1, "param change not shown");
+    CHECK(out[0] == CRGB::Red, "param change not rendered");
+
+    LEDController::setBrightness(50);
+    CHECK(showsOver(1) == 1, "brightness change not shown");
+
+    // A transition out of the static scene runs every frame
+    LEDController::setEffect(rainbowWave);
+    CHECK(showsOver(10) == 10, "transition frames skipped");
+
+    // Animated effects are never skipped
+    CHECK(showsOver(2 * second) == 2 * second, "animated frames skipped");
+    
+    // Fire Flicker holds each frame without blocking: renderFrame takes no
+    // time and shows come at the hold rate
+    LEDController::setEffect(fireFlicker, LEDController::TRANSITION_FADE, 0);
+    uint32_t start = micros();
+    LEDController::renderFrame();
+    CHECK(micros() == start, "renderFrame blocked for %u us", micros() - start);
+    HostClock::advanceMicros(LED_FRAME_MICROS);
+    
+    uint32_t holdMs = map(fireFlickerParams.speed, 0, 255, 100, 20);
+    uint32_t frameMs = LED_FRAME_MICROS / 1000;
+    shows = showsOver(second);
+    CHECK(shows >= 1000 / (holdMs + frameMs) && shows <= 1000 / holdMs + 1, "%u shows in 1 s of a %u ms flicker",
+          shows, holdMs);
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
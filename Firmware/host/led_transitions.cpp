@@ -0,0 +1,117 @@
+/*
+ * led_transitions.cpp - Effect switch transition check
+ *
+ * Switches from Rainbow Wave to Wavy (both depend only on time) halfway
+ * through a run and checks the front buffer mid-window against the two
+ * effects rendered on their own: the outgoing one must keep animating, the
+ * incoming one must start from its t=0 state. begin() registers the strip
+ * with FastLED once per process, so every run happens in a forked process.
+ */
+
+#include <functional>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "LEDController.h"
+
+#define TRANSITION_LEDS     75
+#define LEAD_FRAMES         60      // Outgoing effect alone before the switch
+#define MID_FRAMES          32      // Into a 1 s window: progress 126/255
+#define END_FRAMES          70      // Past the window
+#define WINDOW_MS           1000
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static const uint8_t outgoing = 4;   // Rainbow Wave
+static const uint8_t incoming = 7;   // Wavy
+
+static void runFrames(uint16_t n) {
+    for (uint16_t f = 0; f < n; f++) {
+        LEDController::renderFrame();
+        HostClock::advanceMicros(LED_FRAME_MICROS);
+    }
+}
+
+// Front buffer after LEAD_FRAMES of the outgoing effect, `switchTo`, then
+// `frames` more frames; rendered in a child
+static std::vector<CRGB> render(const std::function<void()>& switchTo, uint16_t frames) {
+    std::vector<CRGB> out(TRANSITION_LEDS);
+    int fds[2];
+    if (pipe(fds) != 0) return out;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        random16_set_seed(1337);
+        HostClock::setMicros(0);
+        LEDController::begin(TRANSITION_LEDS);
+        LEDController::setEffect(outgoing, LEDController::TRANSITION_FADE, 0);
+        runFrames(LEAD_FRAMES);
+        switchTo();
+        runFrames(frames);
+        ssize_t len = sizeof(CRGB) * TRANSITION_LEDS;
+        _exit(write(fds[1], FastLED[0].leds, len) == len ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t len = sizeof(CRGB) * TRANSITION_LEDS;
+    if (read(fds[0], out.data(), len) != len) out.assign(TRANSITION_LEDS, CRGB(1, 2, 3));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    return out;
+}
+
+static std::vector<CRGB> renderSwitch(uint8_t type, uint16_t frames) {
+    return render([=]() { LEDController::setEffect(incoming, type, WINDOW_MS); }, frames);
+}
+
+int main() {
+    // Progress after MID_FRAMES: the first frame of the window has no delta
+    const uint8_t progress = (uint64_t)(MID_FRAMES - 1) * LED_FRAME_MICROS * 255 / (WINDOW_MS * 1000UL);
+
+    std::vector<CRGB> refOut = render([]() {}, MID_FRAMES);
+    std::vector<CRGB> refIn = render([]() { LEDController::setEffect(incoming, LEDController::TRANSITION_FADE, 0); },
+                                     MID_FRAMES);
+    std::vector<CRGB> refInEnd = render([]() { LEDController::setEffect(incoming, LEDController::TRANSITION_FADE, 0); },
+                                        END_FRAMES);
+
+    // Crossfade: both effects blended by progress
+    std::vector<CRGB> fade = renderSwitch(LEDController::TRANSITION_FADE, MID_FRAMES);
+    uint16_t diff = 0;
+    for (uint16_t i = 0; i < TRANSITION_LEDS; i++) diff += fade[i] != blend(refOut[i], refIn[i], progress);
+    CHECK(diff == 0, "crossfade: %u pixels differ from the blend at %u/255", diff, progress);
+
+    // Wipe: incoming below the edge, outgoing above it
+    std::vector<CRGB> wipe = renderSwitch(LEDController::TRANSITION_WIPE, MID_FRAMES);
+    uint16_t edge = (uint32_t)TRANSITION_LEDS * progress / 255;
+    diff = 0;
+    for (uint16_t i = 0; i < TRANSITION_LEDS; i++) diff += wipe[i] != (i < edge ? refIn[i] : refOut[i]);
+    CHECK(diff == 0, "wipe: %u pixels differ around edge %u", diff, edge);
+
+    // Dissolve: every pixel is one of the two, about half switched over
+    std::vector<CRGB> dissolve = renderSwitch(LEDController::TRANSITION_DISSOLVE, MID_FRAMES);
+    uint16_t switched = 0;
+    diff = 0;
+    for (uint16_t i = 0; i < TRANSITION_LEDS; i++) {
+        if (dissolve[i] == refIn[i]) switched++;
+        else if (dissolve[i] != refOut[i]) diff++;
+    }
+    CHECK(diff == 0, "dissolve: %u pixels belong to neither effect", diff);
+    CHECK(switched > TRANSITION_LEDS / 4 && switched < TRANSITION_LEDS * 3 / 4,
+          "dissolve: %u of %u pixels switched at %u/255", switched, TRANSITION_LEDS, progress);
+
+    // After the window only the incoming effect is left, for every type
+    for (uint8_t type = 0; type < LEDController::NUM_TRANSITIONS; type++) {
+        CHECK(renderSwitch(type, END_FRAMES) == refInEnd, "%s: output differs after the window",
+              LEDController::transitionName(type));
+    }
+
+    CHECK(LEDController::parseTransition("wipe") == LEDController::TRANSITION_WIPE, "transition name not parsed");
+    CHECK(LEDController::parseTransition("slide") == LEDController::NUM_TRANSITIONS, "unknown transition parsed");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
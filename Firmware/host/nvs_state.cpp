@@ -0,0 +1,120 @@
+/*
+ * nvs_state.cpp - Binary LED state check
+ *
+ * Effect, brightness and params written by older firmware (separate keys,
+ * params as JSON) must come back at boot and be rewritten as one blob, with
+ * the old keys gone. The blob must restore the params struct byte for byte,
+ * be smaller than the JSON it replaces, and be refused when its CRC, length
+ * or the params layout does not match.
+ */
+
+#include "LEDController.h"
+#include "NVSManager.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+static const uint8_t scanner = 9;
+
+// Second handle on the same flash, for planting and inspecting keys
+static Preferences flash;
+
+static bool setFromJson(const char* key, const char* json) {
+    StaticJsonDocument<64> doc;
+    deserializeJson(doc, json);
+    return LEDController::setParam(key, doc.as<JsonVariant>(), scanner);
+}
+
+static void saveScannerParams() {
+    uint8_t params[NVS_PARAMS_MAX_BYTES];
+    uint32_t layout;
+    uint8_t len = LEDController::copyParams(scanner, params, layout);
+    NVSManager::saveParams(scanner, params, len, layout);
+}
+
+// Boot sequence of Firmware.ino setup()
+static bool restore(NVSManager::LedState& saved) {
+    bool hasStateBlob = NVSManager::loadLedState(saved);
+    if (saved.effect != 0xFF) LEDController::setEffect(saved.effect);
+    if (hasStateBlob) {
+        if (saved.paramsLen > 0) {
+            LEDController::restoreParams(saved.paramsEffect, saved.params, saved.paramsLen, saved.paramsLayout);
+        }
+    } else {
+        LEDController::loadParamsFromJson(NVSManager::loadLegacyParams());
+    }
+    if (!hasStateBlob && NVSManager::hasLegacyState()) {
+        NVSManager::saveEffect(saved.effect);
+        saveScannerParams();
+        NVSManager::flush();
+    }
+    return hasStateBlob;
+}
+
+int main() {
+    HostClock::setMicros(0);
+    LEDController::begin();
+    flash.begin(NVS_NAMESPACE);
+
+    // Older firmware's keys
+    const char* legacyJson = "{\"numDots\":4,\"color1\":\"#102030\",\"dualMode\":true}";
+    flash.putUChar(NVS_KEY_LED_EFFECT, scanner);
+    flash.putUChar(NVS_KEY_LED_BRIGHTNESS, 77);
+    flash.putString(NVS_KEY_LED_PARAMS, legacyJson);
+    NVSManager::begin();
+
+    // First boot: restored from the JSON, then migrated
+    NVSManager::LedState saved;
+    CHECK(!restore(saved), "blob found before migration");
+    CHECK(saved.effect == scanner && saved.brightness == 77, "legacy effect %u / brightness %u", saved.effect,
+          saved.brightness);
+    CHECK(readParam(*findParam("numDots", scanner)) == 4, "legacy numDots not applied");
+    CHECK(!flash.isKey(NVS_KEY_LED_EFFECT) && !flash.isKey(NVS_KEY_LED_BRIGHTNESS) && !flash.isKey(NVS_KEY_LED_PARAMS),
+          "legacy keys left after migration");
+    CHECK(flash.isKey(NVS_KEY_LED_STATE), "no blob after migration");
+
+    // The blob is a fraction of the JSON the full params took
+    StaticJsonDocument<1024> paramsDoc;
+    LEDController::getParamsJson(paramsDoc, scanner);
+    String paramsJson;
+    serializeJson(paramsDoc["params"], paramsJson);
+    size_t blobLen = flash.getBytesLength(NVS_KEY_LED_STATE);
+    CHECK(blobLen * 2 < paramsJson.length(), "blob %zu bytes, params JSON %u", blobLen, paramsJson.length());
+
+    // Next boot: the struct comes back byte for byte
+    uint8_t expected[NVS_PARAMS_MAX_BYTES];
+    uint32_t layout;
+    uint8_t len = LEDController::copyParams(scanner, expected, layout);
+    CHECK(setFromJson("numDots", "2") && setFromJson("color1", "\"#FFFFFF\""), "params not changed");
+    CHECK(restore(saved), "blob not accepted");
+    CHECK(saved.effect == scanner && saved.brightness == 77, "blob effect %u / brightness %u", saved.effect,
+          saved.brightness);
+    uint8_t restored[NVS_PARAMS_MAX_BYTES];
+    LEDController::copyParams(scanner, restored, layout);
+    CHECK(memcmp(restored, expected, len) == 0, "params differ after restore");
+    CHECK(commitStagedParams() && scannerParams.numDots == 4 && scannerParams.dualMode,
+          "restored params not taken by the effect");
+
+    // Params of another layout or size are refused
+    CHECK(!LEDController::restoreParams(scanner, saved.params, saved.paramsLen, saved.paramsLayout + 1),
+          "params of another layout accepted");
+    CHECK(!LEDController::restoreParams(scanner, saved.params, saved.paramsLen - 1, saved.paramsLayout),
+          "params of another size accepted");
+    CHECK(paramLayout(scanner) != paramLayout(scanner + 1), "layouts of two effects collide");
+
+    // A damaged blob is refused, not applied
+    uint8_t blob[sizeof(NVSManager::LedState) + 4];
+    flash.getBytes(NVS_KEY_LED_STATE, blob, blobLen);
+    blob[offsetof(NVSManager::LedState, params)] ^= 0x01;
+    flash.putBytes(NVS_KEY_LED_STATE, blob, blobLen);
+    CHECK(!NVSManager::loadLedState(saved), "corrupt blob accepted");
+    CHECK(saved.effect == 0xFF && saved.paramsLen == 0, "corrupt blob not reset to empty");
+    flash.putBytes(NVS_KEY_LED_STATE, blob, 6);
+    CHECK(!NVSManager::loadLedState(saved), "truncated blob accepted");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
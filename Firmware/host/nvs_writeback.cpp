@@ -0,0 +1,92 @@
+/*
+ * nvs_writeback.cpp - Write-behind LED state check
+ *
+ * A slider streaming changes every 50 ms must end up as one flash write once
+ * it stops, a stream that never stops must still be written every
+ * NVS_FLUSH_MAX_MS, and flush() must write everything staged at once. What
+ * lands in flash is the last value staged; the counters report the writes
+ * made and the saves absorbed. Flash is the shim's in-memory Preferences.
+ */
+
+#include "NVSManager.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+#define SLIDER_MS   50
+
+// One loop() pass every 10 ms for `ms`
+static void runLoop(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        NVSManager::service();
+        delay(10);
+    }
+}
+
+static NVSManager::LedState stored() {
+    NVSManager::LedState state;
+    NVSManager::loadLedState(state);
+    return state;
+}
+
+int main() {
+    HostClock::setMicros(0);
+    NVSManager::begin();
+    Preferences::resetWriteCount();
+
+    // A 1 s drag: 20 saves, nothing written while it lasts, one write after
+    for (int i = 0; i < 20; i++) {
+        NVSManager::saveBrightness(100 + i);
+        runLoop(SLIDER_MS);
+    }
+    CHECK(Preferences::getWriteCount() == 0, "%u flash writes during the drag", Preferences::getWriteCount());
+    CHECK(NVSManager::hasPendingWrites(), "drag not staged");
+    runLoop(NVS_FLUSH_IDLE_MS);
+    CHECK(Preferences::getWriteCount() == 1, "%u flash writes after the drag", Preferences::getWriteCount());
+    CHECK(stored().brightness == 119, "stored brightness %u", stored().brightness);
+    CHECK(NVSManager::getWritesIssued() == 1 && NVSManager::getWritesCoalesced() == 19,
+          "counters: %u issued, %u coalesced", NVSManager::getWritesIssued(), NVSManager::getWritesCoalesced());
+    CHECK(!NVSManager::hasPendingWrites(), "still pending after the write");
+
+    // A drag that never settles is still written every NVS_FLUSH_MAX_MS
+    Preferences::resetWriteCount();
+    const uint32_t dragMs = NVS_FLUSH_MAX_MS * 5 / 2;
+    for (uint32_t t = 0; t < dragMs; t += SLIDER_MS) {
+        NVSManager::saveBrightness(t / SLIDER_MS);
+        runLoop(SLIDER_MS);
+    }
+    CHECK(Preferences::getWriteCount() == 2, "%u flash writes in a %u ms drag", Preferences::getWriteCount(), dragMs);
+
+    // Power off/restart: everything staged goes out at once (effect,
+    // brightness and params share one blob), a cleared segment table
+    // removes the key
+    NVSManager::saveSegments("[{\"start\":0}]");
+    NVSManager::flush();
+    Preferences::resetWriteCount();
+    const uint8_t params[] = {1, 2, 3};
+    NVSManager::saveEffect(7);
+    NVSManager::saveBrightness(90);
+    NVSManager::saveSegments("");
+    NVSManager::saveParams(7, params, sizeof(params), 0x1234);
+    NVSManager::flush();
+    CHECK(Preferences::getWriteCount() == 2, "%u flash writes on flush", Preferences::getWriteCount());
+    NVSManager::LedState state = stored();
+    CHECK(state.effect == 7 && state.brightness == 90, "effect/brightness not written");
+    CHECK(state.paramsEffect == 7 && state.paramsLen == sizeof(params) && memcmp(state.params, params, sizeof(params)) == 0,
+          "params not written");
+    CHECK(NVSManager::loadSegments().isEmpty(), "segments not removed");
+    NVSManager::flush();
+    CHECK(Preferences::getWriteCount() == 2, "clean flush wrote to flash");
+
+    // A factory reset drops what is staged
+    NVSManager::saveEffect(3);
+    NVSManager::clearCredentials();
+    runLoop(NVS_FLUSH_IDLE_MS);
+    CHECK(stored().effect == 0xFF, "staged effect written after the reset");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ * realtime_udp.cpp - Realtime UDP input check
+ *
+ * DDP, E1.31 and Art-Net frames sent over loopback must land on the strip as
+ * sent, with the effect suspended, and the effect must take over again once
+ * no frame has come for LED_REALTIME_TIMEOUT_MS. Frames spanning several
+ * universes are shown when complete (or on ArtSync); sequence gaps, repeats
+ * and malformed packets are counted, not shown.
+ */
+
+#include "RealtimeReceiver.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+#define STRIP_LEDS  400     // Three universes: 170 + 170 + 60 pixels
+
+static int sender;
+
+static void send(uint16_t port, const uint8_t* data, size_t len) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sendto(sender, data, len, 0, (struct sockaddr*)&addr, sizeof(addr));
+}
+
+// Poll until `count` packets are read (loopback delivery is not instant)
+static uint16_t receive(uint16_t count) {
+    uint16_t read = 0;
+    for (int i = 0; i < 50 && read < count; i++) read += RealtimeReceiver::poll(20);
+    return read;
+}
+
+static void fillRgb(uint8_t* data, uint16_t pixels, CRGB color) {
+    for (uint16_t i = 0; i < pixels; i++) {
+        data[i * 3] = color.r;
+        data[i * 3 + 1] = color.g;
+        data[i * 3 + 2] = color.b;
+    }
+}
+
+static void sendDdp(uint8_t seq, uint32_t pixel, uint16_t pixels, CRGB color, bool push) {
+    uint8_t packet[DDP_HEADER_LEN + 480 * 3] = {0};
+    packet[0] = DDP_VERSION_1 | (push ? DDP_FLAG_PUSH : 0);
+    packet[1] = seq;
+    packet[2] = DDP_TYPE_RGB8;
+    packet[3] = DDP_ID_DISPLAY;
+    uint32_t offset = pixel * 3;
+    packet[4] = offset >> 24; packet[5] = offset >> 16; packet[6] = offset >> 8; packet[7] = offset;
+    packet[8] = (pixels * 3) >> 8; packet[9] = pixels * 3;
+    fillRgb(packet + DDP_HEADER_LEN, pixels, color);
+    send(REALTIME_DDP_PORT, packet, DDP_HEADER_LEN + pixels * 3);
+}
+
+static void sendE131(uint8_t seq, uint16_t universe, CRGB color) {
+    uint8_t packet[E131_DATA_OFFSET + REALTIME_UNIVERSE_CHANNELS] = {0};
+    const char id[] = "ASC-E1.17";
+    memcpy(packet + 4, id, sizeof(id));
+    packet[21] = E131_VECTOR_ROOT_DATA;
+    packet[43] = E131_VECTOR_FRAME_DATA;
+    packet[111] = seq;
+    packet[113] = universe >> 8; packet[114] = universe;
+    packet[117] = 0x02;
+    packet[118] = 0xA1;
+    uint16_t slots = REALTIME_UNIVERSE_CHANNELS + 1;
+    packet[123] = slots >> 8; packet[124] = slots;
+    fillRgb(packet + E131_DATA_OFFSET, REALTIME_UNIVERSE_CHANNELS / 3, color);
+    send(REALTIME_E131_PORT, packet, sizeof(packet));
+}
+
+static void sendArtDmx(uint8_t seq, uint16_t universe, CRGB color) {
+    uint8_t packet[ARTNET_HEADER_LEN + REALTIME_UNIVERSE_CHANNELS] = {0};
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = ARTNET_OP_DMX & 0xFF; packet[9] = ARTNET_OP_DMX >> 8;
+    packet[11] = 14;
+    packet[12] = seq;
+    packet[14] = universe; packet[15] = universe >> 8;
+    packet[16] = REALTIME_UNIVERSE_CHANNELS >> 8; packet[17] = REALTIME_UNIVERSE_CHANNELS & 0xFF;
+    fillRgb(packet + ARTNET_HEADER_LEN, REALTIME_UNIVERSE_CHANNELS / 3, color);
+    send(REALTIME_ARTNET_PORT, packet, sizeof(packet));
+}
+
+static void sendArtSync() {
+    uint8_t packet[14] = {0};
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = ARTNET_OP_SYNC & 0xFF; packet[9] = ARTNET_OP_SYNC >> 8;
+    packet[11] = 14;
+    send(REALTIME_ARTNET_PORT, packet, sizeof(packet));
+}
+
+int main() {
+    const uint8_t solid = 0;
+
+    HostClock::setMicros(0);
+    LEDController::begin(STRIP_LEDS);
+    LEDController::setEffect(solid, LEDController::TRANSITION_FADE, 0);
+    LEDController::renderFrame();
+    const CRGB* out = FastLED[0].leds;
+    CHECK(out[0] == CRGB::White, "Solid not drawn");
+
+    CHECK(RealtimeReceiver::begin(), "UDP ports not opened");
+    sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    // DDP: shown on push, the effect no longer draws
+    sendDdp(1, 0, 200, CRGB::Red, false);
+    CHECK(receive(1) == 1, "DDP packet not received");
+    CHECK(out[0] == CRGB::White, "frame shown before push");
+    sendDdp(2, 200, 200, CRGB::Blue, true);
+    receive(1);
+    CHECK(out[0] == CRGB::Red && out[STRIP_LEDS - 1] == CRGB::Blue, "DDP frame not shown as sent");
+    CHECK(LEDController::isRealtimeActive(), "realtime not active");
+    LEDController::renderFrame();
+    CHECK(out[0] == CRGB::Red, "effect drew over the realtime frame");
+
+    // Sequence gap counted; a repeat is dropped
+    sendDdp(5, 0, STRIP_LEDS, CRGB::Green, true);
+    sendDdp(5, 0, STRIP_LEDS, CRGB::Black, true);
+    receive(2);
+    CHECK(RealtimeReceiver::getPacketsLost() == 2, "%u packets lost, expected 2", RealtimeReceiver::getPacketsLost());
+    CHECK(out[0] == CRGB::Green, "repeated packet shown");
+    CHECK(RealtimeReceiver::getFrames() == 2, "%u DDP frames", RealtimeReceiver::getFrames());
+
+    // E1.31: shown once the universe with the last pixel arrives; other
+    // devices' universes ignored
+    sendE131(10, REALTIME_E131_UNIVERSE, CRGB::Blue);
+    sendE131(10, REALTIME_E131_UNIVERSE + 1, CRGB::Blue);
+    sendE131(10, REALTIME_E131_UNIVERSE + 7, CRGB::Red);
+    receive(3);
+    CHECK(out[0] == CRGB::Green, "partial E1.31 frame shown");
+    sendE131(10, REALTIME_E131_UNIVERSE + 2, CRGB::Blue);
+    receive(1);
+    CHECK(out[0] == CRGB::Blue && out[STRIP_LEDS - 1] == CRGB::Blue, "E1.31 frame not shown");
+    CHECK(RealtimeReceiver::getFramesIncomplete() == 0, "complete frame counted incomplete");
+
+    // The next frame starting over before the last universe: shown as is
+    sendE131(11, REALTIME_E131_UNIVERSE, CRGB::Red);
+    sendE131(12, REALTIME_E131_UNIVERSE, CRGB::Green);
+    receive(2);
+    CHECK(out[0] == CRGB::Red && out[STRIP_LEDS - 1] == CRGB::Blue, "incomplete frame not shown");
+    CHECK(RealtimeReceiver::getFramesIncomplete() == 1, "%u incomplete frames", RealtimeReceiver::getFramesIncomplete());
+
+    // Art-Net: shown on the last universe, then on ArtSync once sent
+    sendArtDmx(1, REALTIME_ARTNET_UNIVERSE, CRGB::Red);
+    sendArtDmx(1, REALTIME_ARTNET_UNIVERSE + 1, CRGB::Red);
+    sendArtDmx(1, REALTIME_ARTNET_UNIVERSE + 2, CRGB::Red);
+    receive(3);
+    CHECK(out[0] == CRGB::Red && out[STRIP_LEDS - 1] == CRGB::Red, "Art-Net frame not shown");
+    sendArtSync();
+    sendArtDmx(2, REALTIME_ARTNET_UNIVERSE, CRGB::Green);
+    sendArtDmx(2, REALTIME_ARTNET_UNIVERSE + 1, CRGB::Green);
+    sendArtDmx(2, REALTIME_ARTNET_UNIVERSE + 2, CRGB::Green);
+    receive(4);
+    CHECK(out[0] == CRGB::Red, "synced Art-Net frame shown before ArtSync");
+    sendArtSync();
+    receive(1);
+    CHECK(out[0] == CRGB::Green && out[STRIP_LEDS - 1] == CRGB::Green, "Art-Net frame not shown on ArtSync");
+
+    // Malformed packets are counted and change nothing
+    uint32_t invalid = RealtimeReceiver::getInvalidPackets();
+    const uint8_t shortDdp[] = {DDP_VERSION_1 | DDP_FLAG_PUSH, 0, 0, DDP_ID_DISPLAY};
+    const uint8_t notArtNet[ARTNET_HEADER_LEN] = {'A', 'r', 't'};
+    send(REALTIME_DDP_PORT, shortDdp, sizeof(shortDdp));
+    send(REALTIME_E131_PORT, notArtNet, sizeof(notArtNet));
+    send(REALTIME_ARTNET_PORT, notArtNet, sizeof(notArtNet));
+    receive(3);
+    CHECK(RealtimeReceiver::getInvalidPackets() == invalid + 3, "%u malformed packets counted",
+          RealtimeReceiver::getInvalidPackets() - invalid);
+    CHECK(out[0] == CRGB::Green, "malformed packet changed the strip");
+
+    // Quiet for the timeout: the effect takes over again
+    HostClock::advanceMillis(LED_REALTIME_TIMEOUT_MS - 10);
+    LEDController::renderFrame();
+    CHECK(LEDController::isRealtimeActive() && out[0] == CRGB::Green, "effect resumed before the timeout");
+    HostClock::advanceMillis(20);
+    LEDController::renderFrame();
+    CHECK(!LEDController::isRealtimeActive() && out[0] == CRGB::White, "effect not resumed after the timeout");
+
+    close(sender);
+    RealtimeReceiver::end();
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Run the frame-time benchmark at every chain length and merge the results.
+#
+#   ./run_bench.sh [build-dir] [csv|jsonl] [extra effect_bench args...]
+#
+# Output goes to stdout; redirect to a file to keep a baseline between commits.
+
+BUILD_DIR=${1:-build}
+FORMAT=${2:-csv}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+
+HEADER=""
+for leds in 75 300 1000 4000; do
+    "$BUILD_DIR/effect_bench_$leds" --format "$FORMAT" $HEADER "$@" || exit 1
+    HEADER="--no-header"
+done
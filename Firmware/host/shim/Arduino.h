@@ -0,0 +1,254 @@
+/*
+ * Arduino.h - Host shim of the Arduino-ESP32 core
+ *
+ * Provides just enough of the Arduino API (String, Serial, millis, map, ...)
+ * plus the FreeRTOS/ESP bits used by LEDController.h and NVSManager.h so the
+ * effect engine compiles and runs on a Linux dev box. Time is virtual: it only advances
+ * when a host tool calls HostClock::advanceMicros() (or delay()), which keeps
+ * renders deterministic and independent of the dev box load.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+using std::min;
+using std::max;
+using std::abs;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ============================================================================
+// Virtual Clock
+// ============================================================================
+
+class HostClock {
+public:
+    static uint64_t nowMicros() { return now; }
+    static void setMicros(uint64_t us) { now = us; }
+    static void advanceMicros(uint64_t us) { now += us; }
+    static void advanceMillis(uint32_t ms) { now += (uint64_t)ms * 1000; }
+
+private:
+    static inline uint64_t now = 0;
+};
+
+inline unsigned long millis() { return (unsigned long)(HostClock::nowMicros() / 1000); }
+inline unsigned long micros() { return (unsigned long)HostClock::nowMicros(); }
+inline void delay(uint32_t ms) { HostClock::advanceMillis(ms); }
+inline void delayMicroseconds(uint32_t us) { HostClock::advanceMicros(us); }
+inline void yield() {}
+
+// ============================================================================
+// Math Helpers (arduino-esp32 semantics)
+// ============================================================================
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if (run == 0) {
+        return -1;  // Same as arduino-esp32
+    }
+    const long rise = out_max - out_min;
+    const long delta = x - in_min;
+    return (delta * rise) / run + out_min;
+}
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+inline long random(long howbig) { return howbig > 0 ? ::rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline uint32_t esp_random() {
+    return ((uint32_t)::rand() << 16) ^ (uint32_t)::rand();
+}
+
+// ============================================================================
+// Heap capabilities (no PSRAM on the host)
+// ============================================================================
+
+#define MALLOC_CAP_8BIT         (1 << 2)
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_SPIRAM       (1 << 10)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+
+inline bool psramFound() { return false; }
+inline void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : calloc(n, size);
+}
+inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? NULL : malloc(size);
+}
+inline void heap_caps_free(void* p) {
+    free(p);
+}
+
+// ============================================================================
+// GPIO (no-op)
+// ============================================================================
+
+#define LOW     0
+#define HIGH    1
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+
+// ============================================================================
+// String
+// ============================================================================
+
+#define F(str) (str)
+
+class String {
+public:
+    String() {}
+    String(const char* s) : str(s ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    String(char c) : str(1, c) {}
+    String(int v) : str(std::to_string(v)) {}
+    String(unsigned int v) : str(std::to_string(v)) {}
+    String(long v) : str(std::to_string(v)) {}
+    String(unsigned long v) : str(std::to_string(v)) {}
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.size(); }
+    bool isEmpty() const { return str.empty(); }
+    void reserve(unsigned int n) { str.reserve(n); }
+    int indexOf(const char* s) const {
+        size_t pos = str.find(s);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return String(str.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const { return String(str.substr(from, to - from)); }
+    long toInt() const { return strtol(str.c_str(), NULL, 10); }
+
+    char operator[](unsigned int i) const { return str[i]; }
+    bool operator==(const String& o) const { return str == o.str; }
+    bool operator==(const char* o) const { return str == o; }
+    bool operator!=(const String& o) const { return str != o.str; }
+    bool operator!=(const char* o) const { return str != o; }
+    bool operator<(const String& o) const { return str < o.str; }
+    String& operator+=(const String& o) { str += o.str; return *this; }
+    String& operator+=(const char* o) { str += o; return *this; }
+    String& operator+=(char c) { str += c; return *this; }
+    String operator+(const String& o) const { return String(str + o.str); }
+    String operator+(const char* o) const { return String(str + o); }
+
+    const std::string& std() const { return str; }
+
+private:
+    std::string str;
+};
+
+inline String operator+(const char* a, const String& b) { return String(a) + b; }
+
+// ============================================================================
+// Serial (stderr, silent unless PIXELTREE_HOST_LOG is set)
+// ============================================================================
+
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    int availableForWrite() const { return 4096; }
+    void flush() { if (enabled()) fflush(stderr); }
+
+    size_t write(const uint8_t* buf, size_t len) {
+        if (enabled()) fwrite(buf, 1, len, stderr);
+        return len;
+    }
+    void print(const char* s) { if (enabled()) fputs(s, stderr); }
+    void print(const String& s) { print(s.c_str()); }
+    void print(int v) { if (enabled()) fprintf(stderr, "%d", v); }
+    void println() { print("\n"); }
+    void println(const char* s) { print(s); println(); }
+    void println(const String& s) { println(s.c_str()); }
+    void printf(const char* fmt, ...) {
+        if (!enabled()) return;
+        va_list args;
+        va_start(args, fmt);
+        vfprintf(stderr, fmt, args);
+        va_end(args);
+    }
+
+private:
+    static bool enabled() {
+        static const bool on = getenv("PIXELTREE_HOST_LOG") != NULL;
+        return on;
+    }
+};
+
+inline HostSerial Serial;
+
+// ============================================================================
+// FreeRTOS / ESP-IDF subset used by LEDController and NVSManager
+// ============================================================================
+
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdPASS              1
+#define pdFAIL              0
+#define pdTRUE              1
+#define pdFALSE             0
+#define portMAX_DELAY       0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+// Tasks never start on the host: tools drive the render loop frame by frame
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t,
+                                          void*, int, TaskHandle_t* handle, int) {
+    if (handle) *handle = NULL;
+    return pdPASS;
+}
+
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+inline void vTaskDelayUntil(TickType_t* lastWake, TickType_t period) {
+    TickType_t next = *lastWake + period;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(next - now) > 0) {
+        delay(next - now);
+    }
+    *lastWake = next;
+}
+
+// Single-threaded host: semaphores are always available, notifications are
+// never waited on because no task runs
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return NULL; }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return NULL; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 1; }
+
+// The host never restarts, so shutdown handlers are accepted and never run
+typedef int esp_err_t;
+typedef void (*shutdown_handler_t)(void);
+#define ESP_OK              0
+
+inline esp_err_t esp_register_shutdown_handler(shutdown_handler_t) { return ESP_OK; }
+
+#endif // HOST_ARDUINO_H
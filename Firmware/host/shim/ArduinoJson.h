@@ -0,0 +1,686 @@
+/*
+ * ArduinoJson.h - Host shim of the ArduinoJson 7 subset used by the firmware
+ *
+ * Implements JsonDocument / JsonVariant / JsonObject / JsonArray with the same
+ * is<T>() / as<T>() conversion rules as ArduinoJson (e.g. is<uint8_t>() is only
+ * true for integers in 0..255), plus deserializeJson() and serializeJson().
+ * Memory is heap-backed; the StaticJsonDocument capacity is ignored.
+ */
+
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include <Arduino.h>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+struct JsonNode {
+    enum Type { T_NULL, T_BOOL, T_INT, T_FLOAT, T_STRING, T_OBJECT, T_ARRAY };
+
+    Type type = T_NULL;
+    bool b = false;
+    long long i = 0;
+    double f = 0;
+    std::string s;
+    std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> members;
+    std::vector<std::unique_ptr<JsonNode>> items;
+
+    void clear() {
+        type = T_NULL;
+        s.clear();
+        members.clear();
+        items.clear();
+    }
+
+    JsonNode* find(const char* key) const {
+        if (type != T_OBJECT) return nullptr;
+        for (const auto& m : members) {
+            if (m.first == key) return m.second.get();
+        }
+        return nullptr;
+    }
+
+    JsonNode* getOrAdd(const char* key) {
+        if (type == T_NULL) type = T_OBJECT;
+        if (type != T_OBJECT) return nullptr;
+        JsonNode* n = find(key);
+        if (n) return n;
+        members.emplace_back(key, std::unique_ptr<JsonNode>(new JsonNode()));
+        return members.back().second.get();
+    }
+
+    JsonNode* addItem() {
+        if (type == T_NULL) type = T_ARRAY;
+        if (type != T_ARRAY) return nullptr;
+        items.emplace_back(new JsonNode());
+        return items.back().get();
+    }
+
+    void copyFrom(const JsonNode& o) {
+        clear();
+        type = o.type; b = o.b; i = o.i; f = o.f; s = o.s;
+        for (const auto& m : o.members) {
+            std::unique_ptr<JsonNode> n(new JsonNode());
+            n->copyFrom(*m.second);
+            members.emplace_back(m.first, std::move(n));
+        }
+        for (const auto& it : o.items) {
+            std::unique_ptr<JsonNode> n(new JsonNode());
+            n->copyFrom(*it);
+            items.push_back(std::move(n));
+        }
+    }
+};
+
+class JsonObject;
+class JsonArray;
+
+class JsonString {
+public:
+    explicit JsonString(const char* s) : str(s) {}
+    const char* c_str() const { return str; }
+    operator const char*() const { return str; }
+
+private:
+    const char* str;
+};
+
+// ============================================================================
+// JsonVariant
+// ============================================================================
+
+class JsonVariant {
+public:
+    JsonVariant() : node(nullptr) {}
+    explicit JsonVariant(JsonNode* n) : node(n) {}
+
+    bool isNull() const { return node == nullptr || node->type == JsonNode::T_NULL; }
+    size_t size() const {
+        if (!node) return 0;
+        if (node->type == JsonNode::T_OBJECT) return node->members.size();
+        if (node->type == JsonNode::T_ARRAY) return node->items.size();
+        return 0;
+    }
+
+    template <typename T> bool is() const;
+    template <typename T> T as() const;
+    template <typename T> T to();
+
+    template <typename T> operator T() const { return as<T>(); }
+
+    JsonVariant operator[](const char* key) const {
+        return JsonVariant(node ? node->getOrAdd(key) : nullptr);
+    }
+    JsonVariant operator[](const String& key) const { return (*this)[key.c_str()]; }
+    JsonVariant operator[](size_t index) const {
+        if (!node || node->type != JsonNode::T_ARRAY || index >= node->items.size()) return JsonVariant();
+        return JsonVariant(node->items[index].get());
+    }
+    JsonVariant operator[](int index) const { return (*this)[(size_t)index]; }
+
+    bool containsKey(const char* key) const {
+        JsonNode* n = node ? node->find(key) : nullptr;
+        return n != nullptr && n->type != JsonNode::T_NULL;
+    }
+
+    template <typename T>
+    T operator|(const T& def) const { return is<T>() ? as<T>() : def; }
+    const char* operator|(const char* def) const { return is<const char*>() ? as<const char*>() : def; }
+
+    // Assignment
+    const JsonVariant& operator=(const JsonVariant& v) const { set(v); return *this; }
+    JsonVariant& operator=(const JsonVariant& v) { set(v); return *this; }
+
+    template <typename T>
+    const JsonVariant& operator=(const T& v) const { set(v); return *this; }
+
+    void set(const JsonVariant& v) const {
+        if (!node || node == v.node) return;
+        if (v.node) node->copyFrom(*v.node);
+        else node->clear();
+    }
+    void set(bool v) const { if (node) { node->clear(); node->type = JsonNode::T_BOOL; node->b = v; } }
+    void set(const char* v) const {
+        if (!node) return;
+        node->clear();
+        if (v) { node->type = JsonNode::T_STRING; node->s = v; }
+    }
+    void set(char* v) const { set((const char*)v); }
+    void set(const String& v) const { set(v.c_str()); }
+    void set(const std::string& v) const { set(v.c_str()); }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    set(T v) const {
+        if (!node) return;
+        node->clear();
+        node->type = JsonNode::T_INT;
+        node->i = (long long)v;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    set(T v) const {
+        if (!node) return;
+        node->clear();
+        node->type = JsonNode::T_FLOAT;
+        node->f = v;
+    }
+
+    template <typename T>
+    typename std::enable_if<!std::is_same<T, JsonObject>::value && !std::is_same<T, JsonArray>::value, bool>::type
+    add(const T& v) const {
+        JsonNode* n = node ? node->addItem() : nullptr;
+        if (!n) return false;
+        JsonVariant(n).set(v);
+        return true;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_same<T, JsonObject>::value || std::is_same<T, JsonArray>::value, T>::type
+    add() const;
+
+    JsonNode* getNode() const { return node; }
+
+protected:
+    JsonNode* node;
+};
+
+// ============================================================================
+// JsonObject / JsonArray
+// ============================================================================
+
+class JsonPair {
+public:
+    JsonPair(const std::string* k, JsonNode* v) : k(k), v(v) {}
+    JsonString key() const { return JsonString(k->c_str()); }
+    JsonVariant value() const { return JsonVariant(v); }
+
+private:
+    const std::string* k;
+    JsonNode* v;
+};
+
+class JsonObject : public JsonVariant {
+public:
+    JsonObject() {}
+    explicit JsonObject(JsonNode* n) : JsonVariant(n && n->type == JsonNode::T_OBJECT ? n : nullptr) {}
+
+    class iterator {
+    public:
+        typedef std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>>::iterator It;
+        explicit iterator(It it) : it(it) {}
+        JsonPair operator*() const { return JsonPair(&it->first, it->second.get()); }
+        iterator& operator++() { ++it; return *this; }
+        bool operator!=(const iterator& o) const { return it != o.it; }
+
+    private:
+        It it;
+    };
+
+    iterator begin() const { return node ? iterator(node->members.begin()) : iterator(empty().begin()); }
+    iterator end() const { return node ? iterator(node->members.end()) : iterator(empty().end()); }
+
+    void remove(const char* key) const {
+        if (!node) return;
+        for (auto it = node->members.begin(); it != node->members.end(); ++it) {
+            if (it->first == key) { node->members.erase(it); return; }
+        }
+    }
+
+private:
+    static std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>>& empty() {
+        static std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> e;
+        return e;
+    }
+};
+
+class JsonArray : public JsonVariant {
+public:
+    JsonArray() {}
+    explicit JsonArray(JsonNode* n) : JsonVariant(n && n->type == JsonNode::T_ARRAY ? n : nullptr) {}
+
+    class iterator {
+    public:
+        typedef std::vector<std::unique_ptr<JsonNode>>::iterator It;
+        explicit iterator(It it) : it(it) {}
+        JsonVariant operator*() const { return JsonVariant(it->get()); }
+        iterator& operator++() { ++it; return *this; }
+        bool operator!=(const iterator& o) const { return it != o.it; }
+
+    private:
+        It it;
+    };
+
+    iterator begin() const { return node ? iterator(node->items.begin()) : iterator(empty().begin()); }
+    iterator end() const { return node ? iterator(node->items.end()) : iterator(empty().end()); }
+
+private:
+    static std::vector<std::unique_ptr<JsonNode>>& empty() {
+        static std::vector<std::unique_ptr<JsonNode>> e;
+        return e;
+    }
+};
+
+template <typename T>
+typename std::enable_if<std::is_same<T, JsonObject>::value || std::is_same<T, JsonArray>::value, T>::type
+JsonVariant::add() const {
+    JsonNode* n = node ? node->addItem() : nullptr;
+    if (!n) return T();
+    return JsonVariant(n).to<T>();
+}
+
+template <typename T>
+T JsonVariant::to() {
+    static_assert(std::is_same<T, JsonObject>::value || std::is_same<T, JsonArray>::value,
+                  "to<T>() supports JsonObject and JsonArray");
+    if (!node) return T();
+    node->clear();
+    node->type = std::is_same<T, JsonObject>::value ? JsonNode::T_OBJECT : JsonNode::T_ARRAY;
+    return T(node);
+}
+
+template <typename T>
+bool JsonVariant::is() const {
+    if (!node) return false;
+    typedef typename std::remove_cv<T>::type U;
+    if constexpr (std::is_same<U, bool>::value) {
+        return node->type == JsonNode::T_BOOL;
+    } else if constexpr (std::is_integral<U>::value) {
+        return node->type == JsonNode::T_INT &&
+               node->i >= (long long)std::numeric_limits<U>::min() &&
+               (node->i < 0 || (unsigned long long)node->i <= (unsigned long long)std::numeric_limits<U>::max());
+    } else if constexpr (std::is_floating_point<U>::value) {
+        return node->type == JsonNode::T_INT || node->type == JsonNode::T_FLOAT;
+    } else if constexpr (std::is_same<U, const char*>::value || std::is_same<U, String>::value) {
+        return node->type == JsonNode::T_STRING;
+    } else if constexpr (std::is_same<U, JsonObject>::value) {
+        return node->type == JsonNode::T_OBJECT;
+    } else if constexpr (std::is_same<U, JsonArray>::value) {
+        return node->type == JsonNode::T_ARRAY;
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+T JsonVariant::as() const {
+    typedef typename std::remove_cv<T>::type U;
+    if constexpr (std::is_same<U, bool>::value) {
+        if (!node) return false;
+        if (node->type == JsonNode::T_BOOL) return node->b;
+        if (node->type == JsonNode::T_INT) return node->i != 0;
+        if (node->type == JsonNode::T_FLOAT) return node->f != 0;
+        return node->type != JsonNode::T_NULL;
+    } else if constexpr (std::is_integral<U>::value || std::is_enum<U>::value) {
+        if (!node) return (U)0;
+        if (node->type == JsonNode::T_INT) return (U)node->i;
+        if (node->type == JsonNode::T_FLOAT) return (U)(long long)node->f;
+        if (node->type == JsonNode::T_BOOL) return (U)(node->b ? 1 : 0);
+        return (U)0;
+    } else if constexpr (std::is_floating_point<U>::value) {
+        if (!node) return 0;
+        if (node->type == JsonNode::T_INT) return (U)node->i;
+        if (node->type == JsonNode::T_FLOAT) return (U)node->f;
+        return 0;
+    } else if constexpr (std::is_same<U, const char*>::value) {
+        return (node && node->type == JsonNode::T_STRING) ? node->s.c_str() : nullptr;
+    } else if constexpr (std::is_same<U, String>::value) {
+        return (node && node->type == JsonNode::T_STRING) ? String(node->s.c_str()) : String();
+    } else if constexpr (std::is_same<U, JsonObject>::value) {
+        return JsonObject(node);
+    } else if constexpr (std::is_same<U, JsonArray>::value) {
+        return JsonArray(node);
+    } else if constexpr (std::is_same<U, JsonVariant>::value) {
+        return *this;
+    } else {
+        static_assert(sizeof(U) == 0, "Unsupported as<T>() type");
+    }
+}
+
+// ============================================================================
+// JsonDocument
+// ============================================================================
+
+class JsonDocument {
+public:
+    JsonDocument() {}
+    explicit JsonDocument(size_t) {}
+    JsonDocument(const JsonDocument& o) { root.copyFrom(o.root); }
+    JsonDocument& operator=(const JsonDocument& o) { root.copyFrom(o.root); return *this; }
+
+    void clear() { root.clear(); }
+    bool isNull() const { return root.type == JsonNode::T_NULL; }
+    size_t size() const { return JsonVariant(const_cast<JsonNode*>(&root)).size(); }
+    bool overflowed() const { return false; }
+
+    JsonVariant operator[](const char* key) { return JsonVariant(root.getOrAdd(key)); }
+    JsonVariant operator[](const String& key) { return (*this)[key.c_str()]; }
+    JsonVariant operator[](int index) { return JsonVariant(&root)[index]; }
+    bool containsKey(const char* key) const { return JsonVariant(const_cast<JsonNode*>(&root)).containsKey(key); }
+
+    template <typename T> T as() { return JsonVariant(&root).as<T>(); }
+    template <typename T> bool is() { return JsonVariant(&root).is<T>(); }
+    template <typename T> T to() { return JsonVariant(&root).to<T>(); }
+    template <typename T> bool add(const T& v) { return JsonVariant(&root).add(v); }
+    template <typename T> T add() { return JsonVariant(&root).add<T>(); }
+
+    operator JsonVariant() { return JsonVariant(&root); }
+    JsonVariant getVariant() const { return JsonVariant(const_cast<JsonNode*>(&root)); }
+
+private:
+    JsonNode root;
+};
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacity) : JsonDocument(capacity) {}
+};
+
+// ============================================================================
+// Deserialization
+// ============================================================================
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+    DeserializationError(Code c = Ok) : code_(c) {}
+    explicit operator bool() const { return code_ != Ok; }
+    bool operator==(Code c) const { return code_ == c; }
+    bool operator!=(Code c) const { return code_ != c; }
+    Code code() const { return code_; }
+    const char* c_str() const {
+        static const char* names[] = { "Ok", "EmptyInput", "IncompleteInput",
+                                       "InvalidInput", "NoMemory", "TooDeep" };
+        return names[code_];
+    }
+
+private:
+    Code code_;
+};
+
+namespace host_json {
+
+class Parser {
+public:
+    Parser(const char* begin, const char* end) : p(begin), end(end) {}
+
+    DeserializationError parseRoot(JsonNode& root) {
+        root.clear();
+        skipWs();
+        if (p >= end) return DeserializationError::EmptyInput;
+        DeserializationError err = parseValue(root, 0);
+        return err;
+    }
+
+private:
+    const char* p;
+    const char* end;
+
+    void skipWs() { while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p; }
+
+    DeserializationError parseValue(JsonNode& n, int depth) {
+        if (depth > 10) return DeserializationError::TooDeep;
+        skipWs();
+        if (p >= end) return DeserializationError::IncompleteInput;
+        char c = *p;
+        if (c == '{') return parseObject(n, depth);
+        if (c == '[') return parseArray(n, depth);
+        if (c == '"' || c == '\'') {
+            n.type = JsonNode::T_STRING;
+            return parseString(n.s);
+        }
+        if (c == 't' || c == 'f' || c == 'n') return parseLiteral(n);
+        return parseNumber(n);
+    }
+
+    DeserializationError parseObject(JsonNode& n, int depth) {
+        n.type = JsonNode::T_OBJECT;
+        ++p;
+        skipWs();
+        if (p < end && *p == '}') { ++p; return DeserializationError::Ok; }
+        while (true) {
+            skipWs();
+            if (p >= end) return DeserializationError::IncompleteInput;
+            std::string key;
+            if (*p != '"' && *p != '\'') return DeserializationError::InvalidInput;
+            DeserializationError err = parseString(key);
+            if (err) return err;
+            skipWs();
+            if (p >= end) return DeserializationError::IncompleteInput;
+            if (*p != ':') return DeserializationError::InvalidInput;
+            ++p;
+            JsonNode* child = n.getOrAdd(key.c_str());
+            err = parseValue(*child, depth + 1);
+            if (err) return err;
+            skipWs();
+            if (p >= end) return DeserializationError::IncompleteInput;
+            if (*p == ',') { ++p; continue; }
+            if (*p == '}') { ++p; return DeserializationError::Ok; }
+            return DeserializationError::InvalidInput;
+        }
+    }
+
+    DeserializationError parseArray(JsonNode& n, int depth) {
+        n.type = JsonNode::T_ARRAY;
+        ++p;
+        skipWs();
+        if (p < end && *p == ']') { ++p; return DeserializationError::Ok; }
+        while (true) {
+            DeserializationError err = parseValue(*n.addItem(), depth + 1);
+            if (err) return err;
+            skipWs();
+            if (p >= end) return DeserializationError::IncompleteInput;
+            if (*p == ',') { ++p; continue; }
+            if (*p == ']') { ++p; return DeserializationError::Ok; }
+            return DeserializationError::InvalidInput;
+        }
+    }
+
+    DeserializationError parseString(std::string& out) {
+        char quote = *p++;
+        out.clear();
+        while (p < end && *p != quote) {
+            char c = *p++;
+            if (c == '\\') {
+                if (p >= end) return DeserializationError::IncompleteInput;
+                char e = *p++;
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': {
+                        if (end - p < 4) return DeserializationError::IncompleteInput;
+                        unsigned cp = (unsigned)strtoul(std::string(p, 4).c_str(), NULL, 16);
+                        p += 4;
+                        if (cp < 0x80) {
+                            out += (char)cp;
+                        } else if (cp < 0x800) {
+                            out += (char)(0xC0 | (cp >> 6));
+                            out += (char)(0x80 | (cp & 0x3F));
+                        } else {
+                            out += (char)(0xE0 | (cp >> 12));
+                            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+                            out += (char)(0x80 | (cp & 0x3F));
+                        }
+                        break;
+                    }
+                    default: out += e; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (p >= end) return DeserializationError::IncompleteInput;
+        ++p;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError parseLiteral(JsonNode& n) {
+        auto match = [&](const char* lit) {
+            size_t len = strlen(lit);
+            if ((size_t)(end - p) >= len && strncmp(p, lit, len) == 0) { p += len; return true; }
+            return false;
+        };
+        if (match("true")) { n.type = JsonNode::T_BOOL; n.b = true; return DeserializationError::Ok; }
+        if (match("false")) { n.type = JsonNode::T_BOOL; n.b = false; return DeserializationError::Ok; }
+        if (match("null")) { n.type = JsonNode::T_NULL; return DeserializationError::Ok; }
+        return DeserializationError::InvalidInput;
+    }
+
+    DeserializationError parseNumber(JsonNode& n) {
+        const char* start = p;
+        bool isFloat = false;
+        if (p < end && (*p == '-' || *p == '+')) ++p;
+        while (p < end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' ||
+                           *p == '-' || *p == '+')) {
+            if (*p == '.' || *p == 'e' || *p == 'E') isFloat = true;
+            ++p;
+        }
+        if (p == start) return DeserializationError::InvalidInput;
+        std::string num(start, p - start);
+        if (isFloat) {
+            n.type = JsonNode::T_FLOAT;
+            n.f = strtod(num.c_str(), NULL);
+        } else {
+            n.type = JsonNode::T_INT;
+            n.i = strtoll(num.c_str(), NULL, 10);
+        }
+        return DeserializationError::Ok;
+    }
+};
+
+inline void writeString(std::string& out, const std::string& s) {
+    out += '"';
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: out += c; break;
+        }
+    }
+    out += '"';
+}
+
+inline void write(std::string& out, const JsonNode* n) {
+    if (!n) { out += "null"; return; }
+    switch (n->type) {
+        case JsonNode::T_NULL: out += "null"; break;
+        case JsonNode::T_BOOL: out += n->b ? "true" : "false"; break;
+        case JsonNode::T_INT: out += std::to_string(n->i); break;
+        case JsonNode::T_FLOAT: {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.9g", n->f);
+            out += buf;
+            break;
+        }
+        case JsonNode::T_STRING: writeString(out, n->s); break;
+        case JsonNode::T_OBJECT: {
+            out += '{';
+            bool first = true;
+            for (const auto& m : n->members) {
+                if (!first) out += ',';
+                first = false;
+                writeString(out, m.first);
+                out += ':';
+                write(out, m.second.get());
+            }
+            out += '}';
+            break;
+        }
+        case JsonNode::T_ARRAY: {
+            out += '[';
+            bool first = true;
+            for (const auto& it : n->items) {
+                if (!first) out += ',';
+                first = false;
+                write(out, it.get());
+            }
+            out += ']';
+            break;
+        }
+    }
+}
+
+} // namespace host_json
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+    JsonNode* root = doc.getVariant().getNode();
+    if (!input) return DeserializationError::EmptyInput;
+    host_json::Parser parser(input, input + length);
+    return parser.parseRoot(*root);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+    return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const std::string& input) {
+    return deserializeJson(doc, input.c_str(), input.size());
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+inline size_t serializeJson(const JsonVariant& src, String& output) {
+    std::string out;
+    host_json::write(out, src.getNode());
+    output = String(out);
+    return out.size();
+}
+
+inline size_t serializeJson(const JsonVariant& src, std::string& output) {
+    output.clear();
+    host_json::write(output, src.getNode());
+    return output.size();
+}
+
+inline size_t serializeJson(const JsonVariant& src, char* buffer, size_t size) {
+    std::string out;
+    host_json::write(out, src.getNode());
+    if (size == 0) return 0;
+    size_t n = out.size() < size - 1 ? out.size() : size - 1;
+    memcpy(buffer, out.data(), n);
+    buffer[n] = '\0';
+    return n;
+}
+
+inline size_t serializeJson(const JsonDocument& doc, String& output) {
+    return serializeJson(doc.getVariant(), output);
+}
+
+inline size_t serializeJson(const JsonDocument& doc, std::string& output) {
+    return serializeJson(doc.getVariant(), output);
+}
+
+inline size_t serializeJson(const JsonDocument& doc, char* buffer, size_t size) {
+    return serializeJson(doc.getVariant(), buffer, size);
+}
+
+inline size_t measureJson(const JsonVariant& src) {
+    std::string out;
+    host_json::write(out, src.getNode());
+    return out.size();
+}
+
+inline size_t measureJson(const JsonDocument& doc) { return measureJson(doc.getVariant()); }
+
+#endif // HOST_ARDUINOJSON_H
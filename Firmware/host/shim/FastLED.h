@@ -0,0 +1,666 @@
+/*
+ * FastLED.h - Host shim of the FastLED subset used by the effect engine
+ *
+ * Integer math (scale8, sin8, inoise8, blend, ColorFromPalette, hsv2rgb_rainbow,
+ * random8/16) follows the FastLED reference C implementations, so effect output
+ * on the host matches the look on the tree. FastLED.show() does not drive any
+ * hardware - it only counts frames and records the last displayed frame.
+ */
+
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include <Arduino.h>
+#include <vector>
+
+typedef uint8_t fract8;
+typedef uint16_t accum88;
+typedef int16_t saccum87;
+
+// ============================================================================
+// 8-bit Math
+// ============================================================================
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : (uint8_t)t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : (uint8_t)t;
+}
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8);
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (uint8_t)((((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0));
+}
+
+inline uint16_t scale16(uint16_t i, uint16_t scale) {
+    return (uint16_t)(((uint32_t)i * (1 + (uint32_t)scale)) >> 16);
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (uint16_t)((a << 8) | b);
+    partial += (uint16_t)(b * amountOfB);
+    partial -= (uint16_t)(a * amountOfB);
+    return (uint8_t)(partial >> 8);
+}
+
+inline int8_t avg7(int8_t i, int8_t j) {
+    return (int8_t)((i >> 1) + (j >> 1) + (i & 0x1));
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i) {
+    uint8_t j = i;
+    if (j & 0x80) j = 255 - j;
+    uint8_t jj = scale8(j, j);
+    uint8_t jj2 = jj << 1;
+    if (i & 0x80) jj2 = 255 - jj2;
+    return jj2;
+}
+
+inline uint8_t sin8(uint8_t theta) {
+    static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+    uint8_t offset = theta;
+    if (theta & 0x40) offset = (uint8_t)255 - offset;
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) ++secoffset;
+
+    uint8_t section = offset >> 4;
+    const uint8_t* p = b_m16_interleave + section * 2;
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+    uint8_t mx = (uint8_t)((m16 * secoffset) >> 4);
+
+    int8_t y = (int8_t)(mx + b);
+    if (theta & 0x80) y = -y;
+    y += 128;
+    return (uint8_t)y;
+}
+
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+inline uint8_t triwave8(uint8_t in) {
+    if (in & 0x80) in = 255 - in;
+    return (uint8_t)(in << 1);
+}
+
+inline uint8_t beatsin8(uint8_t bpm, uint8_t lowest = 0, uint8_t highest = 255) {
+    uint8_t beat = (uint8_t)(((uint32_t)millis() * bpm * 280) >> 16);
+    uint8_t rangewidth = highest - lowest;
+    return lowest + scale8(sin8(beat), rangewidth);
+}
+
+// ============================================================================
+// Random Numbers (FastLED LCG)
+// ============================================================================
+
+class HostRandom {
+public:
+    static inline uint16_t seed = 1337;
+};
+
+inline void random16_set_seed(uint16_t seed) { HostRandom::seed = seed; }
+inline uint16_t random16_get_seed() { return HostRandom::seed; }
+
+inline uint16_t random16() {
+    HostRandom::seed = (uint16_t)(HostRandom::seed * 2053 + 13849);
+    return HostRandom::seed;
+}
+
+inline uint16_t random16(uint16_t lim) {
+    return (uint16_t)(((uint32_t)random16() * lim) >> 16);
+}
+
+inline uint16_t random16(uint16_t min, uint16_t lim) {
+    return min + random16(lim - min);
+}
+
+inline uint8_t random8() {
+    random16();
+    return (uint8_t)((uint8_t)(HostRandom::seed & 0xFF) + (uint8_t)(HostRandom::seed >> 8));
+}
+
+inline uint8_t random8(uint8_t lim) {
+    return (uint8_t)((random8() * lim) >> 8);
+}
+
+inline uint8_t random8(uint8_t min, uint8_t lim) {
+    return min + random8(lim - min);
+}
+
+// ============================================================================
+// Noise (FastLED 2D inoise8)
+// ============================================================================
+
+namespace host_noise {
+
+static const uint8_t p[] = {
+    151,160,137, 91, 90, 15,131, 13,201, 95, 96, 53,194,233,  7,225,
+    140, 36,103, 30, 69,142,  8, 99, 37,240, 21, 10, 23,190,  6,148,
+    247,120,234, 75,  0, 26,197, 62, 94,252,219,203,117, 35, 11, 32,
+     57,177, 33, 88,237,149, 56, 87,174, 20,125,136,171,168, 68,175,
+     74,165, 71,134,139, 48, 27,166, 77,146,158,231, 83,111,229,122,
+     60,211,133,230,220,105, 92, 41, 55, 46,245, 40,244,102,143, 54,
+     65, 25, 63,161,  1,216, 80, 73,209, 76,132,187,208, 89, 18,169,
+    200,196,135,130,116,188,159, 86,164,100,109,198,173,186,  3, 64,
+     52,217,226,250,124,123,  5,202, 38,147,118,126,255, 82, 85,212,
+    207,206, 59,227, 47, 16, 58, 17,182,189, 28, 42,223,183,170,213,
+    119,248,152,  2, 44,154,163, 70,221,153,101,155,167, 43,172,  9,
+    129, 22, 39,253, 19, 98,108,110, 79,113,224,232,178,185,112,104,
+    218,246, 97,228,251, 34,242,193,238,210,144, 12,191,179,162,241,
+     81, 51,145,235,249, 14,239,107, 49,192,214, 31,181,199,106,157,
+    184, 84,204,176,115,121, 50, 45,127,  4,150,254,138,236,205, 93,
+    222,114, 67, 29, 24, 72,243,141,128,195, 78, 66,215, 61,156,180
+};
+
+inline uint8_t P(int x) { return p[x & 0xFF]; }
+
+inline int8_t grad8(uint8_t hash, int8_t x, int8_t y) {
+    int8_t u, v;
+    if (hash & 4) { u = y; v = x; }
+    else          { u = x; v = y; }
+    if (hash & 1) u = -u;
+    if (hash & 2) v = -v;
+    return avg7(u, v);
+}
+
+inline int8_t lerp7by8(int8_t a, int8_t b, fract8 frac) {
+    if (b > a) {
+        uint8_t delta = (uint8_t)(b - a);
+        return (int8_t)(a + scale8(delta, frac));
+    }
+    uint8_t delta = (uint8_t)(a - b);
+    return (int8_t)(a - scale8(delta, frac));
+}
+
+} // namespace host_noise
+
+inline int8_t inoise8_raw(uint16_t x, uint16_t y) {
+    using namespace host_noise;
+    uint8_t X = x >> 8;
+    uint8_t Y = y >> 8;
+
+    uint8_t A = P(X) + Y;
+    uint8_t AA = P(A);
+    uint8_t AB = P(A + 1);
+    uint8_t B = P(X + 1) + Y;
+    uint8_t BA = P(B);
+    uint8_t BB = P(B + 1);
+
+    uint8_t u = ease8InOutQuad((uint8_t)x);
+    uint8_t v = ease8InOutQuad((uint8_t)y);
+
+    int8_t xx = ((uint8_t)x >> 1) & 0x7F;
+    int8_t yy = ((uint8_t)y >> 1) & 0x7F;
+    const uint8_t N = 0x80;
+
+    int8_t X1 = lerp7by8(grad8(P(AA), xx, yy), grad8(P(BA), xx - N, yy), u);
+    int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N), grad8(P(BB), xx - N, yy - N), u);
+    return lerp7by8(X1, X2, v);
+}
+
+inline uint8_t inoise8(uint16_t x, uint16_t y) {
+    int8_t n = inoise8_raw(x, y);
+    n += 64;
+    return qadd8((uint8_t)n, (uint8_t)n);
+}
+
+// ============================================================================
+// Colors
+// ============================================================================
+
+struct CHSV {
+    union {
+        struct { uint8_t hue; uint8_t sat; uint8_t val; };
+        uint8_t raw[3];
+    };
+    CHSV() : hue(0), sat(0), val(0) {}
+    CHSV(uint8_t h, uint8_t s, uint8_t v) : hue(h), sat(s), val(v) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    typedef enum : uint32_t {
+        AliceBlue = 0xF0F8FF, Amethyst = 0x9966CC, AntiqueWhite = 0xFAEBD7,
+        Aqua = 0x00FFFF, Aquamarine = 0x7FFFD4, Azure = 0xF0FFFF, Beige = 0xF5F5DC,
+        Bisque = 0xFFE4C4, Black = 0x000000, BlanchedAlmond = 0xFFEBCD, Blue = 0x0000FF,
+        BlueViolet = 0x8A2BE2, Brown = 0xA52A2A, BurlyWood = 0xDEB887, CadetBlue = 0x5F9EA0,
+        Chartreuse = 0x7FFF00, Chocolate = 0xD2691E, Coral = 0xFF7F50,
+        CornflowerBlue = 0x6495ED, Cornsilk = 0xFFF8DC, Crimson = 0xDC143C, Cyan = 0x00FFFF,
+        DarkBlue = 0x00008B, DarkCyan = 0x008B8B, DarkGoldenrod = 0xB8860B,
+        DarkGray = 0xA9A9A9, DarkGreen = 0x006400, DarkKhaki = 0xBDB76B,
+        DarkMagenta = 0x8B008B, DarkOliveGreen = 0x556B2F, DarkOrange = 0xFF8C00,
+        DarkOrchid = 0x9932CC, DarkRed = 0x8B0000, DarkSalmon = 0xE9967A,
+        DarkSeaGreen = 0x8FBC8F, DarkSlateBlue = 0x483D8B, DarkSlateGray = 0x2F4F4F,
+        DarkTurquoise = 0x00CED1, DarkViolet = 0x9400D3, DeepPink = 0xFF1493,
+        DeepSkyBlue = 0x00BFFF, DimGray = 0x696969, DodgerBlue = 0x1E90FF,
+        FireBrick = 0xB22222, FloralWhite = 0xFFFAF0, ForestGreen = 0x228B22,
+        Fuchsia = 0xFF00FF, Gainsboro = 0xDCDCDC, GhostWhite = 0xF8F8FF, Gold = 0xFFD700,
+        Goldenrod = 0xDAA520, Gray = 0x808080, Green = 0x008000, GreenYellow = 0xADFF2F,
+        Honeydew = 0xF0FFF0, HotPink = 0xFF69B4, IndianRed = 0xCD5C5C, Indigo = 0x4B0082,
+        Ivory = 0xFFFFF0, Khaki = 0xF0E68C, Lavender = 0xE6E6FA, LavenderBlush = 0xFFF0F5,
+        LawnGreen = 0x7CFC00, LemonChiffon = 0xFFFACD, LightBlue = 0xADD8E6,
+        LightCoral = 0xF08080, LightCyan = 0xE0FFFF, LightGoldenrodYellow = 0xFAFAD2,
+        LightGreen = 0x90EE90, LightGrey = 0xD3D3D3, LightPink = 0xFFB6C1,
+        LightSalmon = 0xFFA07A, LightSeaGreen = 0x20B2AA, LightSkyBlue = 0x87CEFA,
+        LightSlateGray = 0x778899, LightSteelBlue = 0xB0C4DE, LightYellow = 0xFFFFE0,
+        Lime = 0x00FF00, LimeGreen = 0x32CD32, Linen = 0xFAF0E6, Magenta = 0xFF00FF,
+        Maroon = 0x800000, MediumAquamarine = 0x66CDAA, MediumBlue = 0x0000CD,
+        MediumOrchid = 0xBA55D3, MediumPurple = 0x9370DB, MediumSeaGreen = 0x3CB371,
+        MediumSlateBlue = 0x7B68EE, MediumSpringGreen = 0x00FA9A,
+        MediumTurquoise = 0x48D1CC, MediumVioletRed = 0xC71585, MidnightBlue = 0x191970,
+        MintCream = 0xF5FFFA, MistyRose = 0xFFE4E1, Moccasin = 0xFFE4B5,
+        NavajoWhite = 0xFFDEAD, Navy = 0x000080, OldLace = 0xFDF5E6, Olive = 0x808000,
+        OliveDrab = 0x6B8E23, Orange = 0xFFA500, OrangeRed = 0xFF4500, Orchid = 0xDA70D6,
+        PaleGoldenrod = 0xEEE8AA, PaleGreen = 0x98FB98, PaleTurquoise = 0xAFEEEE,
+        PaleVioletRed = 0xDB7093, PapayaWhip = 0xFFEFD5, PeachPuff = 0xFFDAB9,
+        Peru = 0xCD853F, Pink = 0xFFC0CB, Plaid = 0xCC5533, Plum = 0xDDA0DD,
+        PowderBlue = 0xB0E0E6, Purple = 0x800080, Red = 0xFF0000, RosyBrown = 0xBC8F8F,
+        RoyalBlue = 0x4169E1, SaddleBrown = 0x8B4513, Salmon = 0xFA8072,
+        SandyBrown = 0xF4A460, SeaGreen = 0x2E8B57, Seashell = 0xFFF5EE, Sienna = 0xA0522D,
+        Silver = 0xC0C0C0, SkyBlue = 0x87CEEB, SlateBlue = 0x6A5ACD, SlateGray = 0x708090,
+        Snow = 0xFFFAFA, SpringGreen = 0x00FF7F, SteelBlue = 0x4682B4, Tan = 0xD2B48C,
+        Teal = 0x008080, Thistle = 0xD8BFD8, Tomato = 0xFF6347, Turquoise = 0x40E0D0,
+        Violet = 0xEE82EE, Wheat = 0xF5DEB3, White = 0xFFFFFF, WhiteSmoke = 0xF5F5F5,
+        Yellow = 0xFFFF00, YellowGreen = 0x9ACD32
+    } HTMLColorCode;
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+    CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB& operator=(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+    CRGB& operator=(uint32_t colorcode) { *this = CRGB(colorcode); return *this; }
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB& operator+=(const CRGB& rhs) {
+        r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b);
+        return *this;
+    }
+    CRGB& operator-=(const CRGB& rhs) {
+        r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scaledown) {
+        uint16_t scale = 1 + (uint16_t)scaledown;
+        r = (uint8_t)((r * scale) >> 8);
+        g = (uint8_t)((g * scale) >> 8);
+        b = (uint8_t)((b * scale) >> 8);
+        return *this;
+    }
+    CRGB& nscale8_video(uint8_t scaledown) {
+        r = scale8_video(r, scaledown);
+        g = scale8_video(g, scaledown);
+        b = scale8_video(b, scaledown);
+        return *this;
+    }
+    CRGB& fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+
+    uint8_t getAverageLight() const { return (uint8_t)((r + g + b) / 3); }
+    explicit operator bool() const { return r || g || b; }
+};
+
+inline bool operator==(const CRGB& lhs, const CRGB& rhs) {
+    return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+inline bool operator!=(const CRGB& lhs, const CRGB& rhs) { return !(lhs == rhs); }
+
+inline CRGB operator+(const CRGB& p1, const CRGB& p2) {
+    return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b));
+}
+
+inline void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    const uint8_t K255 = 255, K171 = 171, K170 = 170, K85 = 85;
+    uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+
+    uint8_t offset = hue & 0x1F;
+    uint8_t offset8 = offset << 3;
+    uint8_t third = scale8(offset8, (256 / 3));
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {            // R -> O
+                r = K255 - third; g = third; b = 0;
+            } else {                        // O -> Y
+                r = K171; g = K85 + third; b = 0;
+            }
+        } else {
+            if (!(hue & 0x20)) {            // Y -> G
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = K171 - twothirds; g = K170 + third; b = 0;
+            } else {                        // G -> A
+                r = 0; g = K255 - third; b = third;
+            }
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {            // A -> B
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = 0; g = K171 - twothirds; b = K85 + twothirds;
+            } else {                        // B -> P
+                r = third; g = 0; b = K255 - third;
+            }
+        } else {
+            if (!(hue & 0x20)) {            // P -> K
+                r = K85 + third; g = 0; b = K171 - third;
+            } else {                        // K -> R
+                r = K170 + third; g = 0; b = K85 - third;
+            }
+        }
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = 255; g = 255; b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale);
+            g = scale8(g, satscale);
+            b = scale8(b, satscale);
+            r += desat; g += desat; b += desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = 0; g = 0; b = 0;
+        } else {
+            r = scale8(r, val);
+            g = scale8(g, val);
+            b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r; rgb.g = g; rgb.b = b;
+}
+
+inline CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    return CRGB(blend8(p1.r, p2.r, amountOfP2),
+                blend8(p1.g, p2.g, amountOfP2),
+                blend8(p1.b, p2.b, amountOfP2));
+}
+
+// ============================================================================
+// Fills
+// ============================================================================
+
+inline void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+    for (int i = 0; i < numToFill; ++i) leds[i] = color;
+}
+
+inline void fill_rainbow(CRGB* leds, int numToFill, uint8_t initialhue, uint8_t deltahue = 5) {
+    CHSV hsv(initialhue, 240, 255);
+    for (int i = 0; i < numToFill; ++i) {
+        leds[i] = hsv;
+        hsv.hue += deltahue;
+    }
+}
+
+inline void fill_gradient_RGB(CRGB* leds, uint16_t startpos, CRGB startcolor,
+                              uint16_t endpos, CRGB endcolor) {
+    if (endpos < startpos) {
+        uint16_t t = endpos; endpos = startpos; startpos = t;
+        CRGB tc = endcolor; endcolor = startcolor; startcolor = tc;
+    }
+
+    saccum87 rdistance87 = (saccum87)((endcolor.r - startcolor.r) << 7);
+    saccum87 gdistance87 = (saccum87)((endcolor.g - startcolor.g) << 7);
+    saccum87 bdistance87 = (saccum87)((endcolor.b - startcolor.b) << 7);
+
+    uint16_t pixeldistance = endpos - startpos;
+    int16_t divisor = pixeldistance ? pixeldistance : 1;
+
+    saccum87 rdelta87 = rdistance87 / divisor;
+    saccum87 gdelta87 = gdistance87 / divisor;
+    saccum87 bdelta87 = bdistance87 / divisor;
+
+    rdelta87 *= 2;
+    gdelta87 *= 2;
+    bdelta87 *= 2;
+
+    accum88 r88 = startcolor.r << 8;
+    accum88 g88 = startcolor.g << 8;
+    accum88 b88 = startcolor.b << 8;
+    for (uint16_t i = startpos; i <= endpos; ++i) {
+        leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+        r88 += rdelta87;
+        g88 += gdelta87;
+        b88 += bdelta87;
+    }
+}
+
+inline void fill_gradient_RGB(CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB& c2) {
+    uint16_t last = numLeds - 1;
+    fill_gradient_RGB(leds, 0, c1, last, c2);
+}
+
+inline void fadeToBlackBy(CRGB* leds, uint16_t numLeds, uint8_t fadeBy) {
+    for (uint16_t i = 0; i < numLeds; ++i) leds[i].nscale8(255 - fadeBy);
+}
+
+// ============================================================================
+// Palettes
+// ============================================================================
+
+typedef uint32_t TProgmemRGBPalette16[16];
+typedef uint8_t TProgmemRGBGradientPalette_byte;
+typedef const TProgmemRGBGradientPalette_byte* TProgmemRGBGradientPalette_bytes;
+
+#define FL_PROGMEM
+#define DEFINE_GRADIENT_PALETTE(X) \
+    extern const TProgmemRGBGradientPalette_byte X[] FL_PROGMEM =
+
+enum TBlendType { NOBLEND = 0, LINEARBLEND = 1 };
+
+class CRGBPalette16 {
+public:
+    CRGB entries[16];
+
+    CRGBPalette16() {}
+    CRGBPalette16(const TProgmemRGBPalette16& rhs) {
+        for (uint8_t i = 0; i < 16; ++i) entries[i] = CRGB(rhs[i]);
+    }
+    CRGBPalette16(TProgmemRGBGradientPalette_bytes progpal) { loadGradient(progpal); }
+
+    CRGB& operator[](uint8_t x) { return entries[x]; }
+    const CRGB& operator[](uint8_t x) const { return entries[x]; }
+
+private:
+    void loadGradient(TProgmemRGBGradientPalette_bytes progent) {
+        uint16_t count = 0;
+        while (progent[count * 4] != 255) ++count;
+        ++count;
+
+        int8_t lastSlotUsed = -1;
+        CRGB rgbstart(progent[1], progent[2], progent[3]);
+        int indexstart = 0;
+        while (indexstart < 255) {
+            progent += 4;
+            int indexend = progent[0];
+            CRGB rgbend(progent[1], progent[2], progent[3]);
+            uint8_t istart8 = indexstart / 16;
+            uint8_t iend8 = indexend / 16;
+            if (count < 16) {
+                if ((istart8 <= lastSlotUsed) && (lastSlotUsed < 15)) {
+                    istart8 = lastSlotUsed + 1;
+                    if (iend8 < istart8) iend8 = istart8;
+                }
+                lastSlotUsed = iend8;
+            }
+            fill_gradient_RGB(entries, istart8, rgbstart, iend8, rgbend);
+            indexstart = indexend;
+            rgbstart = rgbend;
+        }
+    }
+};
+
+inline CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index,
+                             uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
+    uint8_t hi4 = index >> 4;
+    uint8_t lo4 = index & 0x0F;
+    const CRGB* entry = &pal.entries[hi4];
+    uint8_t red1 = entry->r, green1 = entry->g, blue1 = entry->b;
+
+    if (lo4 && blendType != NOBLEND) {
+        entry = (hi4 == 15) ? &pal.entries[0] : entry + 1;
+        uint8_t f2 = lo4 << 4;
+        uint8_t f1 = 255 - f2;
+        red1 = scale8(red1, f1) + scale8(entry->r, f2);
+        green1 = scale8(green1, f1) + scale8(entry->g, f2);
+        blue1 = scale8(blue1, f1) + scale8(entry->b, f2);
+    }
+
+    if (brightness != 255) {
+        if (brightness) {
+            ++brightness;
+            red1 = scale8(red1, brightness);
+            green1 = scale8(green1, brightness);
+            blue1 = scale8(blue1, brightness);
+        } else {
+            red1 = green1 = blue1 = 0;
+        }
+    }
+    return CRGB(red1, green1, blue1);
+}
+
+inline const TProgmemRGBPalette16 CloudColors_p = {
+    CRGB::Blue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+    CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+    CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::SkyBlue,
+    CRGB::LightBlue, CRGB::White, CRGB::LightBlue, CRGB::SkyBlue
+};
+
+inline const TProgmemRGBPalette16 LavaColors_p = {
+    CRGB::Black, CRGB::Maroon, CRGB::Black, CRGB::Maroon,
+    CRGB::DarkRed, CRGB::DarkRed, CRGB::Maroon, CRGB::DarkRed,
+    CRGB::DarkRed, CRGB::DarkRed, CRGB::Red, CRGB::Orange,
+    CRGB::White, CRGB::Orange, CRGB::Red, CRGB::DarkRed
+};
+
+inline const TProgmemRGBPalette16 OceanColors_p = {
+    CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+    CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+    CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+    CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue
+};
+
+inline const TProgmemRGBPalette16 ForestColors_p = {
+    CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen,
+    CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+    CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen,
+    CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen
+};
+
+inline const TProgmemRGBPalette16 RainbowColors_p = {
+    0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+    0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+
+inline const TProgmemRGBPalette16 PartyColors_p = {
+    0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+    0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+inline const TProgmemRGBPalette16 HeatColors_p = {
+    0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+    0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
+
+// ============================================================================
+// Controller
+// ============================================================================
+
+enum EOrder { RGB = 0012, RBG = 0021, GRB = 0102, GBR = 0120, BRG = 0201, BGR = 0210 };
+enum ESPIChipsets { WS2812, WS2812B, WS2811, SK6812 };
+enum LEDColorCorrection { TypicalLEDStrip = 0xFFB0F0, UncorrectedColor = 0xFFFFFF };
+
+class CLEDController {
+public:
+    CLEDController(CRGB* leds, int numLeds, uint8_t pin) : leds(leds), numLeds(numLeds), pin(pin) {}
+    CLEDController& setCorrection(LEDColorCorrection) { return *this; }
+    CLEDController& setDither(uint8_t) { return *this; }
+
+    CRGB* leds;
+    int numLeds;
+    uint8_t pin;
+};
+
+class CFastLED {
+public:
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController& addLeds(CRGB* data, int numLeds, int offset = 0) {
+        controllers.emplace_back(data + offset, numLeds, DATA_PIN);
+        return controllers.back();
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+    void setMaxPowerInMilliWatts(uint32_t milliwatts) { maxPowerMilliWatts = milliwatts; }
+
+    void clear(bool writeData = false) {
+        for (CLEDController& c : controllers) fill_solid(c.leds, c.numLeds, CRGB::Black);
+        if (writeData) show();
+    }
+
+    void show() { show(brightness); }
+    void show(uint8_t scale) {
+        (void)scale;
+        ++showCount;
+        if (onShow) onShow();
+    }
+
+    // FastLED.delay() keeps refreshing the strip until the time has passed
+    void delay(unsigned long ms) {
+        unsigned long start = millis();
+        do {
+            show();
+            HostClock::advanceMillis(1);
+        } while (millis() - start < ms);
+    }
+
+    size_t count() const { return controllers.size(); }
+    CLEDController& operator[](int x) { return controllers[x]; }
+
+    // Host instrumentation
+    uint32_t getShowCount() const { return showCount; }
+    void resetShowCount() { showCount = 0; }
+    void (*onShow)() = nullptr;
+
+private:
+    std::vector<CLEDController> controllers;
+    uint8_t brightness = 255;
+    uint32_t maxPowerMilliWatts = 0;
+    uint32_t showCount = 0;
+};
+
+inline CFastLED FastLED;
+
+#endif // HOST_FASTLED_H
@@ -0,0 +1,101 @@
+/*
+ * Preferences.h - Host shim of the Arduino-ESP32 Preferences library
+ *
+ * Keeps every namespace in one in-memory "flash" shared by all instances, so
+ * a test can open a second handle to plant or inspect what NVSManager stores.
+ * Each put/remove that reaches the store counts as one flash write.
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <map>
+#include <string>
+#include "Arduino.h"
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* = NULL) {
+        ns = name;
+        ro = readOnly;
+        return true;
+    }
+    void end() { ns.clear(); }
+
+    bool clear() {
+        if (ro) return false;
+        for (auto it = store().begin(); it != store().end();) {
+            if (it->first.compare(0, ns.size() + 1, ns + "/") == 0) it = store().erase(it);
+            else ++it;
+        }
+        writes()++;
+        return true;
+    }
+    bool remove(const char* key) {
+        if (ro || !store().erase(path(key))) return false;
+        writes()++;
+        return true;
+    }
+    bool isKey(const char* key) { return store().count(path(key)) > 0; }
+
+    size_t putUChar(const char* key, uint8_t v) { return put(key, &v, sizeof(v)); }
+    size_t putUShort(const char* key, uint16_t v) { return put(key, &v, sizeof(v)); }
+    size_t putBool(const char* key, bool v) { return putUChar(key, v); }
+    size_t putString(const char* key, const String& v) { return put(key, v.c_str(), v.length()); }
+    size_t putBytes(const char* key, const void* v, size_t len) { return put(key, v, len); }
+
+    uint8_t getUChar(const char* key, uint8_t def = 0) { return get(key, def); }
+    uint16_t getUShort(const char* key, uint16_t def = 0) { return get(key, def); }
+    bool getBool(const char* key, bool def = false) { return getUChar(key, def); }
+    String getString(const char* key, const String& def = String()) {
+        auto it = store().find(path(key));
+        return it == store().end() ? def : String(it->second);
+    }
+    size_t getBytesLength(const char* key) {
+        auto it = store().find(path(key));
+        return it == store().end() ? 0 : it->second.size();
+    }
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = store().find(path(key));
+        if (it == store().end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    // Flash writes since start (or the last reset) across all namespaces
+    static uint32_t getWriteCount() { return writes(); }
+    static void resetWriteCount() { writes() = 0; }
+
+private:
+    std::string ns;
+    bool ro = false;
+
+    static std::map<std::string, std::string>& store() {
+        static std::map<std::string, std::string> s;
+        return s;
+    }
+    static uint32_t& writes() {
+        static uint32_t n = 0;
+        return n;
+    }
+
+    std::string path(const char* key) const { return ns + "/" + key; }
+
+    size_t put(const char* key, const void* v, size_t len) {
+        if (ro || ns.empty()) return 0;
+        store()[path(key)] = std::string((const char*)v, len);
+        writes()++;
+        return len;
+    }
+
+    template <typename T>
+    T get(const char* key, T def) {
+        auto it = store().find(path(key));
+        if (it == store().end() || it->second.size() != sizeof(T)) return def;
+        T v;
+        memcpy(&v, it->second.data(), sizeof(T));
+        return v;
+    }
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,17 @@
+/*
+ * lwip/sockets.h - Host shim of the lwIP BSD socket API
+ *
+ * lwIP offers the POSIX socket calls under their usual names, so on the host
+ * this is the system's own sockets: tests send real UDP over loopback.
+ */
+
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif // HOST_LWIP_SOCKETS_H
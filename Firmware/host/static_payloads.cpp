@@ -0,0 +1,76 @@
+/*
+ * static_payloads.cpp - Cached API payload check
+ *
+ * The effect list served from the boot-time buffer must be byte for byte
+ * what getEffectsJson builds, the palette list and schema must cover every
+ * palette and every reported param, and a second begin() must keep the
+ * buffers built at boot. ETags must follow the content and match If-None-Match
+ * values the way browsers send them.
+ */
+
+#include "StaticPayloads.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); failures++; } \
+} while (0)
+
+int main() {
+    const uint8_t heartbeat = 36;
+
+    HostClock::setMicros(0);
+    LEDController::begin();
+    CHECK(StaticPayloads::begin(), "payloads not built");
+
+    // Effect list: same bytes as the per-request build it replaces
+    const StaticPayload& effects = StaticPayloads::get(StaticPayloads::EFFECTS);
+    StaticJsonDocument<4096> doc;
+    LEDController::getEffectsJson(doc);
+    String built;
+    serializeJson(doc, built);
+    CHECK(effects.len == built.length() && strcmp(effects.data, built.c_str()) == 0, "effect list differs");
+
+    // Palettes and schema
+    deserializeJson(doc, StaticPayloads::get(StaticPayloads::PALETTES).data);
+    CHECK(doc.size() == PALETTE_CYBER + 1, "%u palettes", (unsigned)doc.size());
+    CHECK(strcmp(doc[PALETTE_CYBER]["name"].as<const char*>(), "Cyber") == 0, "palette names out of order");
+
+    StaticJsonDocument<8192> schema;
+    deserializeJson(schema, StaticPayloads::get(StaticPayloads::SCHEMA).data);
+    CHECK(schema.size() == NUM_PARAM_BLOCKS, "schema of %u effects", (unsigned)schema.size());
+    StaticJsonDocument<1024> params;
+    LEDController::getParamsJson(params, heartbeat);
+    JsonArray rows = schema[heartbeat]["params"].as<JsonArray>();
+    CHECK(rows.size() == params["params"].size(), "heartbeat schema has %u of %u params", (unsigned)rows.size(),
+          (unsigned)params["params"].size());
+    for (JsonVariant row : rows) {
+        const char* key = row["key"].as<const char*>();
+        const ParamDesc* p = findParam(key, heartbeat);
+        CHECK(p != NULL, "schema key %s unknown", key);
+        if (p != NULL && p->type == PARAM_UINT8) {
+            CHECK(strcmp(row["type"].as<const char*>(), "int") == 0 && row["min"].as<int>() == p->min &&
+                  row["max"].as<int>() == p->max, "range of %s", key);
+        }
+    }
+
+    // Built once: same buffer on a second call
+    const char* data = effects.data;
+    StaticPayloads::begin();
+    CHECK(StaticPayloads::get(StaticPayloads::EFFECTS).data == data, "payload rebuilt");
+
+    // ETags: per content, matched as browsers send them
+    const char* etag = effects.etag;
+    CHECK(strlen(etag) == 10 && etag[0] == '"' && etag[9] == '"', "malformed ETag %s", etag);
+    CHECK(strcmp(etag, StaticPayloads::get(StaticPayloads::SCHEMA).etag) != 0, "two payloads share an ETag");
+    char list[64];
+    snprintf(list, sizeof(list), "\"00000000\", W/%s", etag);
+    CHECK(StaticPayloads::matches(StaticPayloads::EFFECTS, etag), "own ETag not matched");
+    CHECK(StaticPayloads::matches(StaticPayloads::EFFECTS, list), "weak ETag in a list not matched");
+    CHECK(StaticPayloads::matches(StaticPayloads::EFFECTS, "*"), "* not matched");
+    CHECK(!StaticPayloads::matches(StaticPayloads::EFFECTS, "\"00000000\""), "other ETag matched");
+    CHECK(!StaticPayloads::matches(StaticPayloads::PALETTES, etag), "effects ETag matched the palettes");
+
+    printf("%d failure(s)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
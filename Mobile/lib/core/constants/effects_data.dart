@@ -827,13 +827,6 @@ final List<Effect> allEffects = [
         min: 0,
         max: 255,
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
       EffectParameter(
         id: 'darkMode',
         name: 'Dark Mode',
@@ -873,13 +866,6 @@ final List<Effect> allEffects = [
         type: ParameterType.bool_,
         defaultValue: true,
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
     ],
   ),
   Effect(
@@ -1288,13 +1274,6 @@ final List<Effect> allEffects = [
         type: ParameterType.color,
         defaultValue: '#FF0000',
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
     ],
   ),
   Effect(
@@ -1331,13 +1310,6 @@ final List<Effect> allEffects = [
         min: 0,
         max: 255,
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
     ],
   ),
   Effect(
@@ -1493,13 +1465,6 @@ final List<Effect> allEffects = [
         type: ParameterType.color,
         defaultValue: '#00FFFF',
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
     ],
   ),
   Effect(
@@ -1570,13 +1535,6 @@ final List<Effect> allEffects = [
         type: ParameterType.color,
         defaultValue: '#FFFFFF',
       ),
-      EffectParameter(
-        id: 'overlay',
-        name: 'Overlay',
-        nameLocal: 'Nakładka',
-        type: ParameterType.bool_,
-        defaultValue: false,
-      ),
     ],
   ),
   Effect(